@@ -140,7 +140,7 @@ class GameplayScene : public engine::Scene {
     score_binding.get_text = [this]() {
       return "Bricks Hit: " + std::to_string(bricks_hit_);
     };
-    registry().AddComponent(score_label_, score_binding);
+    registry().AddComponent(score_label_, std::move(score_binding));
     registry().AddComponent(
         score_label_,
         engine::ecs::components::Text{
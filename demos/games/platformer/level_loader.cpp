@@ -3,6 +3,8 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include <glm/geometric.hpp>
 
@@ -22,6 +24,38 @@
 
 namespace platformer {
 
+namespace {
+
+/**
+ * @brief Components of one type parsed from the level, keyed by the row of
+ * the entity they belong to.
+ */
+template <typename T>
+struct Column {
+  std::vector<size_t> rows;
+  std::vector<T> values;
+
+  void Add(size_t row, T value) {
+    rows.push_back(row);
+    values.push_back(std::move(value));
+  }
+
+  void InsertInto(engine::ecs::Registry& registry,
+                  const std::vector<engine::ecs::EntityID>& entities) {
+    std::vector<engine::ecs::EntityID> targets;
+    targets.reserve(rows.size());
+    for (size_t row : rows) {
+      if (row < entities.size()) {
+        targets.push_back(entities[row]);
+      }
+    }
+    values.resize(targets.size());
+    registry.InsertComponents<T>(targets, values);
+  }
+};
+
+}  // namespace
+
 void LevelLoader::Load(const std::string& path,
                        engine::ecs::Registry& registry) {
   std::ifstream file(path);
@@ -30,6 +64,17 @@ void LevelLoader::Load(const std::string& path,
     return;
   }
 
+  // Parse the whole level first, then create every entity and insert each
+  // component type in one batch.
+  size_t rows = 0;
+  Column<engine::ecs::components::Transform> transforms;
+  Column<engine::ecs::components::Collider> colliders;
+  Column<engine::ecs::components::Sprite> sprites;
+  Column<engine::ecs::components::Velocity> velocities;
+  Column<PlatformComponent> platforms;
+  Column<EnemyComponent> enemies;
+  Column<GoalComponent> goals;
+
   std::string line;
   while (std::getline(file, line)) {
     if (line.empty() || line[0] == '#') {
@@ -46,18 +91,18 @@ void LevelLoader::Load(const std::string& path,
         char p_type;
         ss >> x >> y >> w >> h >> p_type;
 
-        auto entity = registry.CreateEntity();
-        registry.AddComponent(
-            entity, engine::ecs::components::Transform{{x, y}, {w, h}});
-        registry.AddComponent(entity, engine::ecs::components::Collider{
-                                          {w, h}, {0, 0}, true, false});
+        const size_t row = rows++;
+        transforms.Add(row,
+                       engine::ecs::components::Transform{{x, y}, {w, h}});
+        colliders.Add(row, engine::ecs::components::Collider{
+                               {w, h}, {0, 0}, true, false});
 
         PlatformComponent pc;
         switch (p_type) {
           case 'S':
             pc.type = PlatformType::Stationary;
-            registry.AddComponent(entity, engine::ecs::components::Sprite{
-                                              "textures/platform.png"});
+            sprites.Add(row, engine::ecs::components::Sprite{
+                                 "textures/platform.png"});
             break;
           case 'M': {
             pc.type = PlatformType::Moving;
@@ -65,20 +110,19 @@ void LevelLoader::Load(const std::string& path,
             ss >> sx >> sy >> ex >> ey;
             pc.start_pos = {sx, sy};
             pc.end_pos = {ex, ey};
-            registry.AddComponent(
-                entity,
-                engine::ecs::components::Velocity{
-                    glm::normalize(pc.end_pos - pc.start_pos) * 150.0f});
-            registry.AddComponent(entity, engine::ecs::components::Sprite{
-                                              "textures/platform_moving.png"});
+            velocities.Add(
+                row, engine::ecs::components::Velocity{
+                         glm::normalize(pc.end_pos - pc.start_pos) * 150.0f});
+            sprites.Add(row, engine::ecs::components::Sprite{
+                                 "textures/platform_moving.png"});
           } break;
           case 'T':
             pc.type = PlatformType::Temporary;
-            registry.AddComponent(entity, engine::ecs::components::Sprite{
-                                              "textures/platform_temp.png"});
+            sprites.Add(row, engine::ecs::components::Sprite{
+                                 "textures/platform_temp.png"});
             break;
         }
-        registry.AddComponent(entity, pc);
+        platforms.Add(row, pc);
       } break;
 
       case 'E': {
@@ -87,11 +131,11 @@ void LevelLoader::Load(const std::string& path,
         ss >> x >> y;
         ss >> e_type;
 
-        auto entity = registry.CreateEntity();
-        registry.AddComponent(
-            entity, engine::ecs::components::Transform{{x, y}, {64.0f, 64.0f}});
-        registry.AddComponent(
-            entity, engine::ecs::components::Sprite{"textures/robot_idle.png"});
+        const size_t row = rows++;
+        transforms.Add(
+            row, engine::ecs::components::Transform{{x, y}, {64.0f, 64.0f}});
+        sprites.Add(row,
+                    engine::ecs::components::Sprite{"textures/robot_idle.png"});
 
         EnemyComponent ec;
         switch (e_type) {
@@ -104,28 +148,37 @@ void LevelLoader::Load(const std::string& path,
             ss >> sx >> sy >> ex >> ey;
             ec.start_pos = {sx, sy};
             ec.end_pos = {ex, ey};
-            registry.AddComponent(
-                entity,
-                engine::ecs::components::Velocity{
-                    glm::normalize(ec.end_pos - ec.start_pos) * 100.0f});
+            velocities.Add(
+                row, engine::ecs::components::Velocity{
+                         glm::normalize(ec.end_pos - ec.start_pos) * 100.0f});
           } break;
         }
-        registry.AddComponent(entity, ec);
+        enemies.Add(row, ec);
       } break;
 
       case 'G': {
         float x, y;
         ss >> x >> y;
 
-        auto entity = registry.CreateEntity();
-        registry.AddComponent(
-            entity, engine::ecs::components::Transform{{x, y}, {64.0f, 64.0f}});
-        registry.AddComponent(
-            entity, engine::ecs::components::Sprite{"textures/door.png"});
-        registry.AddComponent(entity, GoalComponent{});
+        const size_t row = rows++;
+        transforms.Add(
+            row, engine::ecs::components::Transform{{x, y}, {64.0f, 64.0f}});
+        sprites.Add(row,
+                    engine::ecs::components::Sprite{"textures/door.png"});
+        goals.Add(row, GoalComponent{});
       } break;
     }
   }
+
+  const std::vector<engine::ecs::EntityID> entities =
+      registry.CreateEntities(rows);
+  transforms.InsertInto(registry, entities);
+  colliders.InsertInto(registry, entities);
+  sprites.InsertInto(registry, entities);
+  velocities.InsertInto(registry, entities);
+  platforms.InsertInto(registry, entities);
+  enemies.InsertInto(registry, entities);
+  goals.InsertInto(registry, entities);
 }
 
 }  // namespace platformer
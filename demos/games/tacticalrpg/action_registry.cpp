@@ -162,7 +162,7 @@ engine::ecs::EntityID ActionRegistry::GetOrCreateAction(
     }
     effects_list.effects.push_back(effect_entity);
   }
-  registry.AddComponent(action_entity, effects_list);
+  registry.AddComponent(action_entity, std::move(effects_list));
 
   action_cache_[name] = action_entity;
   return action_entity;
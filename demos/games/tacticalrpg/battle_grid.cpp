@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <random>
+#include <vector>
 
 #include "components.h"
 
@@ -12,12 +13,19 @@ void BattleGrid::Setup(engine::ecs::Registry& registry,
   std::mt19937 gen(std::random_device{}());
   std::uniform_real_distribution<float> dist(0.0f, 1.0f);
 
-  auto grid_entity = registry.CreateEntity();
-  GridMapComponent grid_map;
+  constexpr size_t kTileCount = static_cast<size_t>(kSize) * kSize;
+  const std::vector<engine::ecs::EntityID> tile_entities =
+      registry.CreateEntities(kTileCount);
+  if (tile_entities.size() != kTileCount) {
+    return;
+  }
+  GridMapComponent& grid_map = registry.SetResource<GridMapComponent>();
+  std::vector<TileComponent> tiles;
+  tiles.reserve(tile_entities.size());
 
   for (int y = 0; y < kSize; ++y) {
     for (int x = 0; x < kSize; ++x) {
-      auto tile_entity = registry.CreateEntity();
+      auto tile_entity = tile_entities[y * kSize + x];
       TerrainType terrain = TerrainType::Normal;
 
       float r = dist(gen);
@@ -32,25 +40,22 @@ void BattleGrid::Setup(engine::ecs::Registry& registry,
       // Safety areas
       if (y <= 1 || y >= kSize - 2) terrain = TerrainType::Normal;
 
-      registry.AddComponent(tile_entity, TileComponent{terrain, {x, y}});
+      tiles.push_back(TileComponent{terrain, {x, y}});
       grid_map.tiles[y][x] = tile_entity;
     }
   }
-
-  registry.AddComponent(grid_entity, grid_map);
+  registry.InsertComponents<TileComponent>(tile_entities, tiles);
 }
 
 TerrainType BattleGrid::GetTerrain(engine::ecs::Registry& registry, int x,
                                    int y) {
   if (!IsInBounds(x, y)) return TerrainType::Impassible;
 
-  auto view = registry.GetView<GridMapComponent>();
-  for (auto entity : view) {
-    auto& grid_map = registry.GetComponent<GridMapComponent>(entity);
-    auto tile_entity = grid_map.tiles[y][x];
-    if (registry.HasComponent<TileComponent>(tile_entity)) {
-      return registry.GetComponent<TileComponent>(tile_entity).terrain;
-    }
+  const GridMapComponent* grid_map = registry.GetResource<GridMapComponent>();
+  if (!grid_map) return TerrainType::Impassible;
+  auto tile_entity = grid_map->tiles[y][x];
+  if (registry.HasComponent<TileComponent>(tile_entity)) {
+    return registry.GetComponent<TileComponent>(tile_entity).terrain;
   }
   return TerrainType::Impassible;
 }
@@ -50,7 +50,7 @@ engine::ecs::EntityID ClassRegistry::CreateCharacter(
       action_list.actions.push_back(action_entity);
     }
   }
-  registry.AddComponent(entity, action_list);
+  registry.AddComponent(entity, std::move(action_list));
 
   // Engine components
   registry.AddComponent(entity, ::engine::ecs::components::Transform());
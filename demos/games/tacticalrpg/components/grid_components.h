@@ -14,6 +14,7 @@ struct TileComponent {
   glm::ivec2 grid_pos;
 };
 
+// Held as a registry resource rather than on an entity.
 struct GridMapComponent {
   static constexpr int kSize = 10;
   engine::ecs::EntityID tiles[kSize][kSize];
@@ -51,7 +51,7 @@ class MenuScene : public engine::Scene {
     gold_binding.get_text = [this]() {
       return "Gold: " + std::to_string(player_gold_);
     };
-    registry().AddComponent(gold_counter_, gold_binding);
+    registry().AddComponent(gold_counter_, std::move(gold_binding));
     registry().AddComponent(
         gold_counter_,
         engine::ecs::components::Text{
@@ -81,7 +81,7 @@ class MenuScene : public engine::Scene {
           })
           .Play();
     };
-    registry().AddComponent(pause_button_, btn_inter);
+    registry().AddComponent(pause_button_, std::move(btn_inter));
 
     // Button Text
     engine::ecs::EntityID btn_text = registry().CreateEntity();
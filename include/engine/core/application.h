@@ -10,6 +10,7 @@
 
 #include <engine/core/engine.h>
 #include <engine/core/window.h>
+#include <engine/ecs/system_scheduler.h>
 #include <engine/graphics/camera.h>
 #include <engine/input/input_manager.h>
 
@@ -67,6 +68,16 @@ class Application {
   /** @brief Gets the primary camera. */
   engine::graphics::Camera& camera() { return *main_camera_; }
 
+  /**
+   * @brief Gets the scheduler that updates the active scene's registry each
+   * frame.
+   *
+   * The engine systems are registered before `OnInit`; games add their own
+   * systems here, declaring the components they read and write, instead of
+   * calling them from `OnUpdate`.
+   */
+  ecs::SystemScheduler& systems() { return systems_; }
+
  protected:
   /**
    * @brief Provides access to the main application window.
@@ -88,8 +99,14 @@ class Application {
   engine::graphics::Camera& main_camera() { return *main_camera_; }
 
  private:
+  /** @brief Registers the built-in ECS systems with the scheduler. */
+  void RegisterEngineSystems();
+
   /** @brief The Application owns the primary camera. */
   std::unique_ptr<engine::graphics::Camera> main_camera_;
+
+  /** @brief Per-frame ECS systems, run while the console is not paused. */
+  ecs::SystemScheduler systems_;
 };
 
 }  // namespace engine
@@ -6,7 +6,9 @@
 #ifndef INCLUDE_ENGINE_CORE_JOB_SYSTEM_H_
 #define INCLUDE_ENGINE_CORE_JOB_SYSTEM_H_
 
+#include <algorithm>
 #include <condition_variable>
+#include <cstddef>
 #include <functional>
 #include <future>
 #include <mutex>
@@ -78,11 +80,53 @@ class JobSystem {
     return res;
   }
 
+  /**
+   * @brief Splits `[0, count)` into batches and runs them across the workers.
+   *
+   * `func(begin, end)` is invoked once per batch of at most `grain` indices.
+   * The calling thread processes the first batch itself and then blocks until
+   * every other batch has finished, so only the work submitted here is waited
+   * on. Everything runs inline on the calling thread when there is a single
+   * batch, when no workers are running, or when called from a worker (which
+   * would otherwise risk every worker blocking on queued batches).
+   *
+   * @tparam Func Callable of the form `void(size_t begin, size_t end)`.
+   * @param count Number of indices to process.
+   * @param grain Maximum number of indices per batch.
+   * @param func The batch callback. Must be safe to call concurrently.
+   */
+  template <typename Func>
+  void ParallelFor(size_t count, size_t grain, Func&& func) {
+    if (count == 0) {
+      return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    if (count <= grain || workers_.empty() || !IsMainThread()) {
+      func(size_t{0}, count);
+      return;
+    }
+    std::vector<std::future<void>> batches;
+    batches.reserve((count - 1) / grain);
+    for (size_t begin = grain; begin < count; begin += grain) {
+      const size_t end = std::min(begin + grain, count);
+      batches.push_back(Execute([&func, begin, end]() { func(begin, end); }));
+    }
+    func(size_t{0}, grain);
+    for (std::future<void>& batch : batches) {
+      if (batch.valid()) {
+        batch.get();
+      }
+    }
+  }
+
   /**
    * @brief Blocks until all submitted tasks have completed.
    */
   void Wait();
 
+  /** @brief Returns the number of worker threads currently running. */
+  [[nodiscard]] size_t worker_count() const { return workers_.size(); }
+
   /**
    * @brief Checks if the current thread is the thread that initialized the
    * JobSystem.
@@ -90,6 +134,15 @@ class JobSystem {
    */
   [[nodiscard]] bool IsMainThread() const;
 
+  /**
+   * @brief Returns a small index identifying the calling thread.
+   *
+   * Worker threads are numbered from 1 in the order they were spawned; every
+   * other thread, including the main thread, reports 0. Useful for indexing
+   * per-thread scratch data without locking.
+   */
+  [[nodiscard]] static size_t GetThreadIndex();
+
  private:
   JobSystem() = default;
   ~JobSystem();
@@ -100,8 +153,9 @@ class JobSystem {
 
   /**
    * @brief The main loop for worker threads.
+   * @param thread_index The value GetThreadIndex() reports on this worker.
    */
-  void WorkerLoop();
+  void WorkerLoop(size_t thread_index);
 
   std::vector<std::thread> workers_;
   std::queue<std::function<void()>> tasks_;
@@ -0,0 +1,370 @@
+/**
+ * @file archetype_storage.h
+ * @brief Chunked archetype storage backend for the Registry.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_ARCHETYPE_STORAGE_H_
+#define INCLUDE_ENGINE_ECS_ARCHETYPE_STORAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/entity_manager.h>
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+class Registry;
+
+namespace detail {
+/**
+ * @brief Publishes a ComponentRemovedEvent for a type-erased component.
+ *
+ * Defined in registry.h, where the Registry is complete.
+ */
+template <typename T>
+void PublishArchetypeComponentRemoved(EntityID entity, void* component,
+                                      Registry* registry);
+}  // namespace detail
+
+/**
+ * @brief Type-erased description of a component type stored in chunks.
+ */
+struct ComponentTypeInfo {
+  size_t size = 0;
+  size_t alignment = 0;
+  void (*move_construct)(void* dst, void* src) = nullptr;
+  void (*destroy)(void* ptr) = nullptr;
+  void (*notify_removed)(EntityID entity, void* component,
+                         Registry* registry) = nullptr;
+
+  /** @brief Builds the description for the given component type. */
+  template <typename T>
+  static ComponentTypeInfo Of() {
+    ComponentTypeInfo info;
+    info.size = sizeof(T);
+    info.alignment = alignof(T);
+    info.move_construct = [](void* dst, void* src) {
+      new (dst) T(std::move(*static_cast<T*>(src)));
+    };
+    info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+    info.notify_removed = &detail::PublishArchetypeComponentRemoved<T>;
+    return info;
+  }
+};
+
+/**
+ * @brief All entities that share one exact set of component types.
+ *
+ * Rows are packed into fixed-size chunks. Each chunk holds the entity column
+ * followed by one contiguous column per component type (structure of arrays),
+ * so iterating a column is a linear walk that hardware prefetchers and
+ * auto-vectorization handle well. Every chunk except the last is always full.
+ */
+class Archetype {
+ public:
+  /** @brief Target size of a single chunk in bytes. */
+  static constexpr size_t kChunkSize = 16 * 1024;
+
+  /**
+   * @brief Creates an archetype.
+   * @param signature Sorted component type IDs.
+   * @param types Type descriptions, parallel to `signature`.
+   */
+  Archetype(std::vector<uint32_t> signature,
+            std::vector<const ComponentTypeInfo*> types);
+  ~Archetype();
+
+  Archetype(const Archetype&) = delete;
+  Archetype& operator=(const Archetype&) = delete;
+
+  /** @brief Returns the sorted component type IDs of this archetype. */
+  const std::vector<uint32_t>& signature() const { return signature_; }
+
+  /** @brief Returns the total number of rows (entities). */
+  size_t size() const { return size_; }
+
+  /** @brief Returns the number of rows a single chunk can hold. */
+  size_t chunk_capacity() const { return chunk_capacity_; }
+
+  /** @brief Returns the number of allocated chunks. */
+  size_t chunk_count() const { return chunks_.size(); }
+
+  /** @brief Returns the size of one chunk in bytes. */
+  size_t chunk_bytes() const { return chunk_bytes_; }
+
+  /** @brief Returns the number of rows stored in the given chunk. */
+  size_t ChunkRowCount(size_t chunk) const {
+    size_t first = chunk * chunk_capacity_;
+    return size_ - first < chunk_capacity_ ? size_ - first : chunk_capacity_;
+  }
+
+  /**
+   * @brief Returns the column holding the type, or -1 if the archetype does
+   * not contain it.
+   */
+  int ColumnOf(uint32_t type_id) const {
+    return type_id < column_of_.size() ? column_of_[type_id] : -1;
+  }
+
+  /** @brief Returns the start of the entity column of a chunk. */
+  EntityID* ChunkEntities(size_t chunk) const {
+    return reinterpret_cast<EntityID*>(chunks_[chunk].get());
+  }
+
+  /** @brief Returns the start of a component column of a chunk. */
+  void* ChunkColumn(size_t chunk, int column) const {
+    return chunks_[chunk].get() + column_offsets_[column];
+  }
+
+  /** @brief Returns the entity stored at a row. */
+  EntityID EntityAt(uint32_t row) const {
+    return ChunkEntities(row / chunk_capacity_)[row % chunk_capacity_];
+  }
+
+  /** @brief Returns the address of a component at a row. */
+  void* ComponentAt(uint32_t row, int column) const {
+    return chunks_[row / chunk_capacity_].get() + column_offsets_[column] +
+           (row % chunk_capacity_) * types_[column]->size;
+  }
+
+  /**
+   * @brief Appends a row for the entity, allocating a chunk if needed.
+   *
+   * The component slots of the new row are left uninitialized; the caller must
+   * construct every column.
+   *
+   * @return The index of the new row.
+   */
+  uint32_t AllocateRow(EntityID entity);
+
+  /**
+   * @brief Destroys every component of a row and fills the hole with the last
+   * row.
+   * @return The entity that was moved into `row`, or kInvalidEntity if the
+   * removed row was the last one.
+   */
+  EntityID RemoveRow(uint32_t row);
+
+  /** @brief Cached archetype reached by adding a type. */
+  std::unordered_map<uint32_t, Archetype*>& add_edges() { return add_edges_; }
+
+  /** @brief Cached archetype reached by removing a type. */
+  std::unordered_map<uint32_t, Archetype*>& remove_edges() {
+    return remove_edges_;
+  }
+
+  /** @brief Returns the type description of a column. */
+  const ComponentTypeInfo& type(int column) const { return *types_[column]; }
+
+ private:
+  struct ChunkDeleter {
+    size_t alignment;
+    void operator()(std::byte* ptr) const {
+      ::operator delete[](ptr, std::align_val_t(alignment));
+    }
+  };
+  using Chunk = std::unique_ptr<std::byte[], ChunkDeleter>;
+
+  std::vector<uint32_t> signature_;
+  std::vector<const ComponentTypeInfo*> types_;
+  std::vector<int> column_of_;
+  std::vector<size_t> column_offsets_;
+  size_t chunk_capacity_ = 1;
+  size_t chunk_bytes_ = kChunkSize;
+  size_t chunk_alignment_ = alignof(std::max_align_t);
+  size_t size_ = 0;
+  std::vector<Chunk> chunks_;
+  std::unordered_map<uint32_t, Archetype*> add_edges_;
+  std::unordered_map<uint32_t, Archetype*> remove_edges_;
+};
+
+/**
+ * @brief Stores components grouped by archetype instead of per type.
+ *
+ * Adding or removing a component moves the entity's row to the archetype for
+ * its new signature. Archetype transitions are cached as graph edges, so after
+ * warm-up a structural change costs one row move.
+ *
+ * @note Component references are invalidated whenever their entity changes
+ * archetype or another row is moved into their slot.
+ */
+class ArchetypeStorage {
+ public:
+  ArchetypeStorage();
+  ~ArchetypeStorage();
+
+  ArchetypeStorage(const ArchetypeStorage&) = delete;
+  ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+  /**
+   * @brief Returns the family ID of a component type, registering its layout
+   * with this storage on first use.
+   */
+  template <typename T>
+  uint32_t TypeId() {
+    const uint32_t id = ComponentTypeId<T>();
+    if (id >= types_.size()) {
+      types_.resize(id + 1);
+    }
+    if (!types_[id]) {
+      types_[id] =
+          std::make_unique<ComponentTypeInfo>(ComponentTypeInfo::Of<T>());
+    }
+    return id;
+  }
+
+  /**
+   * @brief Stores the component for the entity, replacing any existing one.
+   * @return A reference to the stored component.
+   */
+  template <typename T>
+  T& Add(EntityID entity, T component) {
+    return Emplace<T>(entity, std::move(component));
+  }
+
+  /**
+   * @brief Constructs the entity's component in place from `args`, moving
+   * the entity to the archetype with T first if it lacks one. An existing
+   * component is assigned from `args` instead.
+   * @return A reference to the stored component.
+   */
+  template <typename T, typename... Args>
+  T& Emplace(EntityID entity, Args&&... args) {
+    const uint32_t type_id = TypeId<T>();
+    Location& location = AssureLocation(entity);
+    if (location.archetype) {
+      int column = location.archetype->ColumnOf(type_id);
+      if (column >= 0) {
+        T& existing = *static_cast<T*>(
+            location.archetype->ComponentAt(location.row, column));
+        AssignComponent(existing, std::forward<Args>(args)...);
+        return existing;
+      }
+    }
+    Archetype* target = AddTransition(location.archetype, type_id);
+    MoveEntity(entity, target);
+    void* slot = target->ComponentAt(location.row, target->ColumnOf(type_id));
+    return *new (slot) T(std::forward<Args>(args)...);
+  }
+
+  /** @brief Returns the component of the entity, or nullptr if absent. */
+  template <typename T>
+  T* Get(EntityID entity) {
+    Location* location = Find(entity);
+    if (!location) {
+      return nullptr;
+    }
+    int column = location->archetype->ColumnOf(TypeId<T>());
+    if (column < 0) {
+      return nullptr;
+    }
+    return static_cast<T*>(
+        location->archetype->ComponentAt(location->row, column));
+  }
+
+  /** @brief Returns true if the entity has a component of type T. */
+  template <typename T>
+  bool Has(EntityID entity) {
+    Location* location = Find(entity);
+    return location && location->archetype->ColumnOf(TypeId<T>()) >= 0;
+  }
+
+  /** @brief Removes the component of type T from the entity, if present. */
+  template <typename T>
+  void Remove(EntityID entity) {
+    RemoveType(entity, TypeId<T>());
+  }
+
+  /**
+   * @brief Calls `func(info, component)` for every component of the entity.
+   */
+  template <typename Func>
+  void VisitComponents(EntityID entity, Func&& func) {
+    Location* location = Find(entity);
+    if (!location) {
+      return;
+    }
+    Archetype* archetype = location->archetype;
+    for (int column = 0;
+         column < static_cast<int>(archetype->signature().size()); ++column) {
+      func(archetype->type(column),
+           archetype->ComponentAt(location->row, column));
+    }
+  }
+
+  /** @brief Destroys every component of the entity. */
+  void RemoveEntity(EntityID entity);
+
+  /**
+   * @brief Collects the archetypes that contain every listed type.
+   * @param type_ids Component family IDs to match.
+   * @param out Receives the matching archetypes.
+   */
+  void CollectMatching(const std::vector<uint32_t>& type_ids,
+                       std::vector<Archetype*>* out) const;
+
+  /** @brief Destroys all components and archetypes. */
+  void Clear();
+
+  /** @brief Returns the number of archetypes created so far. */
+  size_t archetype_count() const { return archetypes_.size(); }
+
+  /** @brief Returns the number of chunks allocated across all archetypes. */
+  size_t chunk_count() const;
+
+  /** @brief Returns the bytes allocated for those chunks. */
+  size_t chunk_bytes() const;
+
+ private:
+  struct Location {
+    Archetype* archetype = nullptr;
+    uint32_t row = 0;
+  };
+
+  /** @brief Returns the location of a live row for the entity, or nullptr. */
+  Location* Find(EntityID entity) {
+    const uint32_t index = GetEntityIndex(entity);
+    if (index >= locations_.size()) {
+      return nullptr;
+    }
+    Location& location = locations_[index];
+    if (!location.archetype ||
+        location.archetype->EntityAt(location.row) != entity) {
+      return nullptr;
+    }
+    return &location;
+  }
+
+  Location& AssureLocation(EntityID entity);
+  Archetype* AddTransition(Archetype* from, uint32_t type_id);
+  Archetype* RemoveTransition(Archetype* from, uint32_t type_id);
+  Archetype* FindOrCreate(std::vector<uint32_t> signature);
+  void RemoveType(EntityID entity, uint32_t type_id);
+
+  /**
+   * @brief Moves the entity's row into `target`, leaving the slots of types
+   * not present in its current archetype uninitialized.
+   */
+  void MoveEntity(EntityID entity, Archetype* target);
+
+  /** @brief Removes a row and patches the location of the row moved into it. */
+  void EraseRow(Archetype* archetype, uint32_t row);
+
+  /** @brief Layouts indexed by component family ID; may have holes. */
+  std::vector<std::unique_ptr<ComponentTypeInfo>> types_;
+  std::map<std::vector<uint32_t>, std::unique_ptr<Archetype>> archetypes_;
+  Archetype* root_ = nullptr;
+  std::vector<Location> locations_;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_ARCHETYPE_STORAGE_H_
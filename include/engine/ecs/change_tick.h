@@ -0,0 +1,69 @@
+/**
+ * @file change_tick.h
+ * @brief Change ticks and the view filters built on them.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_CHANGE_TICK_H_
+#define INCLUDE_ENGINE_ECS_CHANGE_TICK_H_
+
+#include <cstdint>
+
+namespace engine::ecs {
+
+namespace detail {
+/**
+ * @brief Tick at which the system running on this thread last ran.
+ *
+ * Set by the SystemScheduler around each system. Zero outside of scheduled
+ * systems, so unqualified filters then match every component.
+ */
+inline thread_local uint32_t last_run_tick = 0;
+}  // namespace detail
+
+/**
+ * @brief Sets the last-run tick of the current thread for its lifetime.
+ */
+class ScopedLastRunTick {
+ public:
+  explicit ScopedLastRunTick(uint32_t tick)
+      : previous_(detail::last_run_tick) {
+    detail::last_run_tick = tick;
+  }
+  ~ScopedLastRunTick() { detail::last_run_tick = previous_; }
+
+  ScopedLastRunTick(const ScopedLastRunTick&) = delete;
+  ScopedLastRunTick& operator=(const ScopedLastRunTick&) = delete;
+
+ private:
+  uint32_t previous_;
+};
+
+/**
+ * @brief View filter matching entities whose T was added or changed after
+ * tick `since`.
+ *
+ * Defaults to the tick the current scheduled system last ran at.
+ *
+ * Example:
+ * @code
+ * registry.GetView<Transform, Light>(Changed<Transform>{last_sync});
+ * @endcode
+ */
+template <typename T>
+struct Changed {
+  uint32_t since = detail::last_run_tick;
+};
+
+/**
+ * @brief View filter matching entities whose T was added after tick `since`.
+ *
+ * Defaults to the tick the current scheduled system last ran at.
+ */
+template <typename T>
+struct Added {
+  uint32_t since = detail::last_run_tick;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_CHANGE_TICK_H_
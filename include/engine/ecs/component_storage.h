@@ -0,0 +1,582 @@
+/**
+ * @file component_storage.h
+ * @brief Sparse-set storage for ECS components.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_COMPONENT_STORAGE_H_
+#define INCLUDE_ENGINE_ECS_COMPONENT_STORAGE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <engine/ecs/entity_manager.h>
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+class IGroupHandler;
+class Registry;
+
+/**
+ * @brief Memory and occupancy figures of one component storage.
+ *
+ * Byte counts cover the storage's own arrays, not memory the components
+ * themselves own (e.g. string contents).
+ */
+struct StorageStats {
+  /** @brief Name of the component type. */
+  std::string_view name;
+  /** @brief Number of components stored. */
+  size_t size = 0;
+  /** @brief Number of components the dense arrays hold without growing. */
+  size_t capacity = 0;
+  /** @brief Bytes allocated by the dense and sparse arrays. */
+  size_t bytes = 0;
+  /**
+   * @brief Fraction of the allocated sparse entries that refer to a
+   * component; low values mean entity indices are spread thin.
+   */
+  float sparse_load = 0.0f;
+};
+
+/**
+ * @brief Base interface for generic storage.
+ */
+class IComponentStorage {
+ public:
+  /**
+   * @brief Callback run when an entity enters or leaves a storage, or when
+   * its component changes.
+   */
+  struct Hook {
+    void (*callback)(void* context, EntityID entity);
+    void* context;
+  };
+
+  virtual ~IComponentStorage() = default;
+  virtual void Remove(EntityID entity) = 0;
+  virtual void Clear() = 0;
+  virtual bool Has(EntityID entity) = 0;
+  virtual void NotifyRemoved(EntityID entity, Registry* registry) = 0;
+
+  /** @brief Returns the number of components currently stored. */
+  virtual size_t size() const = 0;
+
+  /** @brief Returns the memory and occupancy figures of the storage. */
+  virtual StorageStats stats() const = 0;
+
+  /**
+   * @brief Registers a hook run right after an entity gains a component.
+   *
+   * Replacing an existing component runs the update hooks instead. Clear()
+   * runs no hooks.
+   */
+  void AddConstructHook(Hook hook) { construct_hooks_.push_back(hook); }
+
+  /** @brief Registers a hook run right before an entity loses a component. */
+  void AddDestroyHook(Hook hook) { destroy_hooks_.push_back(hook); }
+
+  /**
+   * @brief Registers a hook run when an entity's component is stamped as
+   * changed or replaced. Tags never run it.
+   */
+  void AddUpdateHook(Hook hook) { update_hooks_.push_back(hook); }
+
+  /**
+   * @brief Makes the storage keep bit `type` of the component masks in
+   * `entities` up to date; see EntityManager. The bit is set before the
+   * construct hooks run and cleared after the destroy hooks ran.
+   */
+  void TrackMask(EntityManager* entities, uint32_t type) {
+    entities->AddComponentType(type);
+    mask_owner_ = entities;
+    mask_type_ = type;
+  }
+
+  /**
+   * @brief Returns the group that dictates the dense order of this storage,
+   * or nullptr if it is not owned by a group.
+   */
+  IGroupHandler* owner() const { return owner_; }
+  void set_owner(IGroupHandler* owner) { owner_ = owner; }
+
+ protected:
+  IComponentStorage() = default;
+
+  void RunConstructHooks(EntityID entity) {
+    if (mask_owner_) {
+      mask_owner_->SetComponentBit(GetEntityIndex(entity), mask_type_);
+    }
+    for (const Hook& hook : construct_hooks_) {
+      hook.callback(hook.context, entity);
+    }
+  }
+
+  void RunDestroyHooks(EntityID entity) {
+    for (const Hook& hook : destroy_hooks_) {
+      hook.callback(hook.context, entity);
+    }
+    if (mask_owner_) {
+      mask_owner_->ResetComponentBit(GetEntityIndex(entity), mask_type_);
+    }
+  }
+
+  void RunUpdateHooks(EntityID entity) {
+    for (const Hook& hook : update_hooks_) {
+      hook.callback(hook.context, entity);
+    }
+  }
+
+ private:
+  std::vector<Hook> construct_hooks_;
+  std::vector<Hook> destroy_hooks_;
+  std::vector<Hook> update_hooks_;
+  IGroupHandler* owner_ = nullptr;
+  EntityManager* mask_owner_ = nullptr;
+  uint32_t mask_type_ = 0;
+};
+
+/**
+ * @brief Replaces a stored component with one built from `args`.
+ *
+ * A single argument of type T is assigned directly rather than through a
+ * temporary, so replacing with an rvalue costs one move assignment.
+ */
+template <typename T, typename... Args>
+void AssignComponent(T& target, Args&&... args) {
+  if constexpr (sizeof...(Args) == 1 &&
+                (std::is_same_v<std::remove_cvref_t<Args>, T> && ...)) {
+    target = (std::forward<Args>(args), ...);
+  } else {
+    target = T(std::forward<Args>(args)...);
+  }
+}
+
+/**
+ * @brief Rearranges positions in place so that position `i` receives the
+ * element that was at `order[i]`.
+ *
+ * Each cycle of the permutation is followed with `swap(a, b)` calls, so at
+ * most `order.size()` swaps are made and an identity order makes none.
+ * `order` is left as the identity.
+ */
+template <typename Swap>
+void ApplyPermutation(std::span<uint32_t> order, Swap&& swap) {
+  for (uint32_t start = 0; start < order.size(); ++start) {
+    uint32_t current = start;
+    while (order[current] != start) {
+      const uint32_t next = order[current];
+      swap(current, next);
+      order[current] = current;
+      current = next;
+    }
+    order[current] = current;
+  }
+}
+
+/**
+ * @brief Sparse-set implementation of the storage interface for a given type.
+ *
+ * Components are kept in a densely packed array alongside a parallel array of
+ * their owning entities. A paged sparse array maps an entity to its slot in the
+ * dense arrays, so lookups are a pair of array loads and iteration is a linear
+ * walk over contiguous memory. The sparse array is keyed by entity index, and
+ * the dense entity array stores the full versioned handle, so stale handles
+ * are never reported as present. Removal swaps the last element into the freed
+ * slot, so the dense order is not stable across removals.
+ *
+ * Each component also carries the registry ticks it was added and last
+ * changed at, which back the Added and Changed view filters.
+ *
+ * Every array, sparse pages included, is allocated from the memory resource
+ * given at construction, so a registry can keep all of its storages in one
+ * arena.
+ */
+template <typename T>
+class ComponentStorage final : public IComponentStorage {
+ public:
+  explicit ComponentStorage(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : pages_(resource),
+        entities_(resource),
+        components_(resource),
+        added_ticks_(resource),
+        changed_ticks_(resource) {}
+
+  ~ComponentStorage() override { FreePages(); }
+
+  ComponentStorage(const ComponentStorage&) = delete;
+  ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+  /**
+   * @brief Stores the component for the given entity.
+   *
+   * If the entity already has a component in this storage, it is replaced
+   * and only its changed tick is updated.
+   *
+   * @param entity The entity to store the component on.
+   * @param component The component being added.
+   * @param tick The registry tick to stamp the component with.
+   */
+  void Add(EntityID entity, T component, uint32_t tick = 0) {
+    Emplace(entity, tick, std::move(component));
+  }
+
+  /**
+   * @brief Constructs the entity's component in place from `args`.
+   *
+   * A new component is constructed directly in the dense array; an existing
+   * one is assigned from `args` and only its changed tick is updated.
+   *
+   * @param entity The entity to store the component on.
+   * @param tick The registry tick to stamp the component with.
+   * @param args Constructor arguments, or the members of an aggregate.
+   * @return The stored component.
+   */
+  template <typename... Args>
+  T& Emplace(EntityID entity, uint32_t tick, Args&&... args) {
+    uint32_t* slot = AssureSlot(entity);
+    if (*slot != kNullSlot) {
+      entities_[*slot] = entity;
+      AssignComponent(components_[*slot], std::forward<Args>(args)...);
+      changed_ticks_[*slot] = tick;
+      RunUpdateHooks(entity);
+      return components_[*slot];
+    }
+    *slot = static_cast<uint32_t>(entities_.size());
+    entities_.push_back(entity);
+    components_.emplace_back(std::forward<Args>(args)...);
+    added_ticks_.push_back(tick);
+    changed_ticks_.push_back(tick);
+    RunConstructHooks(entity);
+    return components_[*slot];
+  }
+
+  /**
+   * @brief Appends a batch of components for entities not yet in the storage.
+   *
+   * The dense arrays grow with one range insert, so trivially copyable
+   * components are copied with a single memcpy. Pass move iterators to move
+   * the components in instead of copying them.
+   *
+   * @note None of the entities may already be in this storage.
+   * @param entities The `count` entities to store components on.
+   * @param components Iterator to the first of `count` components.
+   * @param count Number of entries.
+   * @param tick The registry tick to stamp the components with.
+   */
+  template <typename It>
+  void Append(const EntityID* entities, It components, size_t count,
+              uint32_t tick = 0) {
+    const size_t first = entities_.size();
+    entities_.insert(entities_.end(), entities, entities + count);
+    components_.insert(components_.end(), components, components + count);
+    added_ticks_.resize(first + count, tick);
+    changed_ticks_.resize(first + count, tick);
+    for (size_t i = 0; i < count; ++i) {
+      *AssureSlot(entities[i]) = static_cast<uint32_t>(first + i);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      RunConstructHooks(entities[i]);
+    }
+  }
+
+  /**
+   * @brief Returns the component for the given entity.
+   * @note Behavior is undefined if the entity is not in this storage.
+   * @returns the component.
+   */
+  T& Get(EntityID entity) { return components_[*FindSlot(entity)]; }
+
+  /**
+   * @brief Removes the entity from this given storage.
+   *
+   * The last component in the dense array is moved into the vacated slot.
+   *
+   * @param entity The entity to remove.
+   */
+  void Remove(EntityID entity) override {
+    if (!Has(entity)) {
+      return;
+    }
+    RunDestroyHooks(entity);
+    uint32_t* slot = FindSlot(entity);
+    const uint32_t index = *slot;
+    const uint32_t last = static_cast<uint32_t>(entities_.size() - 1);
+    if (index != last) {
+      const EntityID moved = entities_[last];
+      entities_[index] = moved;
+      components_[index] = std::move(components_[last]);
+      added_ticks_[index] = added_ticks_[last];
+      changed_ticks_[index] = changed_ticks_[last];
+      *FindSlot(moved) = index;
+    }
+    entities_.pop_back();
+    components_.pop_back();
+    added_ticks_.pop_back();
+    changed_ticks_.pop_back();
+    *slot = kNullSlot;
+  }
+
+  /**
+   * @brief Returns the position of the entity in the dense arrays.
+   * @note Behavior is undefined if the entity is not in this storage.
+   */
+  size_t IndexOf(EntityID entity) const { return *FindSlot(entity); }
+
+  /**
+   * @brief Exchanges the dense positions of two stored entities.
+   *
+   * Used by groups to keep their members packed at the front of the arrays.
+   */
+  void SwapEntries(size_t a, size_t b) {
+    if (a == b) {
+      return;
+    }
+    std::swap(entities_[a], entities_[b]);
+    std::swap(components_[a], components_[b]);
+    std::swap(added_ticks_[a], added_ticks_[b]);
+    std::swap(changed_ticks_[a], changed_ticks_[b]);
+    *FindSlot(entities_[a]) = static_cast<uint32_t>(a);
+    *FindSlot(entities_[b]) = static_cast<uint32_t>(b);
+  }
+
+  /**
+   * @brief Computes the stable order of dense positions `[first, last)` by
+   * `compare` on their components.
+   *
+   * On return `(*order)[i]` is the offset from `first` of the entry that
+   * belongs at `first + i`; pass it to Permute() to apply it. A full sort
+   * costs O(n log n) whatever the input. An incremental sort insertion-sorts
+   * the positions, which is linear when the range is already nearly in order,
+   * e.g. when it was sorted last frame and few keys changed since; if that
+   * needs too many moves it finishes with a full sort.
+   *
+   * @param compare Strict weak ordering of `(const T&, const T&)`.
+   */
+  template <typename Compare>
+  void ComputeOrder(size_t first, size_t last, Compare& compare,
+                    bool incremental, std::vector<uint32_t>* order) const {
+    const size_t count = last - first;
+    order->resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      (*order)[i] = static_cast<uint32_t>(i);
+    }
+    const T* values = components_.data() + first;
+    auto less = [values, &compare](uint32_t a, uint32_t b) {
+      return compare(values[a], values[b]);
+    };
+    if (incremental) {
+      size_t budget = count * kMaxInsertionMoves;
+      size_t i = 1;
+      for (; i < count; ++i) {
+        const uint32_t entry = (*order)[i];
+        size_t j = i;
+        for (; j > 0 && budget > 0 && less(entry, (*order)[j - 1]); --j) {
+          (*order)[j] = (*order)[j - 1];
+          --budget;
+        }
+        (*order)[j] = entry;
+        if (budget == 0) {
+          break;
+        }
+      }
+      if (i >= count) {
+        return;
+      }
+    }
+    std::stable_sort(order->begin(), order->end(), less);
+  }
+
+  /**
+   * @brief Moves entries so that position `first + i` holds the entry that
+   * was at `first + order[i]`, e.g. with an order from ComputeOrder().
+   * `order` is consumed.
+   */
+  void Permute(size_t first, std::span<uint32_t> order) {
+    ApplyPermutation(order, [this, first](size_t a, size_t b) {
+      SwapEntries(first + a, first + b);
+    });
+  }
+
+  /**
+   * @brief Returns if the entity is in the storage.
+   * @returns whether or not the entity is found in this storage.
+   */
+  bool Has(EntityID entity) override {
+    const uint32_t* slot = FindSlot(entity);
+    return slot && *slot != kNullSlot && entities_[*slot] == entity;
+  }
+
+  /**
+   * @brief Clears all components from this storage.
+   */
+  void Clear() override {
+    entities_.clear();
+    components_.clear();
+    added_ticks_.clear();
+    changed_ticks_.clear();
+    FreePages();
+  }
+
+  /**
+   * @brief Returns the tick the entity's component was added at.
+   * @note Behavior is undefined if the entity is not in this storage.
+   */
+  uint32_t added_tick(EntityID entity) const {
+    return added_ticks_[*FindSlot(entity)];
+  }
+
+  /**
+   * @brief Returns the tick the entity's component was last added or changed
+   * at.
+   * @note Behavior is undefined if the entity is not in this storage.
+   */
+  uint32_t changed_tick(EntityID entity) const {
+    return changed_ticks_[*FindSlot(entity)];
+  }
+
+  /**
+   * @brief Stamps the entity's component as changed at `tick` and runs the
+   * update hooks.
+   */
+  void MarkChanged(EntityID entity, uint32_t tick) {
+    if (Has(entity)) {
+      changed_ticks_[*FindSlot(entity)] = tick;
+      RunUpdateHooks(entity);
+    }
+  }
+
+  /**
+   * @brief Triggers a notification that a component is being removed.
+   */
+  void NotifyRemoved(EntityID entity, Registry* registry) override;
+
+  /** @brief Returns the number of components currently stored. */
+  size_t size() const override { return entities_.size(); }
+
+  StorageStats stats() const override {
+    size_t pages = 0;
+    for (const Page& page : pages_) {
+      pages += page != nullptr;
+    }
+    StorageStats stats;
+    stats.name = TypeName<T>();
+    stats.size = entities_.size();
+    stats.capacity = entities_.capacity();
+    stats.bytes = entities_.capacity() * sizeof(EntityID) +
+                  components_.capacity() * sizeof(T) +
+                  (added_ticks_.capacity() + changed_ticks_.capacity()) *
+                      sizeof(uint32_t) +
+                  pages_.capacity() * sizeof(Page) +
+                  pages * kPageSize * sizeof(uint32_t);
+    if (pages > 0) {
+      stats.sparse_load = static_cast<float>(entities_.size()) /
+                          static_cast<float>(pages * kPageSize);
+    }
+    return stats;
+  }
+
+  /** @brief Preallocates the dense arrays for `count` components in total. */
+  void Reserve(size_t count) {
+    entities_.reserve(count);
+    components_.reserve(count);
+    added_ticks_.reserve(count);
+    changed_ticks_.reserve(count);
+  }
+
+  /** @brief Returns true if the storage holds no components. */
+  bool empty() const { return entities_.empty(); }
+
+  /**
+   * @brief Returns the dense array of entities owning a component.
+   *
+   * `entities()[i]` owns `data()[i]`.
+   */
+  const std::pmr::vector<EntityID>& entities() const { return entities_; }
+
+  /** @brief Returns the densely packed component array. */
+  T* data() { return components_.data(); }
+
+  /** @brief Iterators over the densely packed components. */
+  auto begin() { return components_.begin(); }
+  auto end() { return components_.end(); }
+
+ private:
+  /** @brief Number of sparse entries held by a single page. */
+  static constexpr size_t kPageSize = 4096;
+
+  /** @brief Sparse value for entities without a component. */
+  static constexpr uint32_t kNullSlot = 0xFFFFFFFF;
+
+  /**
+   * @brief Moves per entry an incremental sort may make before it falls back
+   * to a full sort.
+   */
+  static constexpr size_t kMaxInsertionMoves = 8;
+
+  /** @brief kPageSize sparse entries allocated from the storage's resource. */
+  using Page = uint32_t*;
+
+  /**
+   * @brief Returns the sparse entry for the entity, or nullptr if its page has
+   * not been allocated.
+   */
+  uint32_t* FindSlot(EntityID entity) const {
+    const uint32_t index = GetEntityIndex(entity);
+    const size_t page = index / kPageSize;
+    if (page >= pages_.size() || !pages_[page]) {
+      return nullptr;
+    }
+    return &pages_[page][index % kPageSize];
+  }
+
+  /**
+   * @brief Returns the sparse entry for the entity, allocating its page first
+   * if needed.
+   */
+  uint32_t* AssureSlot(EntityID entity) {
+    const uint32_t index = GetEntityIndex(entity);
+    const size_t page = index / kPageSize;
+    if (page >= pages_.size()) {
+      pages_.resize(page + 1);
+    }
+    if (!pages_[page]) {
+      pages_[page] = PageAllocator(pages_.get_allocator().resource())
+                         .allocate(kPageSize);
+      std::fill_n(pages_[page], kPageSize, kNullSlot);
+    }
+    return &pages_[page][index % kPageSize];
+  }
+
+  using PageAllocator = std::pmr::polymorphic_allocator<uint32_t>;
+
+  void FreePages() {
+    PageAllocator allocator(pages_.get_allocator().resource());
+    for (Page page : pages_) {
+      if (page) {
+        allocator.deallocate(page, kPageSize);
+      }
+    }
+    pages_.clear();
+  }
+
+  std::pmr::vector<Page> pages_;
+  std::pmr::vector<EntityID> entities_;
+  std::pmr::vector<T> components_;
+  /** @brief Change ticks, parallel to the dense arrays. */
+  std::pmr::vector<uint32_t> added_ticks_;
+  std::pmr::vector<uint32_t> changed_ticks_;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_COMPONENT_STORAGE_H_
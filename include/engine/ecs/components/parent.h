@@ -0,0 +1,28 @@
+/**
+ * @file parent.h
+ * @brief Relationship component attaching an entity to another one.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_COMPONENTS_PARENT_H_
+#define INCLUDE_ENGINE_ECS_COMPONENTS_PARENT_H_
+
+#include <engine/ecs/entity_manager.h>
+
+namespace engine::ecs::components {
+
+/**
+ * @brief Attaches an entity to a parent entity.
+ *
+ * The entity's Transform is then relative to the parent's world transform,
+ * and the HierarchySystem writes the combined result into WorldTransform.
+ * Both entities need a Transform. Change it through AddComponent() or
+ * PatchComponent() so the hierarchy notices. Children of an entity are found
+ * through HierarchySystem::Subtree().
+ */
+struct Parent {
+  EntityID entity = kInvalidEntity;
+};
+
+}  // namespace engine::ecs::components
+
+#endif  // INCLUDE_ENGINE_ECS_COMPONENTS_PARENT_H_
@@ -0,0 +1,24 @@
+/**
+ * @file world_transform.h
+ * @brief Cached world-space transform of entities in a hierarchy.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_COMPONENTS_WORLD_TRANSFORM_H_
+#define INCLUDE_ENGINE_ECS_COMPONENTS_WORLD_TRANSFORM_H_
+
+#include <engine/ecs/components/transform.h>
+
+namespace engine::ecs::components {
+
+/**
+ * @brief World-space transform of an entity that has a parent or children.
+ *
+ * Written by the HierarchySystem; do not modify it directly. Entities outside
+ * any hierarchy do not get one, since their Transform already is in world
+ * space. Renderers should prefer it over Transform when present.
+ */
+struct WorldTransform : Transform {};
+
+}  // namespace engine::ecs::components
+
+#endif  // INCLUDE_ENGINE_ECS_COMPONENTS_WORLD_TRANSFORM_H_
@@ -6,6 +6,8 @@
 #ifndef INCLUDE_ENGINE_ECS_LUA_BINDINGS_H_
 #define INCLUDE_ENGINE_ECS_LUA_BINDINGS_H_
 
+#include <string>
+
 #include <sol/sol.hpp>
 
 #include <engine/ecs/registry.h>
@@ -29,6 +31,29 @@ class ECSBindings {
    */
   static void BindComponents(sol::state& lua);
 
+  /**
+   * @brief Exposes a registry resource to Lua as `get_<name>()` and
+   * `has_<name>()`.
+   *
+   * `get_<name>()` returns the current registry's resource by reference, or
+   * nil if it is not set; bind T with `new_usertype` first so its fields are
+   * visible.
+   *
+   * @param lua Reference to the Lua state.
+   * @param name Suffix of the Lua function names.
+   */
+  template <typename T>
+  static void BindResource(sol::state& lua, const std::string& name) {
+    lua["get_" + name] = [&lua]() -> T* {
+      Registry* reg = lua["registry"];
+      return reg->GetResource<T>();
+    };
+    lua["has_" + name] = [&lua]() {
+      Registry* reg = lua["registry"];
+      return reg->HasResource<T>();
+    };
+  }
+
   /**
    * @brief Updates the current registry reference in Lua.
    * @param lua Reference to the Lua state.
@@ -0,0 +1,208 @@
+/**
+ * @file entity_command_buffer.h
+ * @brief Deferred recording of structural ECS changes.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_ENTITY_COMMAND_BUFFER_H_
+#define INCLUDE_ENGINE_ECS_ENTITY_COMMAND_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <engine/ecs/entity_manager.h>
+
+namespace engine::ecs {
+
+class Registry;
+
+namespace detail {
+/**
+ * @brief Sort key stamped on commands recorded by the current thread.
+ *
+ * The SystemScheduler sets the high 32 bits to the running system's position
+ * and Registry::ParallelForEach sets the low 32 bits to the index of the
+ * entity being visited, so playback order does not depend on which worker
+ * happened to process what.
+ */
+inline thread_local uint64_t command_sort_key = 0;
+
+// Defined in registry.h, where the Registry is complete.
+template <typename T>
+void CommandInsert(Registry& registry, EntityID entity, void* component);
+template <typename T>
+void CommandRemove(Registry& registry, EntityID entity);
+template <typename T>
+void CommandPublishAdded(Registry& registry, EntityID entity);
+}  // namespace detail
+
+/**
+ * @brief Sets the command sort key of the current thread for its lifetime.
+ */
+class ScopedCommandSortKey {
+ public:
+  explicit ScopedCommandSortKey(uint64_t key)
+      : previous_(detail::command_sort_key) {
+    detail::command_sort_key = key;
+  }
+  ~ScopedCommandSortKey() { detail::command_sort_key = previous_; }
+
+  ScopedCommandSortKey(const ScopedCommandSortKey&) = delete;
+  ScopedCommandSortKey& operator=(const ScopedCommandSortKey&) = delete;
+
+ private:
+  uint64_t previous_;
+};
+
+/**
+ * @brief Records entity creation, deletion and component add/remove for later
+ * playback on a Registry.
+ *
+ * Recording never touches the registry, so it is safe while views are being
+ * iterated and from worker threads as long as each thread records into its
+ * own buffer (see Registry::commands()). Spawned entities are represented by
+ * placeholder handles that may be used as the target of later commands in
+ * the same playback; they are replaced with real entities at playback.
+ *
+ * Playback sorts all commands by their sort key (stable, so a thread's
+ * commands for one key keep their recording order), creates the spawned
+ * entities, applies the remaining commands and finally publishes the
+ * EntityCreatedEvents and ComponentAddedEvents in one batch. Added events are
+ * only published for components that still exist once playback is done.
+ * Removal and destruction events are published as they happen, since their
+ * payload refers to the component being removed.
+ *
+ * @note Placeholders stored inside component data are not remapped.
+ */
+class EntityCommandBuffer {
+ public:
+  /**
+   * @brief Creates an empty buffer.
+   * @param placeholder_counter Counter shared by buffers that are played back
+   * together, so their placeholders never collide. Uses a private counter if
+   * null.
+   */
+  explicit EntityCommandBuffer(
+      std::atomic<uint32_t>* placeholder_counter = nullptr);
+  ~EntityCommandBuffer();
+
+  EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+  EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+  /**
+   * @brief Records the creation of an entity.
+   * @return A placeholder handle for the entity, or kInvalidEntity if the
+   * placeholder space is exhausted.
+   */
+  EntityID CreateEntity();
+
+  /** @brief Records the deletion of an entity or placeholder. */
+  void DeleteEntity(EntityID entity);
+
+  /**
+   * @brief Records adding (or replacing) a component.
+   * @param entity A live entity or a placeholder from this playback.
+   * @param component The component, moved into the buffer until playback.
+   */
+  template <typename T>
+  void AddComponent(EntityID entity, T component) {
+    EmplaceComponent<T>(entity, std::move(component));
+  }
+
+  /**
+   * @brief Records adding (or replacing) a component constructed in place
+   * from `args`; it is moved into its storage at playback.
+   */
+  template <typename T, typename... Args>
+  void EmplaceComponent(EntityID entity, Args&&... args) {
+    void* payload = Allocate(sizeof(T), alignof(T));
+    new (payload) T(std::forward<Args>(args)...);
+    Record(Op::kAdd, entity, &ComponentOps::Of<T>(), payload);
+  }
+
+  /** @brief Records removing a component. */
+  template <typename T>
+  void RemoveComponent(EntityID entity) {
+    Record(Op::kRemove, entity, &ComponentOps::Of<T>(), nullptr);
+  }
+
+  /** @brief Returns the number of recorded commands. */
+  size_t size() const { return commands_.size(); }
+
+  /** @brief Returns true if no commands are recorded. */
+  bool empty() const { return commands_.empty(); }
+
+  /** @brief Discards every recorded command. */
+  void Clear();
+
+  /** @brief Applies this buffer's commands to the registry and clears it. */
+  void Playback(Registry& registry);
+
+  /**
+   * @brief Applies the commands of several buffers as one sorted stream and
+   * clears them.
+   *
+   * Commands with equal sort keys are applied in buffer order. The buffers
+   * must share a placeholder counter.
+   */
+  static void Playback(EntityCommandBuffer* const* buffers, size_t count,
+                       Registry& registry);
+
+ private:
+  enum class Op : uint8_t { kCreate, kDelete, kAdd, kRemove };
+
+  /** @brief Type-erased operations on one component type. */
+  struct ComponentOps {
+    void (*insert)(Registry& registry, EntityID entity, void* component);
+    void (*remove)(Registry& registry, EntityID entity);
+    void (*publish_added)(Registry& registry, EntityID entity);
+    void (*destroy)(void* component);
+
+    template <typename T>
+    static const ComponentOps& Of() {
+      static const ComponentOps ops{
+          &detail::CommandInsert<T>, &detail::CommandRemove<T>,
+          &detail::CommandPublishAdded<T>,
+          [](void* component) { static_cast<T*>(component)->~T(); }};
+      return ops;
+    }
+  };
+
+  struct Command {
+    uint64_t sort_key;
+    Op op;
+    EntityID entity;
+    const ComponentOps* ops;
+    void* payload;
+  };
+
+  /** @brief Size of a payload block; larger payloads get their own block. */
+  static constexpr size_t kBlockSize = 4096;
+
+  void Record(Op op, EntityID entity, const ComponentOps* ops, void* payload) {
+    commands_.push_back(
+        {detail::command_sort_key, op, entity, ops, payload});
+  }
+
+  /** @brief Returns aligned storage that stays put until Clear(). */
+  void* Allocate(size_t size, size_t alignment);
+
+  /** @brief Destroys pending payloads and recycles the payload blocks. */
+  void ReleasePayloads(std::vector<Command>* commands);
+
+  std::vector<Command> commands_;
+  std::vector<std::unique_ptr<std::byte[]>> blocks_;
+  std::vector<size_t> block_sizes_;
+  size_t block_ = 0;
+  size_t block_used_ = 0;
+  std::atomic<uint32_t> own_counter_{0};
+  std::atomic<uint32_t>* placeholder_counter_;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_ENTITY_COMMAND_BUFFER_H_
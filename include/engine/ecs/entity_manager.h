@@ -6,6 +6,7 @@
 #ifndef INCLUDE_ENGINE_ECS_ENTITY_MANAGER_H_
 #define INCLUDE_ENGINE_ECS_ENTITY_MANAGER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -15,48 +16,187 @@
  */
 namespace engine::ecs {
 
-/** @brief Type used to uniquely identify an entity. */
+/**
+ * @brief Type used to uniquely identify an entity.
+ *
+ * An EntityID is a versioned handle: the low `kEntityIndexBits` bits hold the
+ * slot index and the remaining high bits hold the slot's generation. The
+ * generation is bumped every time a slot is released, so handles to destroyed
+ * entities stay invalid even after their slot has been reused.
+ */
 using EntityID = uint32_t;
 
 /** @brief Constant representing an invalid or null entity. */
 constexpr EntityID kInvalidEntity = 0xFFFFFFFF;
 
+/** @brief Number of low bits of an EntityID that store the slot index. */
+constexpr uint32_t kEntityIndexBits = 20;
+
+/** @brief Mask selecting the slot index of an EntityID. */
+constexpr uint32_t kEntityIndexMask = (1u << kEntityIndexBits) - 1;
+
+/** @brief Mask selecting the generation once shifted down. */
+constexpr uint32_t kEntityGenerationMask = (1u << (32 - kEntityIndexBits)) - 1;
+
+/**
+ * @brief Maximum number of simultaneously allocated entity slots.
+ *
+ * The all-ones index is reserved so that no live handle can ever compare equal
+ * to kInvalidEntity.
+ */
+constexpr uint32_t kMaxEntities = kEntityIndexMask;
+
+/**
+ * @brief Generation reserved for placeholder handles.
+ *
+ * EntityCommandBuffer hands these out for entities it has not created yet.
+ * Slot generations wrap around before reaching this value, so a placeholder
+ * never names a live entity.
+ */
+constexpr uint32_t kPlaceholderGeneration = kEntityGenerationMask;
+
+/** @brief Returns the slot index portion of an entity handle. */
+constexpr uint32_t GetEntityIndex(EntityID entity) {
+  return entity & kEntityIndexMask;
+}
+
+/** @brief Returns the generation portion of an entity handle. */
+constexpr uint32_t GetEntityGeneration(EntityID entity) {
+  return entity >> kEntityIndexBits;
+}
+
+/** @brief Builds an entity handle from a slot index and a generation. */
+constexpr EntityID MakeEntityID(uint32_t index, uint32_t generation) {
+  return ((generation & kEntityGenerationMask) << kEntityIndexBits) |
+         (index & kEntityIndexMask);
+}
+
+/** @brief Returns true if the handle is an EntityCommandBuffer placeholder. */
+constexpr bool IsPlaceholderEntity(EntityID entity) {
+  return entity != kInvalidEntity &&
+         GetEntityGeneration(entity) == kPlaceholderGeneration;
+}
+
 /**
  * @brief Manages the allocation and deallocation of entity IDs.
  *
- * The EntityManager keeps track of active entities and reuses IDs of destroyed
- * entities to keep the ID space compact.
+ * The EntityManager keeps one slot per allocated index and reuses the slots of
+ * destroyed entities to keep the index space compact. Creation, destruction
+ * and liveness checks are all O(1).
+ *
+ * Each slot also carries a component mask: bit `t % 64` of word `t / 64` is
+ * set while the entity has the component with ComponentTypeId `t`. The
+ * Registry's storages keep the bits up to date, so "which components does
+ * this entity have" and "does it have all of these" are answered from one or
+ * two words instead of probing every storage.
  */
 class EntityManager {
  public:
+  /** @brief Number of component bits per mask word. */
+  static constexpr size_t kMaskWordBits = 64;
+
   /**
    * @brief Creates a new entity ID.
    *
-   * If any entity IDs have been previously destroyed, one of them will be
-   * reused. Otherwise, a new ID is generated.
+   * If any entity slots have been previously released, the most recently
+   * released one is reused with its generation advanced. Otherwise, a new slot
+   * is allocated.
    *
-   * @return The newly created EntityID.
+   * @return The newly created EntityID, or kInvalidEntity if all kMaxEntities
+   * slots are in use.
    */
   EntityID CreateEntity();
 
   /**
-   * @brief Destroys an entity, making its ID available for reuse.
+   * @brief Destroys an entity, making its slot available for reuse.
+   *
+   * Destroying a handle that is not alive has no effect. The slot's component
+   * mask is left as is, so its components must have been removed first, as
+   * the Registry does.
+   *
    * @param entity The ID of the entity to destroy.
    */
   void DestroyEntity(EntityID entity);
 
   /**
    * @brief Checks if an entity ID is currently in use.
+   *
+   * Returns false for stale handles whose slot has since been reused.
+   *
    * @param entity The entity ID to check.
    * @return True if the entity is active, false otherwise.
    */
-  bool IsAlive(EntityID entity) const;
+  bool IsAlive(EntityID entity) const {
+    const uint32_t index = GetEntityIndex(entity);
+    return index < slots_.size() && slots_[index] == entity;
+  }
+
+  /**
+   * @brief Returns the live handle occupying a slot.
+   * @param index The slot index.
+   * @return The live handle, or kInvalidEntity if the slot is free.
+   */
+  EntityID GetEntity(uint32_t index) const {
+    if (index >= slots_.size() || GetEntityIndex(slots_[index]) != index) {
+      return kInvalidEntity;
+    }
+    return slots_[index];
+  }
+
+  /**
+   * @brief Widens the component masks to hold bit `type` if they cannot yet.
+   *
+   * Must be called before the bit of a new type is set. Widening rewrites
+   * every slot's mask, which only happens once per 64 component types.
+   */
+  void AddComponentType(uint32_t type) {
+    if (type >= mask_words_ * kMaskWordBits) {
+      WidenMasks(type / kMaskWordBits + 1);
+    }
+  }
+
+  /** @brief Returns the number of 64-bit words in each slot's mask. */
+  size_t mask_words() const { return mask_words_; }
 
   /**
-   * @brief Returns the high-water mark for entity IDs.
-   * @return The next ID that would be allocated if no IDs were being reused.
+   * @brief Returns the mask of an allocated slot, mask_words() words long.
+   *
+   * The pointer is invalidated by creating entities and by
+   * AddComponentType().
    */
-  EntityID next_id() const { return next_id_; }
+  const uint64_t* ComponentMask(uint32_t index) const {
+    return masks_.data() + index * mask_words_;
+  }
+
+  /** @brief Sets the bit of a registered component type in a slot's mask. */
+  void SetComponentBit(uint32_t index, uint32_t type) {
+    masks_[index * mask_words_ + type / kMaskWordBits] |=
+        uint64_t{1} << (type % kMaskWordBits);
+  }
+
+  /**
+   * @brief Returns true if a slot's mask has the bit of a component type.
+   * Types never registered through AddComponentType() have no bit set.
+   */
+  bool HasComponentBit(uint32_t index, uint32_t type) const {
+    const size_t word = type / kMaskWordBits;
+    return word < mask_words_ &&
+           (masks_[index * mask_words_ + word] >> (type % kMaskWordBits) &
+            1) != 0;
+  }
+
+  /** @brief Clears the bit of a registered component type in a slot's mask. */
+  void ResetComponentBit(uint32_t index, uint32_t type) {
+    masks_[index * mask_words_ + type / kMaskWordBits] &=
+        ~(uint64_t{1} << (type % kMaskWordBits));
+  }
+
+  /**
+   * @brief Returns the high-water mark for entity slots.
+   * @return The next slot index that would be allocated if no slots were being
+   * reused.
+   */
+  EntityID next_id() const { return static_cast<EntityID>(slots_.size()); }
 
   /**
    * @brief Returns the total number of active entities.
@@ -64,14 +204,60 @@ class EntityManager {
    */
   size_t GetEntityCount() const;
 
+  /**
+   * @brief Preallocates slots so the next `count` creations do not
+   * reallocate.
+   */
+  void Reserve(size_t count) {
+    if (count > free_indices_.size()) {
+      slots_.reserve(slots_.size() + count - free_indices_.size());
+      masks_.reserve(slots_.capacity() * mask_words_);
+    }
+  }
+
   /**
    * @brief Resets the EntityManager, destroying all entities.
    */
   void Clear();
 
+  /**
+   * @brief Returns the per-slot handles; free slots have the all-ones index.
+   *
+   * Together with free_indices() this is the complete allocator state.
+   */
+  const std::vector<EntityID>& slots() const { return slots_; }
+
+  /** @brief Returns the released slot indices, most recent last. */
+  const std::vector<uint32_t>& free_indices() const { return free_indices_; }
+
+  /**
+   * @brief Replaces the allocator state with one captured from slots() and
+   * free_indices(), so previously handed out handles become valid again.
+   * Every component mask is cleared; the components restored afterwards set
+   * their bits again.
+   */
+  void Restore(const EntityID* slots, size_t slot_count,
+               const uint32_t* free_indices, size_t free_count);
+
  private:
-  EntityID next_id_ = 0;
-  std::vector<EntityID> free_entities_;
+  /**
+   * @brief Per-slot handle.
+   *
+   * Live slots hold the handle that was handed out. Free slots keep their next
+   * generation with the index bits set to the reserved all-ones index, so a
+   * single comparison against the requested handle answers IsAlive.
+   */
+  std::vector<EntityID> slots_;
+
+  /** @brief Stack of released slot indices. */
+  std::vector<uint32_t> free_indices_;
+
+  /** @brief Re-lays out the masks with `words` words per slot. */
+  void WidenMasks(size_t words);
+
+  /** @brief Component masks, `mask_words_` words per slot. */
+  std::vector<uint64_t> masks_;
+  size_t mask_words_ = 1;
 };
 }  // namespace engine::ecs
 
@@ -0,0 +1,282 @@
+/**
+ * @file event_dispatcher.h
+ * @brief Per-type listener lists and deferred event queues.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_EVENTS_EVENT_DISPATCHER_H_
+#define INCLUDE_ENGINE_ECS_EVENTS_EVENT_DISPATCHER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <engine/core/job_system.h>
+#include <engine/ecs/events/component_events.h>
+#include <engine/ecs/events/events.h>
+#include <engine/ecs/type_family.h>
+#include <engine/util/logger.h>
+
+namespace engine::ecs::events {
+
+/**
+ * @brief Describes how an event is kept in a deferred queue.
+ *
+ * By default the event is copied as is. Events that refer to data they do
+ * not own specialize this to store a copy of that data instead (`Stored`)
+ * and to rebuild an event pointing at the copy when it is dispatched.
+ */
+template <typename E>
+struct DeferredEvent {
+  using Stored = E;
+  static Stored Store(const E& event) { return event; }
+  static const E& Restore(const Stored& stored) { return stored; }
+};
+
+/**
+ * @brief Deferred form of the component events, which hold a reference to
+ * the component. The queue keeps a copy of the component as it was when the
+ * event was published, so the event stays valid even if the component is
+ * removed or its storage reallocates before dispatch.
+ */
+template <template <typename> class Event, typename T>
+struct DeferredComponentEvent {
+  struct Stored {
+    EntityID entity;
+    T component;
+    engine::ecs::Registry* registry;
+  };
+  static Stored Store(const Event<T>& event) {
+    return {event.entity, event.component, event.registry};
+  }
+  static Event<T> Restore(Stored& stored) {
+    return {stored.entity, stored.component, stored.registry};
+  }
+};
+
+template <typename T>
+struct DeferredEvent<ComponentAddedEvent<T>>
+    : DeferredComponentEvent<ComponentAddedEvent, T> {};
+template <typename T>
+struct DeferredEvent<ComponentRemovedEvent<T>>
+    : DeferredComponentEvent<ComponentRemovedEvent, T> {};
+template <typename T>
+struct DeferredEvent<ComponentModifiedEvent<T>>
+    : DeferredComponentEvent<ComponentModifiedEvent, T> {};
+
+/**
+ * @brief Listener and queue figures of one event dispatcher.
+ */
+struct DispatcherStats {
+  /** @brief Name of the event type. */
+  std::string_view name;
+  size_t listeners = 0;
+  /** @brief Deferred events waiting for the next ProcessQueue(). */
+  size_t queued = 0;
+};
+
+/**
+ * @brief Base interface of the per-type dispatchers.
+ */
+class IEventDispatcher {
+ public:
+  virtual ~IEventDispatcher() = default;
+
+  /** @brief Dispatches every event queued since the last call. */
+  virtual void ProcessQueue() = 0;
+
+  /** @brief Drops every listener and queued event. */
+  virtual void Clear() = 0;
+
+  /** @brief Returns the listener and queue figures of the dispatcher. */
+  virtual DispatcherStats stats() const = 0;
+
+ protected:
+  IEventDispatcher() = default;
+};
+
+/**
+ * @brief Listener list and deferred queues for one event type.
+ *
+ * Listeners are called through IEventListener directly, without wrapping
+ * them. Deferred events go into one append buffer per JobSystem thread, so
+ * workers can queue events without contending; ProcessQueue() drains the
+ * buffers in thread order, each in publishing order.
+ *
+ * The listener list and the queues are allocated from the memory resource
+ * given at construction, which must be thread-safe because workers queue
+ * events concurrently.
+ *
+ * Subscribing, unsubscribing, dispatching immediately and ProcessQueue()
+ * must not run concurrently with each other. Listeners may subscribe,
+ * unsubscribe and publish while being notified: listeners removed during a
+ * dispatch are skipped, and listeners added during one first hear the next
+ * event.
+ *
+ * @tparam T The event type.
+ */
+template <typename T>
+class EventDispatcher final : public IEventDispatcher {
+ public:
+  explicit EventDispatcher(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : listeners_(resource),
+        queue_count_(std::max<size_t>(core::JobSystem::Get().worker_count(),
+                                      std::thread::hardware_concurrency()) +
+                     1) {
+    queues_.reserve(queue_count_);
+    for (size_t i = 0; i < queue_count_; ++i) {
+      queues_.push_back(std::make_unique<ThreadQueue>(resource));
+    }
+  }
+
+  void Subscribe(IEventListener<T>* listener, bool one_shot) {
+    listeners_.push_back({listener, one_shot});
+  }
+
+  void Unsubscribe(IEventListener<T>* listener) {
+    if (dispatch_depth_ > 0) {
+      for (Listener& entry : listeners_) {
+        if (entry.target == listener) {
+          entry.target = nullptr;
+          has_tombstones_ = true;
+        }
+      }
+      return;
+    }
+    listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                    [listener](const Listener& entry) {
+                                      return entry.target == listener;
+                                    }),
+                     listeners_.end());
+  }
+
+  /** @brief Returns true if at least one listener is subscribed. */
+  bool has_listeners() const { return !listeners_.empty(); }
+
+  /** @brief Notifies every listener right away. */
+  void Dispatch(const T& event) {
+    ++dispatch_depth_;
+    // Listeners added by a callback are past `count` and wait for the next
+    // event; the vector may reallocate, so it is indexed afresh each time.
+    const size_t count = listeners_.size();
+    for (size_t i = 0; i < count; ++i) {
+      IEventListener<T>* target = listeners_[i].target;
+      if (!target) {
+        continue;
+      }
+      if (listeners_[i].one_shot) {
+        listeners_[i].target = nullptr;
+        has_tombstones_ = true;
+      }
+      target->OnEvent(event);
+    }
+    if (--dispatch_depth_ == 0 && has_tombstones_) {
+      listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                      [](const Listener& entry) {
+                                        return entry.target == nullptr;
+                                      }),
+                       listeners_.end());
+      has_tombstones_ = false;
+    }
+  }
+
+  /**
+   * @brief Queues the event for the next ProcessQueue(). Safe to call from
+   * any thread.
+   */
+  void Enqueue(const T& event) {
+    if constexpr (std::is_copy_constructible_v<
+                      typename DeferredEvent<T>::Stored>) {
+      const size_t index = core::JobSystem::GetThreadIndex() % queue_count_;
+      ThreadQueue& queue = *queues_[index];
+      {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.events.push_back(DeferredEvent<T>::Store(event));
+      }
+      pending_.store(true, std::memory_order_release);
+    } else {
+      LOG_ERR("Events with a non-copyable payload cannot be deferred.");
+    }
+  }
+
+  void ProcessQueue() override {
+    if (!pending_.exchange(false, std::memory_order_acquire)) {
+      return;
+    }
+    // Events queued by listeners below are left for the next call.
+    std::pmr::vector<Stored> batch(listeners_.get_allocator().resource());
+    for (const auto& queue : queues_) {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      if (batch.empty()) {
+        batch.swap(queue->events);
+      } else {
+        std::move(queue->events.begin(), queue->events.end(),
+                  std::back_inserter(batch));
+        queue->events.clear();
+      }
+    }
+    for (Stored& stored : batch) {
+      Dispatch(DeferredEvent<T>::Restore(stored));
+    }
+  }
+
+  void Clear() override {
+    listeners_.clear();
+    has_tombstones_ = false;
+    for (const auto& queue : queues_) {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      queue->events.clear();
+    }
+    pending_.store(false, std::memory_order_relaxed);
+  }
+
+  DispatcherStats stats() const override {
+    DispatcherStats stats;
+    stats.name = TypeName<T>();
+    for (const Listener& entry : listeners_) {
+      stats.listeners += entry.target != nullptr;
+    }
+    for (const auto& queue : queues_) {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      stats.queued += queue->events.size();
+    }
+    return stats;
+  }
+
+ private:
+  using Stored = typename DeferredEvent<T>::Stored;
+
+  struct Listener {
+    IEventListener<T>* target;
+    bool one_shot;
+  };
+
+  /** @brief Append buffer of one thread, padded against false sharing. */
+  struct alignas(64) ThreadQueue {
+    explicit ThreadQueue(std::pmr::memory_resource* resource)
+        : events(resource) {}
+
+    std::mutex mutex;
+    std::pmr::vector<Stored> events;
+  };
+
+  std::pmr::vector<Listener> listeners_;
+  int dispatch_depth_ = 0;
+  bool has_tombstones_ = false;
+  const size_t queue_count_;
+  std::vector<std::unique_ptr<ThreadQueue>> queues_;
+  std::atomic<bool> pending_{false};
+};
+
+}  // namespace engine::ecs::events
+
+#endif  // INCLUDE_ENGINE_ECS_EVENTS_EVENT_DISPATCHER_H_
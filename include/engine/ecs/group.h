@@ -0,0 +1,206 @@
+/**
+ * @file group.h
+ * @brief Owning groups that keep co-iterated sparse-set storages packed in
+ * the same order.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_GROUP_H_
+#define INCLUDE_ENGINE_ECS_GROUP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/entity_manager.h>
+#include <engine/ecs/tag_storage.h>
+
+namespace engine::ecs {
+
+/**
+ * @brief Lists the component types a group requires but does not own.
+ *
+ * Also a view filter requiring the types without passing them to the
+ * callback.
+ *
+ * Example:
+ * @code
+ * registry.GetGroup<Sprite>(With<Transform>{});
+ * registry.GetView<Transform>(With<Enemy>{});
+ * @endcode
+ */
+template <typename... Components>
+struct With {};
+
+/**
+ * @brief View filter excluding entities that have any of the types.
+ *
+ * Example:
+ * @code
+ * registry.GetView<Transform>(With<Enemy>{}, Without<Downed>{});
+ * @endcode
+ */
+template <typename... Components>
+struct Without {};
+
+/**
+ * @brief Base interface for the bookkeeping of a group.
+ */
+class IGroupHandler {
+ public:
+  virtual ~IGroupHandler() = default;
+
+  /** @brief Forgets every member, e.g. after the storages were cleared. */
+  virtual void Reset() = 0;
+
+  /** @brief Returns the number of members. */
+  virtual size_t size() const = 0;
+
+  /**
+   * @brief Reorders the members the same way in every owned storage:
+   * position `i` receives the member that was at `order[i]`. `order` must be
+   * a permutation of `[0, size())` and is consumed.
+   */
+  virtual void Permute(std::span<uint32_t> order) = 0;
+
+ protected:
+  IGroupHandler() = default;
+};
+
+template <typename OwnedList, typename ObservedList>
+class GroupHandler;
+
+/**
+ * @brief Keeps the entities that have every owned and observed component at
+ * the front of the owned storages, in the same order in each.
+ *
+ * Positions `[0, size())` of every owned storage's dense arrays belong to the
+ * group's members, so `data()[i]` of each owned storage refers to the same
+ * entity. The order is maintained through the storages' hooks: an entity
+ * that gains its last missing component is swapped to position `size()` of
+ * each owned storage, and an entity about to lose one is swapped to the last
+ * member position and dropped from the group before the removal runs.
+ *
+ * @tparam Owned The component types whose storages the group sorts.
+ * @tparam Observed Extra component types members must have; they are looked
+ * up per entity and their storages keep their own order. Tags may be
+ * observed.
+ */
+template <typename... Owned, typename... Observed>
+class GroupHandler<std::tuple<Owned...>, std::tuple<Observed...>> final
+    : public IGroupHandler {
+ public:
+  static_assert(sizeof...(Owned) > 0, "A group must own at least one type.");
+
+  GroupHandler(std::tuple<ComponentStorage<Owned>*...> owned,
+               std::tuple<StorageOf<Observed>*...> observed)
+      : owned_(owned), observed_(observed) {
+    const IComponentStorage::Hook construct{&OnConstruct, this};
+    const IComponentStorage::Hook destroy{&OnDestroy, this};
+    auto attach = [this, construct, destroy](IComponentStorage* storage) {
+      storage->AddConstructHook(construct);
+      storage->AddDestroyHook(destroy);
+    };
+    (attach(std::get<ComponentStorage<Owned>*>(owned_)), ...);
+    (attach(std::get<StorageOf<Observed>*>(observed_)), ...);
+    (std::get<ComponentStorage<Owned>*>(owned_)->set_owner(this), ...);
+
+    // Positions before `i` are either members or already rejected, so the
+    // entry a swap moves to `i` has been visited.
+    const std::pmr::vector<EntityID>& entities = lead()->entities();
+    for (size_t i = 0; i < entities.size(); ++i) {
+      Enter(entities[i]);
+    }
+  }
+
+  GroupHandler(const GroupHandler&) = delete;
+  GroupHandler& operator=(const GroupHandler&) = delete;
+
+  void Reset() override { size_ = 0; }
+
+  /** @brief Returns the number of members. */
+  size_t size() const override { return size_; }
+
+  void Permute(std::span<uint32_t> order) override {
+    ApplyPermutation(order, [this](size_t a, size_t b) {
+      (std::get<ComponentStorage<Owned>*>(owned_)->SwapEntries(a, b), ...);
+    });
+  }
+
+  /** @brief Returns true if the entity is a member. */
+  bool Contains(EntityID entity) const {
+    return lead()->Has(entity) && lead()->IndexOf(entity) < size_;
+  }
+
+  /** @brief Returns the members; `entities()[i]` owns `data<T>()[i]`. */
+  const EntityID* entities() const { return lead()->entities().data(); }
+
+  /** @brief Returns the packed array of an owned component type. */
+  template <typename T>
+  T* data() const {
+    return std::get<ComponentStorage<T>*>(owned_)->data();
+  }
+
+  /** @brief Invokes `func(entity, owned..., observed...)` for every member. */
+  template <typename Func>
+  void Each(Func& func) const {
+    const EntityID* members = entities();
+    std::tuple<Owned*...> arrays{data<Owned>()...};
+    for (size_t i = 0; i < size_; ++i) {
+      func(members[i], std::get<Owned*>(arrays)[i]...,
+           std::get<StorageOf<Observed>*>(observed_)->Get(
+               members[i])...);
+    }
+  }
+
+ private:
+  using Lead = std::tuple_element_t<0, std::tuple<Owned...>>;
+
+  ComponentStorage<Lead>* lead() const {
+    return std::get<ComponentStorage<Lead>*>(owned_);
+  }
+
+  static void OnConstruct(void* self, EntityID entity) {
+    static_cast<GroupHandler*>(self)->Enter(entity);
+  }
+
+  static void OnDestroy(void* self, EntityID entity) {
+    static_cast<GroupHandler*>(self)->Leave(entity);
+  }
+
+  void Enter(EntityID entity) {
+    const bool complete =
+        (std::get<ComponentStorage<Owned>*>(owned_)->Has(entity) && ...) &&
+        (std::get<StorageOf<Observed>*>(observed_)->Has(entity) && ...);
+    if (!complete || lead()->IndexOf(entity) < size_) {
+      return;
+    }
+    (MoveTo(std::get<ComponentStorage<Owned>*>(owned_), entity, size_), ...);
+    ++size_;
+  }
+
+  void Leave(EntityID entity) {
+    if (!Contains(entity)) {
+      return;
+    }
+    --size_;
+    (MoveTo(std::get<ComponentStorage<Owned>*>(owned_), entity, size_), ...);
+  }
+
+  template <typename T>
+  static void MoveTo(ComponentStorage<T>* storage, EntityID entity,
+                     size_t position) {
+    storage->SwapEntries(storage->IndexOf(entity), position);
+  }
+
+  std::tuple<ComponentStorage<Owned>*...> owned_;
+  std::tuple<StorageOf<Observed>*...> observed_;
+  size_t size_ = 0;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_GROUP_H_
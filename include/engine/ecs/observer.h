@@ -0,0 +1,163 @@
+/**
+ * @file observer.h
+ * @brief Reactive observers that collect the entities whose components were
+ * added or changed, for a system to process on its next run.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_OBSERVER_H_
+#define INCLUDE_ENGINE_ECS_OBSERVER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/entity_manager.h>
+#include <engine/ecs/tag_storage.h>
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+/** @brief ID space for observer trigger lists. */
+using ObserverFamily = TypeFamily<struct ObserverFamilyTag>;
+
+/** @brief Observer trigger: the entity gained a T. */
+template <typename T>
+struct OnAdded {};
+
+/**
+ * @brief Observer trigger: the entity's T was stamped as changed, through
+ * PatchComponent() or MarkChanged(), or replaced by AddComponent().
+ */
+template <typename T>
+struct OnChanged {};
+
+/** @brief Maps an observer trigger to its component and storage hook. */
+template <typename Trigger>
+struct ObserverTrigger;
+
+template <typename T>
+struct ObserverTrigger<OnAdded<T>> {
+  using Component = T;
+  static void Attach(IComponentStorage* storage, IComponentStorage::Hook hook) {
+    storage->AddConstructHook(hook);
+  }
+};
+
+template <typename T>
+struct ObserverTrigger<OnChanged<T>> {
+  static_assert(!IsTag<T>::value, "Tags have no change ticks.");
+  using Component = T;
+  static void Attach(IComponentStorage* storage, IComponentStorage::Hook hook) {
+    storage->AddUpdateHook(hook);
+  }
+};
+
+/** @brief The component type a trigger watches. */
+template <typename Trigger>
+using TriggerComponent = typename ObserverTrigger<Trigger>::Component;
+
+/**
+ * @brief Collects the entities that fired any of an observer's triggers.
+ *
+ * The set is a dense array of entities plus a slot-indexed table of their
+ * positions in it, so an entity that fires many times between two drains is
+ * stored once. Hooks of different storages may fire from systems running on
+ * different workers, so collection is guarded by a mutex; an observer whose
+ * triggers never fire costs nothing.
+ */
+class ObserverHandler {
+ public:
+  explicit ObserverHandler(std::pmr::memory_resource* resource)
+      : entities_(resource), positions_(resource), draining_(resource) {}
+
+  ObserverHandler(const ObserverHandler&) = delete;
+  ObserverHandler& operator=(const ObserverHandler&) = delete;
+
+  /** @brief Returns the hook that adds its entity to the collection. */
+  IComponentStorage::Hook hook() { return {&OnTrigger, this}; }
+
+  /** @brief Adds the entity unless it was already collected. */
+  void Collect(EntityID entity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t index = GetEntityIndex(entity);
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kAbsent);
+    }
+    if (positions_[index] != kAbsent) {
+      // A stale generation in the same slot is replaced by the live one.
+      entities_[positions_[index]] = entity;
+      return;
+    }
+    positions_[index] = static_cast<uint32_t>(entities_.size());
+    entities_.push_back(entity);
+  }
+
+  /** @brief Returns the number of collected entities. */
+  size_t size() const { return entities_.size(); }
+
+  /** @brief Returns true if the entity was collected. */
+  bool Contains(EntityID entity) const {
+    const uint32_t index = GetEntityIndex(entity);
+    return index < positions_.size() && positions_[index] != kAbsent &&
+           entities_[positions_[index]] == entity;
+  }
+
+  /** @brief Returns the collected entities, in the order they first fired. */
+  std::span<const EntityID> entities() const { return entities_; }
+
+  /**
+   * @brief Empties the collection and returns what it held.
+   *
+   * The returned entities stay valid until the next Take(), so entities
+   * collected while they are processed land in the next batch.
+   */
+  std::span<const EntityID> Take() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    draining_.swap(entities_);
+    entities_.clear();
+    for (EntityID entity : draining_) {
+      positions_[GetEntityIndex(entity)] = kAbsent;
+    }
+    return draining_;
+  }
+
+  /** @brief Forgets every collected entity. */
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (EntityID entity : entities_) {
+      positions_[GetEntityIndex(entity)] = kAbsent;
+    }
+    entities_.clear();
+  }
+
+  /** @brief Forgets everything, e.g. after the storages were cleared. */
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entities_.clear();
+    positions_.clear();
+    draining_.clear();
+  }
+
+ private:
+  static constexpr uint32_t kAbsent = std::numeric_limits<uint32_t>::max();
+
+  static void OnTrigger(void* self, EntityID entity) {
+    static_cast<ObserverHandler*>(self)->Collect(entity);
+  }
+
+  std::mutex mutex_;
+  std::pmr::vector<EntityID> entities_;
+  /** @brief Position in `entities_` by entity slot, or kAbsent. */
+  std::pmr::vector<uint32_t> positions_;
+  /** @brief The batch handed out by the last Take(). */
+  std::pmr::vector<EntityID> draining_;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_OBSERVER_H_
@@ -0,0 +1,174 @@
+/**
+ * @file query.h
+ * @brief Persistent queries whose matching entities are kept up to date as
+ * components come and go.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_QUERY_H_
+#define INCLUDE_ENGINE_ECS_QUERY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/entity_manager.h>
+#include <engine/ecs/tag_storage.h>
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+/** @brief ID space for query handler types. */
+using QueryFamily = TypeFamily<struct QueryFamilyTag>;
+
+/**
+ * @brief Base interface for the bookkeeping of a query.
+ */
+class IQueryHandler {
+ public:
+  virtual ~IQueryHandler() = default;
+
+  /** @brief Forgets every match, e.g. after the storages were cleared. */
+  virtual void Reset() = 0;
+
+ protected:
+  IQueryHandler() = default;
+};
+
+template <typename ComponentList, typename ObservedList>
+class QueryHandler;
+
+/**
+ * @brief Keeps the set of entities that have every queried and observed
+ * component.
+ *
+ * The set is a dense array of entities plus a slot-indexed table of their
+ * positions in it. It is maintained through the storages' hooks: an entity
+ * that gains its last missing component is appended, and an entity about to
+ * lose one is swapped with the last match and dropped. Unlike a group, a
+ * query leaves the storages' order alone, so any number of queries can share
+ * a component type.
+ *
+ * @tparam Components The component types passed to Each().
+ * @tparam Observed Extra component types matches must have; they are not
+ * passed to Each(). Tags may be queried or observed.
+ */
+template <typename... Components, typename... Observed>
+class QueryHandler<std::tuple<Components...>, std::tuple<Observed...>> final
+    : public IQueryHandler {
+ public:
+  static_assert(sizeof...(Components) > 0,
+                "A query must have at least one component type.");
+
+  QueryHandler(std::tuple<StorageOf<Components>*...> storages,
+               std::tuple<StorageOf<Observed>*...> observed,
+               std::pmr::memory_resource* resource)
+      : storages_(storages),
+        observed_(observed),
+        entities_(resource),
+        positions_(resource) {
+    const IComponentStorage::Hook construct{&OnConstruct, this};
+    const IComponentStorage::Hook destroy{&OnDestroy, this};
+    auto attach = [construct, destroy](IComponentStorage* storage) {
+      storage->AddConstructHook(construct);
+      storage->AddDestroyHook(destroy);
+    };
+    (attach(std::get<StorageOf<Components>*>(storages_)), ...);
+    (attach(std::get<StorageOf<Observed>*>(observed_)), ...);
+  }
+
+  QueryHandler(const QueryHandler&) = delete;
+  QueryHandler& operator=(const QueryHandler&) = delete;
+
+  void Reset() override {
+    entities_.clear();
+    positions_.clear();
+  }
+
+  /** @brief Returns the number of matching entities. */
+  size_t size() const { return entities_.size(); }
+
+  /** @brief Returns true if the entity matches. */
+  bool Contains(EntityID entity) const {
+    const uint32_t index = GetEntityIndex(entity);
+    return index < positions_.size() && positions_[index] != kAbsent &&
+           entities_[positions_[index]] == entity;
+  }
+
+  /** @brief Returns the matching entities, in no particular order. */
+  std::span<const EntityID> entities() const { return entities_; }
+
+  /**
+   * @brief Adds the entity if it has every queried and observed component.
+   * Used to fill a new query from a view.
+   */
+  void Enter(EntityID entity) {
+    const bool complete =
+        (std::get<StorageOf<Components>*>(storages_)->Has(entity) && ...) &&
+        (std::get<StorageOf<Observed>*>(observed_)->Has(entity) && ...);
+    if (!complete || Contains(entity)) {
+      return;
+    }
+    const uint32_t index = GetEntityIndex(entity);
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kAbsent);
+    }
+    positions_[index] = static_cast<uint32_t>(entities_.size());
+    entities_.push_back(entity);
+  }
+
+  /**
+   * @brief Invokes `func(entity, components...)` for every match.
+   *
+   * The bound is re-read every step, so matches may be dropped by the
+   * callback; the match swapped into the dropped one's place is then
+   * skipped. Loops that run game callbacks should walk a copy of the matches
+   * instead.
+   */
+  template <typename Func>
+  void Each(Func& func) const {
+    for (size_t i = 0; i < entities_.size(); ++i) {
+      const EntityID entity = entities_[i];
+      func(entity,
+           std::get<StorageOf<Components>*>(storages_)->Get(entity)...);
+    }
+  }
+
+ private:
+  static constexpr uint32_t kAbsent = std::numeric_limits<uint32_t>::max();
+
+  static void OnConstruct(void* self, EntityID entity) {
+    static_cast<QueryHandler*>(self)->Enter(entity);
+  }
+
+  static void OnDestroy(void* self, EntityID entity) {
+    static_cast<QueryHandler*>(self)->Leave(entity);
+  }
+
+  void Leave(EntityID entity) {
+    if (!Contains(entity)) {
+      return;
+    }
+    const uint32_t index = GetEntityIndex(entity);
+    const uint32_t position = positions_[index];
+    const EntityID last = entities_.back();
+    entities_[position] = last;
+    positions_[GetEntityIndex(last)] = position;
+    entities_.pop_back();
+    positions_[index] = kAbsent;
+  }
+
+  std::tuple<StorageOf<Components>*...> storages_;
+  std::tuple<StorageOf<Observed>*...> observed_;
+  std::pmr::vector<EntityID> entities_;
+  /** @brief Position in `entities_` by entity slot, or kAbsent. */
+  std::pmr::vector<uint32_t> positions_;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_QUERY_H_
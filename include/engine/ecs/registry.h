@@ -7,79 +7,53 @@
 #define INCLUDE_ENGINE_ECS_REGISTRY_H_
 
 #include <algorithm>
-#include <functional>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
 #include <memory>
-#include <typeindex>
-#include <unordered_map>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <engine/core/job_system.h>
+#include <engine/ecs/archetype_storage.h>
+#include <engine/ecs/change_tick.h>
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/entity_command_buffer.h>
 #include <engine/ecs/entity_manager.h>
+#include <engine/ecs/events/event_dispatcher.h>
 #include <engine/ecs/events/events.h>
+#include <engine/ecs/group.h>
+#include <engine/ecs/observer.h>
+#include <engine/ecs/query.h>
+#include <engine/ecs/registry_stats.h>
+#include <engine/ecs/resource.h>
+#include <engine/ecs/tag_storage.h>
+#include <engine/ecs/type_family.h>
+#include <engine/util/logger.h>
 
 namespace engine::ecs {
 
-class Registry;
-
-/**
- * @brief Base interface for generic storage.
- */
-class IComponentStorage {
- public:
-  virtual ~IComponentStorage() = default;
-  virtual void Remove(EntityID entity) = 0;
-  virtual void Clear() = 0;
-  virtual bool Has(EntityID entity) = 0;
-  virtual void NotifyRemoved(EntityID entity, Registry* registry) = 0;
-
- protected:
-  IComponentStorage() = default;
-};
-
 /**
- * @brief Implementation of the interface for a given type.
+ * @brief Selects how a Registry lays out component data in memory.
  */
-template <typename T>
-class ComponentStorage : public IComponentStorage {
- public:
-  /**
-   * @brief Stores the component for the given entity.
-   * @param entity The entity to store the component on.
-   * @param component The component being added.
-   */
-  void Add(EntityID entity, T component) { data_[entity] = component; }
-
-  /**
-   * @brief Returns the component for the given entity.
-   * @returns the component.
-   */
-  T& Get(EntityID entity) { return data_.at(entity); }
-
-  /**
-   * @brief Removes the entity from this given storage.
-   * @param entity The entity to remove.
-   */
-  void Remove(EntityID entity) override { data_.erase(entity); }
-
-  /**
-   * @brief Returns if the entity is in the storage.
-   * @returns whether or not the entity is found in this storage.
-   */
-  bool Has(EntityID entity) override {
-    return data_.find(entity) != data_.end();
-  }
-
-  /**
-   * @brief Clears all components from this storage.
-   */
-  void Clear() override { data_.clear(); }
-
+enum class StorageMode {
+  /** @brief One sparse set per component type (the default). */
+  kSparseSet,
   /**
-   * @brief Triggers a notification that a component is being removed.
+   * @brief Entities grouped by component signature into 16 KB chunks with one
+   * column per component type.
    */
-  void NotifyRemoved(EntityID entity, Registry* registry) override;
-
- private:
-  std::unordered_map<EntityID, T> data_;
+  kArchetype,
 };
 
 /**
@@ -90,69 +64,44 @@ class ComponentStorage : public IComponentStorage {
  * high-level engine operations will interact with a `Registry` instance.
  */
 class Registry {
-  struct ListenerEntry {
-    void* listener;
-    bool one_shot;
-    std::function<void(const void*)> callback;
-  };
-
-  class IEventDispatcher {
-   public:
-    virtual ~IEventDispatcher() = default;
-    virtual void ProcessQueue() = 0;
-    virtual void Clear() = 0;
-  };
-
-  template <typename T>
-  class EventDispatcher : public IEventDispatcher {
-   public:
-    void Subscribe(events::IEventListener<T>* listener, bool one_shot) {
-      listeners_.push_back({listener, one_shot, [listener](const void* event) {
-                              listener->OnEvent(*static_cast<const T*>(event));
-                            }});
-    }
-
-    void Unsubscribe(events::IEventListener<T>* listener) {
-      listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
-                                      [listener](const ListenerEntry& entry) {
-                                        return entry.listener == listener;
-                                      }),
-                       listeners_.end());
-    }
-
-    void Publish(const T& event, bool immediate) {
-      if (immediate) {
-        for (auto it = listeners_.begin(); it != listeners_.end();) {
-          it->callback(&event);
-          if (it->one_shot) {
-            it = listeners_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-      } else {
-        queue_.push_back(event);
-      }
+ public:
+  /**
+   * @brief Creates a registry.
+   * @param mode The component storage layout used by this registry. Both
+   * layouts expose the same API, so the same scene can be benchmarked under
+   * either.
+   * @param resource Memory resource the sparse-set storages and the event
+   * listener lists and queues allocate from; must be thread-safe and outlive
+   * the registry. Passing an arena such as SceneArena keeps a scene's
+   * component memory together and lets it be released in one step.
+   */
+  explicit Registry(
+      StorageMode mode = StorageMode::kSparseSet,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : resource_(resource),
+        id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {
+    if (mode == StorageMode::kArchetype) {
+      archetypes_ = std::make_unique<ArchetypeStorage>();
     }
+  }
 
-    void ProcessQueue() override {
-      std::vector<T> current_queue = std::move(queue_);
-      for (const auto& event : current_queue) {
-        Publish(event, true);
-      }
-    }
+  /** @brief Returns the storage layout selected at construction. */
+  StorageMode storage_mode() const {
+    return archetypes_ ? StorageMode::kArchetype : StorageMode::kSparseSet;
+  }
 
-    void Clear() override {
-      listeners_.clear();
-      queue_.clear();
-    }
+  /** @brief Returns the memory resource selected at construction. */
+  std::pmr::memory_resource* resource() const { return resource_; }
 
-   private:
-    std::vector<ListenerEntry> listeners_;
-    std::vector<T> queue_;
-  };
+  /**
+   * @brief Returns an ID no other registry in this process has had.
+   *
+   * Unlike the registry's address, it is not reused when a registry is
+   * destroyed and another is created in its place, so systems can key
+   * per-registry caches on it.
+   */
+  uint64_t id() const { return id_; }
 
- public:
   /**
    * @brief Creates a new entity within this registry.
    *
@@ -162,11 +111,65 @@ class Registry {
    * @return The unique ID of the newly created entity.
    */
   EntityID CreateEntity() {
+    CheckStructuralChange("CreateEntity");
     EntityID entity = entity_manager_.CreateEntity();
     Publish<events::EntityCreatedEvent>({entity, this});
     return entity;
   }
 
+  /**
+   * @brief Creates `count` entities at once.
+   *
+   * The EntityCreatedEvents are published after all entities exist, and not
+   * constructed at all when nothing is subscribed.
+   *
+   * @return The new entities. Shorter than `count` if the entity slots ran
+   * out.
+   */
+  std::vector<EntityID> CreateEntities(size_t count) {
+    CheckStructuralChange("CreateEntities");
+    entity_manager_.Reserve(count);
+    std::vector<EntityID> entities;
+    entities.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      const EntityID entity = entity_manager_.CreateEntity();
+      if (entity == kInvalidEntity) {
+        break;
+      }
+      entities.push_back(entity);
+    }
+    if (HasSubscribers<events::EntityCreatedEvent>()) {
+      for (EntityID entity : entities) {
+        Publish<events::EntityCreatedEvent>({entity, this});
+      }
+    }
+    return entities;
+  }
+
+  /**
+   * @brief Preallocates room for `count` more entities.
+   */
+  void ReserveEntities(size_t count) { entity_manager_.Reserve(count); }
+
+  /**
+   * @brief Preallocates room for `count` more components of type T.
+   *
+   * Tags are indexed by entity slot, so for them this makes room for the
+   * existing slots plus `count` new ones. Has no effect in archetype mode,
+   * where chunks are allocated as needed.
+   */
+  template <typename T>
+  void Reserve(size_t count) {
+    if (!archetypes_) {
+      StorageOf<T>* storage = GetStorage<T>();
+      if constexpr (IsTag<T>::value) {
+        storage->Reserve(entity_manager_.next_id() + count);
+      } else {
+        storage->Reserve(storage->size() + count);
+      }
+    }
+  }
+
   /**
    * @brief Deletes an entity and all its associated components.
    *
@@ -174,19 +177,72 @@ class Registry {
    * entity, followed by an EntityDestroyedEvent, and finally release the
    * entity ID.
    *
+   * Deleting an entity that is not alive (including a stale handle to a
+   * reused slot) has no effect.
+   *
    * @param entity The ID of the entity to delete.
    */
   void DeleteEntity(EntityID entity) {
+    CheckStructuralChange("DeleteEntity");
+    if (!entity_manager_.IsAlive(entity)) {
+      return;
+    }
     Publish<events::EntityDestroyedEvent>({entity, this});
-    for (auto& [type, storage] : storages_) {
-      if (storage->Has(entity)) {
-        storage->NotifyRemoved(entity, this);
+    if (archetypes_) {
+      archetypes_->VisitComponents(
+          entity, [this, entity](const ComponentTypeInfo& info, void* data) {
+            info.notify_removed(entity, data, this);
+          });
+      archetypes_->RemoveEntity(entity);
+      entity_manager_.DestroyEntity(entity);
+      return;
+    }
+    NotifyComponentsRemoved(entity);
+    RemoveComponents(entity);
+    entity_manager_.DestroyEntity(entity);
+  }
+
+  /**
+   * @brief Deletes many entities at once.
+   *
+   * Publishes the same events as DeleteEntity() for each entity (skipping
+   * their construction when nothing is subscribed), then removes the
+   * components one storage at a time. Entities that are not alive are
+   * ignored, and an entity listed more than once is destroyed once.
+   */
+  void DestroyEntities(std::span<const EntityID> entities) {
+    CheckStructuralChange("DestroyEntities");
+    if (archetypes_) {
+      for (EntityID entity : entities) {
+        DeleteEntity(entity);
+      }
+      return;
+    }
+    // Nothing is destroyed until every event is out, so liveness alone does
+    // not catch duplicates.
+    EntityBitset seen;
+    std::vector<EntityID> doomed;
+    doomed.reserve(entities.size());
+    for (EntityID entity : entities) {
+      if (entity_manager_.IsAlive(entity) &&
+          seen.Set(GetEntityIndex(entity))) {
+        doomed.push_back(entity);
+      }
+    }
+    const bool notify_destroyed =
+        HasSubscribers<events::EntityDestroyedEvent>();
+    for (EntityID entity : doomed) {
+      if (notify_destroyed) {
+        Publish<events::EntityDestroyedEvent>({entity, this});
       }
+      NotifyComponentsRemoved(entity);
     }
-    for (auto& [type, storage] : storages_) {
-      storage->Remove(entity);
+    for (EntityID entity : doomed) {
+      RemoveComponents(entity);
+    }
+    for (EntityID entity : doomed) {
+      entity_manager_.DestroyEntity(entity);
     }
-    entity_manager_.DestroyEntity(entity);
   }
 
   /**
@@ -198,11 +254,21 @@ class Registry {
     return entity_manager_.IsAlive(entity);
   }
 
+  /**
+   * @brief Returns the live entity occupying a slot.
+   * @param index The slot index, as returned by GetEntityIndex().
+   * @returns The entity, or kInvalidEntity if the slot is free.
+   */
+  EntityID GetEntity(uint32_t index) const {
+    return entity_manager_.GetEntity(index);
+  }
+
   /**
    * @brief Attaches a component to an entity.
    *
    * If the entity already has a component of this type, it will be replaced.
-   * Triggers a ComponentAddedEvent.
+   * Triggers a ComponentAddedEvent. Adding to an entity that is not alive is
+   * rejected.
    *
    * @tparam T The type of the component.
    * @param entity The ID of the entity.
@@ -210,9 +276,96 @@ class Registry {
    */
   template <typename T>
   void AddComponent(EntityID entity, T component) {
-    GetStorage<T>()->Add(entity, component);
-    Publish<events::ComponentAddedEvent<T>>(
-        {entity, GetComponent<T>(entity), this});
+    CheckStructuralChange("AddComponent");
+    if (!entity_manager_.IsAlive(entity)) {
+      LOG_WARN("AddComponent called on dead entity %u.", entity);
+      return;
+    }
+    T& stored = InsertComponent<T>(entity, std::move(component));
+    Publish<events::ComponentAddedEvent<T>>({entity, stored, this});
+  }
+
+  /**
+   * @brief Constructs a component in place on an entity.
+   *
+   * Behaves like AddComponent(), but the component is built directly in its
+   * storage from `args`, so a component owning heap memory (strings,
+   * vectors) is constructed once instead of being moved or copied through
+   * the call. Aggregates are initialized from their members in order.
+   *
+   * Example:
+   * @code
+   * registry.EmplaceComponent<Sprite>(entity, "player.png");
+   * registry.EmplaceComponent<Polygon>(entity, std::move(vertices));
+   * @endcode
+   *
+   * @param entity The ID of the entity.
+   * @param args Constructor arguments, or the members of an aggregate.
+   * @return The stored component, or nullptr if the entity is not alive.
+   */
+  template <typename T, typename... Args>
+  T* EmplaceComponent(EntityID entity, Args&&... args) {
+    CheckStructuralChange("EmplaceComponent");
+    if (!entity_manager_.IsAlive(entity)) {
+      LOG_WARN("EmplaceComponent called on dead entity %u.", entity);
+      return nullptr;
+    }
+    T& stored = InsertComponent<T>(entity, std::forward<Args>(args)...);
+    Publish<events::ComponentAddedEvent<T>>({entity, stored, this});
+    return &stored;
+  }
+
+  /**
+   * @brief Returns the entity's component, constructing it in place from
+   * `args` first if the entity lacks one.
+   *
+   * The arguments are not used if the component exists, and no
+   * ComponentAddedEvent is published then.
+   *
+   * @return The component, or nullptr if the entity is not alive.
+   */
+  template <typename T, typename... Args>
+  T* GetOrEmplace(EntityID entity, Args&&... args) {
+    if (HasComponent<T>(entity)) {
+      return &GetComponent<T>(entity);
+    }
+    return EmplaceComponent<T>(entity, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Attaches one component to each of many entities.
+   *
+   * `components[i]` is moved onto `entities[i]`; existing components are
+   * replaced. Storage is reserved up front and the ComponentAddedEvents are
+   * published once every component is stored, or skipped entirely when
+   * nothing is subscribed. Entities that are not alive are skipped.
+   *
+   * @param entities The entities to attach to.
+   * @param components One component per entity; left moved-from.
+   */
+  template <typename T>
+  void InsertComponents(std::span<const EntityID> entities,
+                        std::span<T> components) {
+    CheckStructuralChange("InsertComponents");
+    if (entities.size() != components.size()) {
+      LOG_ERR("InsertComponents called with %zu entities and %zu components.",
+              entities.size(), components.size());
+      return;
+    }
+    Reserve<T>(entities.size());
+    for (size_t i = 0; i < entities.size(); ++i) {
+      if (entity_manager_.IsAlive(entities[i])) {
+        InsertComponent<T>(entities[i], std::move(components[i]));
+      }
+    }
+    if (HasSubscribers<events::ComponentAddedEvent<T>>()) {
+      for (EntityID entity : entities) {
+        if (HasComponent<T>(entity)) {
+          Publish<events::ComponentAddedEvent<T>>(
+              {entity, GetComponent<T>(entity), this});
+        }
+      }
+    }
   }
 
   /**
@@ -221,10 +374,15 @@ class Registry {
    */
   template <typename T>
   void RemoveComponent(EntityID entity) {
+    CheckStructuralChange("RemoveComponent");
     if (HasComponent<T>(entity)) {
       Publish<events::ComponentRemovedEvent<T>>(
           {entity, GetComponent<T>(entity), this});
-      GetStorage<T>()->Remove(entity);
+      if (archetypes_) {
+        archetypes_->Remove<T>(entity);
+      } else {
+        GetStorage<T>()->Remove(entity);
+      }
     }
   }
 
@@ -240,6 +398,9 @@ class Registry {
    */
   template <typename T>
   T& GetComponent(EntityID entity) {
+    if (archetypes_) {
+      return *archetypes_->Get<T>(entity);
+    }
     return GetStorage<T>()->Get(entity);
   }
 
@@ -250,125 +411,1208 @@ class Registry {
    */
   template <typename T>
   bool HasComponent(EntityID entity) {
-    return GetStorage<T>()->Has(entity);
+    if (archetypes_) {
+      return archetypes_->Has<T>(entity);
+    }
+    // The mask is keyed by slot, so a stale handle would see its successor's
+    // components.
+    return entity_manager_.IsAlive(entity) &&
+           entity_manager_.HasComponentBit(GetEntityIndex(entity),
+                                           ComponentTypeId<T>());
   }
 
   /**
    * @brief Represents a filtered subset of entities that possess a specific
    * set of component types.
    *
-   * Views are the primary way to iterate over entities in systems. They are
-   * lazy-evaluated upon creation.
+   * Views are the primary way to iterate over entities in systems. In
+   * sparse-set mode they do not allocate: iteration walks the dense entity
+   * array of the smallest participating storage and tests each entity's
+   * component mask (see EntityManager) against the viewed types, so the cost
+   * is proportional to the rarest component rather than to the total number
+   * of entities, and each test is a word AND rather than a storage probe per
+   * type. In archetype mode the view collects the matching archetypes once and
+   * walks their rows, which need no probing at all.
+   *
+   * Tag components (see IsTag) have mask bits like any other component. A
+   * view whose rarest component is a tag is driven by a scan of that tag's
+   * bitset, which skips 64 untagged entity slots per word.
+   *
+   * Views may additionally be narrowed with With<T>, Without<T>, Changed<T>
+   * and Added<T> filters (see GetView()). Archetype registries do not track
+   * change ticks, so there the Changed and Added filters match every entity.
+   *
+   * @note Adding components to the viewed storages while iterating is safe in
+   * sparse-set mode, but removing the entity currently being visited may cause
+   * the entity that is swapped into its place to be skipped. In archetype mode
+   * any structural change invalidates the view.
    *
    * @tparam Components The pack of component types to filter for.
    */
   template <typename... Components>
   class View {
    public:
+    /** @brief Forward iterator yielding the ID of each matching entity. */
+    class Iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = EntityID;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const EntityID*;
+      using reference = EntityID;
+
+      Iterator() = default;
+      Iterator(const View* view, size_t pos) : view_(view), pos_(pos) {
+        SkipMismatches();
+      }
+
+      EntityID operator*() const {
+        if (!view_->archetypes_.empty()) {
+          return view_->archetypes_[archetype_]->EntityAt(
+              static_cast<uint32_t>(pos_));
+        }
+        return view_->CandidateAt(pos_);
+      }
+
+      Iterator& operator++() {
+        ++pos_;
+        SkipMismatches();
+        return *this;
+      }
+
+      Iterator operator++(int) {
+        Iterator copy = *this;
+        ++(*this);
+        return copy;
+      }
+
+      bool operator==(const Iterator& other) const {
+        const bool done = AtEnd();
+        const bool other_done = other.AtEnd();
+        return done == other_done &&
+               (done || (archetype_ == other.archetype_ && pos_ == other.pos_));
+      }
+
+      bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+     private:
+      bool AtEnd() const {
+        if (!view_) {
+          return true;
+        }
+        if (!view_->archetypes_.empty()) {
+          return archetype_ >= view_->archetypes_.size();
+        }
+        return pos_ >= view_->candidate_end();
+      }
+
+      void SkipMismatches() {
+        if (view_ && !view_->archetypes_.empty()) {
+          while (archetype_ < view_->archetypes_.size() &&
+                 pos_ >= view_->archetypes_[archetype_]->size()) {
+            ++archetype_;
+            pos_ = 0;
+          }
+          return;
+        }
+        while (!AtEnd()) {
+          pos_ = view_->NextCandidate(pos_);
+          if (AtEnd() || view_->MatchesCandidate(view_->CandidateAt(pos_))) {
+            return;
+          }
+          ++pos_;
+        }
+      }
+
+      const View* view_ = nullptr;
+      size_t archetype_ = 0;
+      size_t pos_ = 0;
+    };
+
     View(Registry* registry) : registry_(registry) {
       if (!registry_) {
         return;
       }
-      for (EntityID entity = 0; entity < registry_->entity_manager_.next_id();
-           ++entity) {
-        if (registry_->entity_manager_.IsAlive(entity) &&
-            (registry_->HasComponent<Components>(entity) && ...)) {
-          entities_.push_back(entity);
+      if (registry_->archetypes_) {
+        ArchetypeStorage& archetypes = *registry_->archetypes_;
+        archetypes.CollectMatching({archetypes.TypeId<Components>()...},
+                                   &archetypes_);
+        return;
+      }
+      storages_ = {registry_->GetStorage<Components>()...};
+      (Require(ComponentTypeId<Components>()), ...);
+      // Drive iteration from the storage that is cheapest to walk.
+      size_t cheapest = std::numeric_limits<size_t>::max();
+      (ConsiderDriver<Components>(&cheapest), ...);
+      // Candidates come from the driver, so its own bit needs no test.
+      const MaskTerm driver = ToMaskTerm(driver_type_);
+      for (uint32_t i = 0; i < required_count_; ++i) {
+        MaskTerm term = required_[i];
+        if (term.word == driver.word) {
+          term.bits &= ~driver.bits;
         }
+        if (term.bits != 0) {
+          candidate_[candidate_count_++] = term;
+        }
+      }
+    }
+
+    /** @brief Creates a view narrowed by filters; see GetView(). */
+    template <typename... Filters>
+    View(Registry* registry, const Filters&... filters) : View(registry) {
+      if (!registry_) {
+        return;
+      }
+      if (registry_->archetypes_) {
+        (FilterArchetypes(filters), ...);
+      } else {
+        (AddFilter(filters), ...);
       }
     }
 
     View() : registry_(nullptr) {}
 
+    /**
+     * @brief Returns true if the entity has every component of the view.
+     * @param entity The entity to test.
+     */
+    bool Contains(EntityID entity) const {
+      if (!registry_) {
+        return false;
+      }
+      if (registry_->archetypes_) {
+        return (registry_->archetypes_->Has<Components>(entity) && ...);
+      }
+      return registry_->entity_manager_.IsAlive(entity) &&
+             Matches(entity, required_, required_count_);
+    }
+
+    /**
+     * @brief Invokes `func(entity, components...)` for each matching entity.
+     *
+     * Components are fetched straight from the storages the view already
+     * holds, avoiding a second round of registry lookups. In archetype mode the
+     * component columns of each chunk are walked in lockstep.
+     */
+    template <typename Func>
+    void Each(Func&& func) {
+      if (!archetypes_.empty()) {
+        ArchetypeStorage& storage = *registry_->archetypes_;
+        for (Archetype* archetype : archetypes_) {
+          const int columns[] = {
+              archetype->ColumnOf(storage.TypeId<Components>())...};
+          for (size_t chunk = 0; chunk < archetype->chunk_count(); ++chunk) {
+            const EntityID* entities = archetype->ChunkEntities(chunk);
+            const size_t count = archetype->ChunkRowCount(chunk);
+            EachInChunk(func, archetype, chunk, entities, count, columns,
+                        std::index_sequence_for<Components...>{});
+          }
+        }
+        return;
+      }
+      for (EntityID entity : *this) {
+        func(entity,
+             std::get<StorageOf<Components>*>(storages_)->Get(entity)...);
+      }
+    }
+
+    /**
+     * @brief Returns the number of candidate positions the view walks.
+     *
+     * In sparse-set mode this is the size of the driving storage, or the
+     * number of slots its bitset spans for a tag, so some positions may not
+     * match. In archetype mode every position matches.
+     */
+    size_t size_hint() const {
+      if (!archetypes_.empty()) {
+        size_t total = 0;
+        for (const Archetype* archetype : archetypes_) {
+          total += archetype->size();
+        }
+        return total;
+      }
+      return candidate_end();
+    }
+
+    /**
+     * @brief Invokes `func(entity, components...)` for the matching entities
+     * among candidate positions `[begin, end)`.
+     *
+     * Disjoint ranges touch disjoint entities and only read the storages, so
+     * they may be processed concurrently as long as the registry is not
+     * structurally modified meanwhile.
+     */
+    template <typename Func>
+    void EachInRange(size_t begin, size_t end, Func&& func) const {
+      if (!archetypes_.empty()) {
+        ArchetypeStorage& storage = *registry_->archetypes_;
+        size_t offset = 0;
+        for (Archetype* archetype : archetypes_) {
+          const size_t size = archetype->size();
+          if (begin < offset + size && end > offset) {
+            const int columns[] = {
+                archetype->ColumnOf(storage.TypeId<Components>())...};
+            const size_t last = std::min(end, offset + size) - offset;
+            for (size_t row = std::max(begin, offset) - offset; row < last;
+                 ++row) {
+              EachInRow(func, archetype, static_cast<uint32_t>(row), columns,
+                        std::index_sequence_for<Components...>{});
+            }
+          }
+          offset += size;
+        }
+        return;
+      }
+      end = std::min(end, candidate_end());
+      for (size_t pos = NextCandidate(begin); pos < end;
+           pos = NextCandidate(pos + 1)) {
+        const EntityID entity = CandidateAt(pos);
+        if (MatchesCandidate(entity)) {
+          func(entity,
+               std::get<StorageOf<Components>*>(storages_)->Get(entity)...);
+        }
+      }
+    }
+
     template <typename Func>
     std::vector<EntityID> Filter(Func&& predicate) {
       std::vector<EntityID> result;
-      if (!registry_) {
-        return result;
-      }
-      for (auto entity : entities_) {
-        if (registry_->entity_manager_.IsAlive(entity) &&
-            (registry_->HasComponent<Components>(entity) && ...) &&
-            predicate(registry_->GetComponent<Components>(entity)...)) {
+      for (EntityID entity : *this) {
+        if (predicate(registry_->GetComponent<Components>(entity)...)) {
           result.push_back(entity);
         }
       }
       return result;
     }
 
-    auto begin() { return entities_.begin(); }
-    auto end() { return entities_.end(); }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(); }
 
    private:
-    Registry* registry_;
-    std::vector<EntityID> entities_;
-  };
+    /** @brief A With, Without, Changed or Added filter bound to its storage. */
+    struct EntityFilter {
+      void* storage;
+      bool (*matches)(void* storage, EntityID entity, uint32_t since);
+      uint32_t since;
+    };
 
-  template <typename... Components>
-  View<Components...> GetView() {
-    return View<Components...>(this);
-  }
+    /**
+     * @brief Makes T's storage the driver if it is cheaper to walk than the
+     * current one: its size for sparse sets, and for tags the words to scan
+     * plus the tagged entities to test.
+     */
+    template <typename T>
+    void ConsiderDriver(size_t* cheapest) {
+      StorageOf<T>* storage = std::get<StorageOf<T>*>(storages_);
+      if constexpr (IsTag<T>::value) {
+        const size_t cost = storage->bits().words().size() + storage->size();
+        if (cost < *cheapest) {
+          *cheapest = cost;
+          tag_driver_ = &storage->bits();
+          driver_ = nullptr;
+          driver_type_ = ComponentTypeId<T>();
+        }
+      } else if (storage->size() < *cheapest) {
+        *cheapest = storage->size();
+        driver_ = &storage->entities();
+        tag_driver_ = nullptr;
+        driver_type_ = ComponentTypeId<T>();
+      }
+    }
 
-  /**
-   * @brief Executes a function for every entity that matches the given
-   * component requirements.
-   *
-   * This is a convenience wrapper around creating a View and iterating over it.
-   * The function should accept references to each of the requested component
-   * types.
-   *
-   * Example:
-   * @code
-   * registry.ForEach<Transform, Sprite>([](Transform& t, Sprite& s) {
-   *     // Update logic
-   * });
-   * @endcode
-   *
-   * @tparam Components The component types to filter for.
-   * @tparam Func The type of the callback function.
-   * @param func The callback function to execute.
-   */
-  template <typename... Components, typename Func>
-  void ForEach(Func&& func) {
-    auto view = GetView<Components...>();
-    for (auto entity : view) {
-      if (entity_manager_.IsAlive(entity) &&
-          (HasComponent<Components>(entity) && ...)) {
-        func(GetComponent<Components>(entity)...);
+    /** @brief Returns one past the last candidate position. */
+    size_t candidate_end() const {
+      if (tag_driver_) {
+        return tag_driver_->end();
       }
+      return driver_ ? driver_->size() : 0;
     }
-  }
 
-  /**
-   * @brief Subscribes a listener to events of type T.
-   * @param listener The listener to subscribe.
-   * @param one_shot If true, the listener will be automatically unsubscribed
-   * after one event.
-   */
-  template <typename T>
-  void Subscribe(events::IEventListener<T>* listener, bool one_shot = false) {
-    GetDispatcher<T>()->Subscribe(listener, one_shot);
-  }
+    /** @brief Returns the first position at or after `pos` that may match. */
+    size_t NextCandidate(size_t pos) const {
+      return tag_driver_ ? tag_driver_->NextSet(pos) : pos;
+    }
 
-  /**
-   * @brief Unsubscribes a listener from events of type T.
-   * @param listener The listener to unsubscribe.
-   */
-  template <typename T>
-  void Unsubscribe(events::IEventListener<T>* listener) {
-    GetDispatcher<T>()->Unsubscribe(listener);
-  }
+    /** @brief Returns the entity at a position returned by NextCandidate(). */
+    EntityID CandidateAt(size_t pos) const {
+      if (tag_driver_) {
+        // Tags are cleared on destruction, so a set bit names a live slot.
+        return registry_->entity_manager_.GetEntity(
+            static_cast<uint32_t>(pos));
+      }
+      return (*driver_)[pos];
+    }
 
-  /**
-   * @brief Publishes an event of type T.
-   * @param event The event data.
-   * @param immediate If true, listeners are notified immediately. If false, the
-   * event is queued for the next Update() call.
-   */
-  template <typename T>
-  void Publish(const T& event, bool immediate = true) {
-    GetDispatcher<T>()->Publish(event, immediate);
-  }
+    /** @brief Bits of one word of the entity component mask. */
+    struct MaskTerm {
+      uint32_t word;
+      uint64_t bits;
+    };
+
+    using MaskTerms = std::array<MaskTerm, sizeof...(Components)>;
+
+    /**
+     * @brief Tests an entity against mask terms, the With and Without bits
+     * and the tick filters; the entity must be alive.
+     */
+    bool Matches(EntityID entity, const MaskTerms& terms,
+                 uint32_t count) const {
+      if (count > 0 || !included_.empty() || !excluded_.empty()) {
+        const uint64_t* mask =
+            registry_->entity_manager_.ComponentMask(GetEntityIndex(entity));
+        for (uint32_t i = 0; i < count; ++i) {
+          if ((mask[terms[i].word] & terms[i].bits) != terms[i].bits) {
+            return false;
+          }
+        }
+        for (const MaskTerm& term : included_) {
+          if ((mask[term.word] & term.bits) == 0) {
+            return false;
+          }
+        }
+        for (const MaskTerm& term : excluded_) {
+          if ((mask[term.word] & term.bits) != 0) {
+            return false;
+          }
+        }
+      }
+      for (const EntityFilter& filter : filters_) {
+        if (!filter.matches(filter.storage, entity, filter.since)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /** @brief Tests an entity taken from the driver. */
+    bool MatchesCandidate(EntityID entity) const {
+      return Matches(entity, candidate_, candidate_count_);
+    }
+
+    /** @brief Adds a component type every match must have. */
+    void Require(uint32_t type) {
+      const MaskTerm term = ToMaskTerm(type);
+      for (uint32_t i = 0; i < required_count_; ++i) {
+        if (required_[i].word == term.word) {
+          required_[i].bits |= term.bits;
+          return;
+        }
+      }
+      required_[required_count_++] = term;
+    }
+
+    static MaskTerm ToMaskTerm(uint32_t type) {
+      return {static_cast<uint32_t>(type / EntityManager::kMaskWordBits),
+              uint64_t{1} << (type % EntityManager::kMaskWordBits)};
+    }
+
+    template <typename... Ts>
+    void AddFilter(const With<Ts...>&) {
+      (registry_->GetStorage<Ts>(), ...);
+      (included_.push_back(ToMaskTerm(ComponentTypeId<Ts>())), ...);
+    }
+
+    template <typename... Ts>
+    void AddFilter(const Without<Ts...>&) {
+      (registry_->GetStorage<Ts>(), ...);
+      (excluded_.push_back(ToMaskTerm(ComponentTypeId<Ts>())), ...);
+    }
+
+    template <typename T>
+    void AddFilter(const Changed<T>& filter) {
+      static_assert(!IsTag<T>::value, "Tags have no change ticks.");
+      filters_.push_back(
+          {registry_->GetStorage<T>(),
+           [](void* storage, EntityID entity, uint32_t since) {
+             auto* typed = static_cast<ComponentStorage<T>*>(storage);
+             return typed->Has(entity) && typed->changed_tick(entity) > since;
+           },
+           filter.since});
+    }
+
+    template <typename T>
+    void AddFilter(const Added<T>& filter) {
+      static_assert(!IsTag<T>::value, "Tags have no change ticks.");
+      filters_.push_back(
+          {registry_->GetStorage<T>(),
+           [](void* storage, EntityID entity, uint32_t since) {
+             auto* typed = static_cast<ComponentStorage<T>*>(storage);
+             return typed->Has(entity) && typed->added_tick(entity) > since;
+           },
+           filter.since});
+    }
+
+    /** @brief Applies With and Without filters to the matched archetypes. */
+    template <typename... Ts>
+    void FilterArchetypes(const With<Ts...>&) {
+      ArchetypeStorage& storage = *registry_->archetypes_;
+      std::erase_if(archetypes_, [&storage](const Archetype* archetype) {
+        return ((archetype->ColumnOf(storage.TypeId<Ts>()) < 0) || ...);
+      });
+    }
+
+    template <typename... Ts>
+    void FilterArchetypes(const Without<Ts...>&) {
+      ArchetypeStorage& storage = *registry_->archetypes_;
+      std::erase_if(archetypes_, [&storage](const Archetype* archetype) {
+        return ((archetype->ColumnOf(storage.TypeId<Ts>()) >= 0) || ...);
+      });
+    }
+
+    template <typename Filter>
+    void FilterArchetypes(const Filter&) {}
+
+    template <typename Func, size_t... Is>
+    static void EachInChunk(Func& func, Archetype* archetype, size_t chunk,
+                            const EntityID* entities, size_t count,
+                            const int* columns, std::index_sequence<Is...>) {
+      std::tuple<Components*...> data{static_cast<Components*>(
+          archetype->ChunkColumn(chunk, columns[Is]))...};
+      for (size_t row = 0; row < count; ++row) {
+        func(entities[row], std::get<Is>(data)[row]...);
+      }
+    }
+
+    template <typename Func, size_t... Is>
+    static void EachInRow(Func& func, Archetype* archetype, uint32_t row,
+                          const int* columns, std::index_sequence<Is...>) {
+      func(archetype->EntityAt(row),
+           *static_cast<Components*>(
+               archetype->ComponentAt(row, columns[Is]))...);
+    }
+
+    Registry* registry_;
+    std::tuple<StorageOf<Components>*...> storages_;
+    /** @brief Entity array iteration walks, unless `tag_driver_` is set. */
+    const std::pmr::vector<EntityID>* driver_ = nullptr;
+    /** @brief Bitset whose set slots iteration walks instead. */
+    const EntityBitset* tag_driver_ = nullptr;
+    /**
+     * @brief Mask words of the viewed types, merged per word, so matching
+     * tests one word per 64 component types instead of probing storages.
+     */
+    MaskTerms required_{};
+    uint32_t required_count_ = 0;
+    /** @brief `required_` without the driver's bit, which candidates have. */
+    MaskTerms candidate_{};
+    uint32_t candidate_count_ = 0;
+    uint32_t driver_type_ = 0;
+    /** @brief Bits of With types; each must be set. */
+    std::vector<MaskTerm> included_;
+    /** @brief Bits of Without types; each must be clear. */
+    std::vector<MaskTerm> excluded_;
+    std::vector<Archetype*> archetypes_;
+    std::vector<EntityFilter> filters_;
+  };
+
+  /**
+   * @brief Returns a view over the entities that have every component type.
+   *
+   * With<T...> and Without<T...> filters narrow the view to entities that
+   * have, or lack, every listed type without passing those components to the
+   * callback, which suits tags. Changed<T> and Added<T> filters narrow it to
+   * entities whose T was changed or added after the filter's tick; they do
+   * not apply to tags. T need not be one of the viewed types. Components are
+   * stamped when added and by PatchComponent() or MarkChanged(); writes
+   * through a plain reference are not tracked.
+   *
+   * Example:
+   * @code
+   * registry.GetView<Transform, Light>(Changed<Transform>{}, Added<Light>{});
+   * registry.GetView<Transform>(With<Enemy>{}, Without<Downed>{});
+   * @endcode
+   */
+  template <typename... Components, typename... Filters>
+  View<Components...> GetView(const Filters&... filters) {
+    return View<Components...>(this, filters...);
+  }
+
+  /**
+   * @brief Handle to an owning group; see GetGroup().
+   */
+  template <typename OwnedList, typename ObservedList>
+  class Group;
+
+  template <typename... Owned, typename... Observed>
+  class Group<std::tuple<Owned...>, std::tuple<Observed...>> {
+   public:
+    using Handler = GroupHandler<std::tuple<Owned...>, std::tuple<Observed...>>;
+
+    Group(Registry* registry, Handler* handler)
+        : registry_(registry), handler_(handler) {}
+
+    /** @brief Returns the number of entities in the group. */
+    size_t size() const {
+      if (handler_) {
+        return handler_->size();
+      }
+      return registry_ ? registry_->GetView<Owned..., Observed...>().size_hint()
+                       : 0;
+    }
+
+    /** @brief Returns true if the group has no entities. */
+    bool empty() const { return size() == 0; }
+
+    /** @brief Returns true if the entity is in the group. */
+    bool Contains(EntityID entity) const {
+      if (handler_) {
+        return handler_->Contains(entity);
+      }
+      return registry_ &&
+             registry_->GetView<Owned..., Observed...>().Contains(entity);
+    }
+
+    /**
+     * @brief Invokes `func(entity, owned..., observed...)` for each entity.
+     *
+     * In sparse-set mode this is an indexed loop over the packed prefix of the
+     * owned storages. Members must not gain or lose grouped components while
+     * the loop runs.
+     */
+    template <typename Func>
+    void Each(Func&& func) {
+      if (handler_) {
+        handler_->Each(func);
+      } else if (registry_) {
+        registry_->GetView<Owned..., Observed...>().Each(func);
+      }
+    }
+
+    /**
+     * @brief Returns the members, or nullptr if the group iterates a View.
+     *
+     * `entities()[i]` owns `data<T>()[i]` for every owned type T, for
+     * `i < size()`.
+     */
+    const EntityID* entities() const {
+      return handler_ ? handler_->entities() : nullptr;
+    }
+
+    /** @brief Returns the packed array of an owned type, or nullptr. */
+    template <typename T>
+    T* data() const {
+      return handler_ ? handler_->template data<T>() : nullptr;
+    }
+
+   private:
+    Registry* registry_;
+    Handler* handler_;
+  };
+
+  /**
+   * @brief Returns the owning group of the given component types, creating it
+   * on first use.
+   *
+   * The group sorts the storages of `Owned` so their first size() entries all
+   * belong to the same entities, in the same order; iterating it needs no
+   * lookups for owned types. Observed types (passed as `With<...>{}`) are
+   * required but looked up per entity. The order is kept up to date as
+   * components come and go, which makes adding and removing owned or
+   * observed components slightly more expensive. Creating a group reorders
+   * the owned storages, so it counts as a write to them.
+   *
+   * A storage can be owned by only one group. Requesting a group that owns a
+   * type already owned by a different group is a bug: it aborts in debug
+   * builds, and otherwise logs an error and returns a group that iterates a
+   * View, so the caller keeps working, only without the packed order.
+   * Requesting the same group again returns the existing one. In archetype
+   * mode, where components sharing an entity are already stored together,
+   * the group simply iterates a View too.
+   *
+   * Example:
+   * @code
+   * registry.GetGroup<Transform, Velocity>().Each(
+   *     [dt](EntityID, Transform& t, Velocity& v) { t.x += v.x * dt; });
+   * registry.GetGroup<Sprite>(With<Transform>{});
+   * @endcode
+   */
+  template <typename... Owned, typename... Observed>
+  Group<std::tuple<Owned...>, std::tuple<Observed...>> GetGroup(
+      With<Observed...> = {}) {
+    using Result = Group<std::tuple<Owned...>, std::tuple<Observed...>>;
+    using Handler = typename Result::Handler;
+    if (archetypes_) {
+      return Result(this, nullptr);
+    }
+    static_assert(!(IsTag<Owned>::value || ...),
+                  "Tags have no dense arrays for a group to own.");
+    std::tuple<ComponentStorage<Owned>*...> owned{GetStorage<Owned>()...};
+    std::tuple<StorageOf<Observed>*...> observed{GetStorage<Observed>()...};
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    IGroupHandler* existing = std::get<0>(owned)->owner();
+    if (auto* handler = dynamic_cast<Handler*>(existing)) {
+      return Result(this, handler);
+    }
+    if (((std::get<ComponentStorage<Owned>*>(owned)->owner() != nullptr) ||
+         ...)) {
+      LOG_ERR("GetGroup: a component type is already owned by another group.");
+#ifndef NDEBUG
+      std::abort();
+#endif
+      return Result(this, nullptr);
+    }
+    groups_.push_back(std::make_unique<Handler>(owned, observed));
+    return Result(this, static_cast<Handler*>(groups_.back().get()));
+  }
+
+  /**
+   * @brief Handle to a persistent query; see GetQuery().
+   */
+  template <typename ComponentList, typename ObservedList>
+  class Query;
+
+  template <typename... Components, typename... Observed>
+  class Query<std::tuple<Components...>, std::tuple<Observed...>> {
+   public:
+    using Handler =
+        QueryHandler<std::tuple<Components...>, std::tuple<Observed...>>;
+
+    Query(Registry* registry, Handler* handler)
+        : registry_(registry), handler_(handler) {}
+
+    /** @brief Returns the number of matching entities. */
+    size_t size() const {
+      if (handler_) {
+        return handler_->size();
+      }
+      return registry_
+                 ? registry_->GetView<Components..., Observed...>().size_hint()
+                 : 0;
+    }
+
+    /** @brief Returns true if no entity matches. */
+    bool empty() const { return size() == 0; }
+
+    /** @brief Returns true if the entity matches. */
+    bool Contains(EntityID entity) const {
+      if (handler_) {
+        return handler_->Contains(entity);
+      }
+      return registry_ &&
+             registry_->GetView<Components..., Observed...>().Contains(entity);
+    }
+
+    /**
+     * @brief Invokes `func(entity, components...)` for each matching entity.
+     *
+     * In sparse-set mode this walks the query's own entity array and probes
+     * nothing but the storages of the passed components.
+     */
+    template <typename Func>
+    void Each(Func&& func) {
+      if (handler_) {
+        handler_->Each(func);
+      } else if (registry_) {
+        registry_->GetView<Components...>(With<Observed...>{}).Each(func);
+      }
+    }
+
+    /** @brief Returns the matching entities; empty in archetype mode. */
+    std::span<const EntityID> entities() const {
+      return handler_ ? handler_->entities() : std::span<const EntityID>();
+    }
+
+   private:
+    Registry* registry_;
+    Handler* handler_;
+  };
+
+  /**
+   * @brief Returns the persistent query of the given component types,
+   * creating it on first use.
+   *
+   * A query holds the entities that have every type in `Components` and
+   * every observed type (passed as `With<...>{}`), and keeps that set up to
+   * date as components are added and removed, so iterating it does no
+   * filtering and its size() is exact. It suits systems that walk the same
+   * rarely changing set every frame. The first call fills the query from a
+   * view; later calls with the same types return the same query, which lives
+   * as long as the registry. Every add or remove of a queried type pays a
+   * small bookkeeping cost per query.
+   *
+   * Unlike groups, queries do not reorder storages, so any number of them
+   * may share types. In archetype mode the query simply iterates a View.
+   *
+   * Example:
+   * @code
+   * registry.GetQuery<CameraComponent, Transform>().Each(
+   *     [](EntityID, CameraComponent& camera, Transform& transform) {});
+   * registry.GetQuery<Transform>(With<Enemy>{}).size();
+   * @endcode
+   */
+  template <typename... Components, typename... Observed>
+  Query<std::tuple<Components...>, std::tuple<Observed...>> GetQuery(
+      With<Observed...> = {}) {
+    using Result = Query<std::tuple<Components...>, std::tuple<Observed...>>;
+    using Handler = typename Result::Handler;
+    if (archetypes_) {
+      return Result(this, nullptr);
+    }
+    const uint32_t id = QueryFamily::Id<Handler>();
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    if (id >= queries_.size()) {
+      queries_.resize(id + 1);
+    }
+    std::unique_ptr<IQueryHandler>& query = queries_[id];
+    if (!query) {
+      auto handler = std::make_unique<Handler>(
+          std::tuple<StorageOf<Components>*...>{GetStorage<Components>()...},
+          std::tuple<StorageOf<Observed>*...>{GetStorage<Observed>()...},
+          resource_);
+      for (EntityID entity : GetView<Components..., Observed...>()) {
+        handler->Enter(entity);
+      }
+      query = std::move(handler);
+    }
+    return Result(this, static_cast<Handler*>(query.get()));
+  }
+
+  /**
+   * @brief Handle to a reactive observer; see GetObserver().
+   */
+  template <typename... Triggers>
+  class Observer {
+   public:
+    Observer(Registry* registry, ObserverHandler* handler)
+        : registry_(registry), handler_(handler) {}
+
+    /**
+     * @brief Returns the number of collected entities. In archetype mode,
+     * where nothing is collected, this is an upper bound of the entities
+     * Drain() visits.
+     */
+    size_t size() const {
+      if (handler_) {
+        return handler_->size();
+      }
+      if (!registry_) {
+        return 0;
+      }
+      return (registry_->GetView<TriggerComponent<Triggers>>().size_hint() +
+              ...);
+    }
+
+    /** @brief Returns true if nothing fired since the last drain. */
+    bool empty() const { return size() == 0; }
+
+    /** @brief Returns true if the entity was collected. */
+    bool Contains(EntityID entity) const {
+      return handler_ && handler_->Contains(entity);
+    }
+
+    /** @brief Returns the collected entities; empty in archetype mode. */
+    std::span<const EntityID> entities() const {
+      return handler_ ? handler_->entities() : std::span<const EntityID>();
+    }
+
+    /**
+     * @brief Invokes `func(entity)` once for every collected entity that is
+     * still alive, then empties the collection.
+     *
+     * Entities keep firing while `func` runs; those land in the next batch.
+     * The entity may have lost the triggering component since, so `func`
+     * should check for the components it uses. In archetype mode, which
+     * keeps no change ticks, every entity with a trigger's component is
+     * visited, as Changed and Added filters match every entity there.
+     */
+    template <typename Func>
+    void Drain(Func&& func) {
+      if (handler_) {
+        for (EntityID entity : handler_->Take()) {
+          if (registry_->IsAlive(entity)) {
+            func(entity);
+          }
+        }
+        return;
+      }
+      if (!registry_) {
+        return;
+      }
+      std::vector<EntityID> entities;
+      auto collect = [&entities](EntityID entity, auto&&...) {
+        entities.push_back(entity);
+      };
+      (registry_->GetView<TriggerComponent<Triggers>>().Each(collect), ...);
+      std::sort(entities.begin(), entities.end());
+      entities.erase(std::unique(entities.begin(), entities.end()),
+                     entities.end());
+      for (EntityID entity : entities) {
+        func(entity);
+      }
+    }
+
+    /** @brief Forgets every collected entity without visiting it. */
+    void Clear() {
+      if (handler_) {
+        handler_->Clear();
+      }
+    }
+
+   private:
+    Registry* registry_;
+    ObserverHandler* handler_;
+  };
+
+  /**
+   * @brief Returns the reactive observer of the given triggers, creating it
+   * on first use.
+   *
+   * An observer collects the entities that fire any of its triggers,
+   * OnAdded<T> or OnChanged<T>, between two Drain() calls, each entity once.
+   * A system that drains it every run then touches only what changed since
+   * its last run instead of filtering every entity by change tick, and when
+   * nothing changed there is nothing to visit. Collection starts with the
+   * first call, so the consumer should treat entities that existed before
+   * as new. Later calls with the same triggers return the same observer,
+   * which lives as long as the registry; give each consuming system its own
+   * trigger list. Every firing pays a small bookkeeping cost per observer.
+   *
+   * OnChanged fires for PatchComponent(), MarkChanged() and replacing
+   * AddComponent() calls; writes through a plain reference go unnoticed.
+   * Tags have no change ticks, so they only support OnAdded.
+   *
+   * Example:
+   * @code
+   * registry.GetObserver<OnAdded<Collider>, OnChanged<Transform>>().Drain(
+   *     [&](EntityID entity) { broadphase.Update(entity); });
+   * @endcode
+   */
+  template <typename... Triggers>
+  Observer<Triggers...> GetObserver() {
+    static_assert(sizeof...(Triggers) > 0,
+                  "An observer must have at least one trigger.");
+    using Result = Observer<Triggers...>;
+    if (archetypes_) {
+      return Result(this, nullptr);
+    }
+    const uint32_t id = ObserverFamily::Id<Result>();
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    if (id >= observers_.size()) {
+      observers_.resize(id + 1);
+    }
+    std::unique_ptr<ObserverHandler>& observer = observers_[id];
+    if (!observer) {
+      observer = std::make_unique<ObserverHandler>(resource_);
+      (ObserverTrigger<Triggers>::Attach(
+           GetStorage<TriggerComponent<Triggers>>(), observer->hook()),
+       ...);
+    }
+    return Result(this, observer.get());
+  }
+
+  /**
+   * @brief Sorts the dense arrays of a component storage by `compare`, so
+   * views driven by the type and groups owning it visit entities in that
+   * order.
+   *
+   * The sort is stable. If the storage is owned by a group, the members are
+   * sorted among themselves, moving every owned storage in lockstep, and the
+   * non-members behind them are sorted separately. Entries move together
+   * with their change ticks, so sorting marks nothing as changed. Tags have
+   * no dense order, and in archetype mode the call does nothing.
+   *
+   * Example:
+   * @code
+   * registry.Sort<Sprite>([](const Sprite& a, const Sprite& b) {
+   *   return a.z_index < b.z_index;
+   * });
+   * @endcode
+   *
+   * @param compare Strict weak ordering of `(const T&, const T&)`.
+   */
+  template <typename T, typename Compare>
+  void Sort(Compare compare) {
+    SortStorage<T>(compare, false);
+  }
+
+  /**
+   * @brief Like Sort(), but cheap when the storage is already nearly in
+   * order.
+   *
+   * Meant to be called every frame on a storage whose keys change little
+   * between frames, e.g. sprite layers or spatial codes of slow-moving
+   * entities: it costs one pass plus one move per misplaced step, and falls
+   * back to a full sort if the order has drifted too far.
+   */
+  template <typename T, typename Compare>
+  void SortIncremental(Compare compare) {
+    SortStorage<T>(compare, true);
+  }
+
+  /**
+   * @brief Executes a function for every entity that matches the given
+   * component requirements.
+   *
+   * This is a convenience wrapper around creating a View and iterating over it.
+   * The function should accept references to each of the requested component
+   * types.
+   *
+   * Example:
+   * @code
+   * registry.ForEach<Transform, Sprite>([](Transform& t, Sprite& s) {
+   *     // Update logic
+   * });
+   * @endcode
+   *
+   * @tparam Components The component types to filter for.
+   * @tparam Func The type of the callback function.
+   * @param func The callback function to execute.
+   */
+  template <typename... Components, typename Func>
+  void ForEach(Func&& func) {
+    GetView<Components...>().Each(
+        [&func](EntityID, Components&... components) { func(components...); });
+  }
+
+  /**
+   * @brief Executes a function over contiguous runs of matching components.
+   *
+   * The function receives a row count, a pointer to that many entity IDs and
+   * one pointer per component type to that many components. In archetype mode
+   * each call covers one chunk, so the body can be written as a plain indexed
+   * loop over parallel arrays that the compiler can vectorize. In sparse-set
+   * mode the function is invoked once per entity with a count of one.
+   *
+   * @tparam Components The component types to filter for.
+   * @tparam Func The type of the callback function.
+   * @param func Callback of the form `(size_t, const EntityID*, Components*...)`.
+   */
+  template <typename... Components, typename Func>
+  void ForEachChunk(Func&& func) {
+    if (archetypes_) {
+      std::vector<Archetype*> matching;
+      archetypes_->CollectMatching({archetypes_->TypeId<Components>()...},
+                                   &matching);
+      for (Archetype* archetype : matching) {
+        const int columns[] = {
+            archetype->ColumnOf(archetypes_->TypeId<Components>())...};
+        for (size_t chunk = 0; chunk < archetype->chunk_count(); ++chunk) {
+          InvokeOnChunk<Components...>(
+              func, archetype, chunk, columns,
+              std::index_sequence_for<Components...>{});
+        }
+      }
+      return;
+    }
+    GetView<Components...>().Each(
+        [&func](EntityID entity, Components&... components) {
+          func(size_t{1}, &entity, &components...);
+        });
+  }
+
+  /**
+   * @brief Executes a function for every matching entity, spread across the
+   * JobSystem workers.
+   *
+   * The matching entities are split into batches of `grain` and processed in
+   * parallel; the call returns once every batch is done. Falls back to a
+   * serial loop when the JobSystem has no workers.
+   *
+   * The function must only touch the components it is given. Structural
+   * changes (creating or deleting entities, adding or removing components)
+   * are not allowed until the call returns and abort in debug builds; record
+   * them into `commands()` instead. Commands are stamped with the visited
+   * entity, so their playback order is the same however the batches were
+   * distributed. Listeners of events published from the function run on
+   * worker threads.
+   *
+   * @tparam Components The component types to filter for.
+   * @tparam Func The type of the callback function.
+   * @param func Callback receiving references to each requested component,
+   * optionally preceded by the entity ID.
+   * @param grain Maximum number of candidate entities per batch.
+   */
+  template <typename... Components, typename Func>
+  void ParallelForEach(Func&& func, size_t grain = 256) {
+    parallel_sections_.fetch_add(1, std::memory_order_relaxed);
+    const View<Components...> view = GetView<Components...>();
+    const uint64_t key_base = detail::command_sort_key & ~uint64_t{0xFFFFFFFF};
+    core::JobSystem::Get().ParallelFor(
+        view.size_hint(), grain,
+        [&view, &func, key_base](size_t begin, size_t end) {
+          ScopedCommandSortKey scope(key_base);
+          view.EachInRange(begin, end, [&func, key_base](
+                                           EntityID entity,
+                                           Components&... components) {
+            detail::command_sort_key = key_base | GetEntityIndex(entity);
+            if constexpr (std::is_invocable_v<Func&, EntityID,
+                                              Components&...>) {
+              func(entity, components...);
+            } else {
+              func(components...);
+            }
+          });
+        });
+    parallel_sections_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the calling thread's command buffer.
+   *
+   * Each thread gets its own buffer, so recording never contends with other
+   * threads. JobSystem workers are looked up by thread index; the main
+   * thread and threads outside the JobSystem, which all report index 0, are
+   * told apart by thread ID. Recorded changes take effect at the next
+   * FlushCommands(), which the SystemScheduler calls between stages.
+   */
+  EntityCommandBuffer& commands() {
+    const size_t thread = core::JobSystem::GetThreadIndex();
+    std::lock_guard<std::mutex> lock(command_mutex_);
+    if (thread == 0) {
+      const std::thread::id id = std::this_thread::get_id();
+      for (const auto& [owner, buffer] : outside_buffers_) {
+        if (owner == id) {
+          return *buffer;
+        }
+      }
+      outside_buffers_.emplace_back(id, NewCommandBuffer());
+      return *outside_buffers_.back().second;
+    }
+    if (thread >= worker_buffers_.size()) {
+      worker_buffers_.resize(thread + 1, nullptr);
+    }
+    EntityCommandBuffer*& buffer = worker_buffers_[thread];
+    if (!buffer) {
+      buffer = NewCommandBuffer();
+    }
+    return *buffer;
+  }
+
+  /**
+   * @brief Plays back every thread's command buffer in sort-key order.
+   *
+   * Must be called from the main thread while no systems or parallel
+   * sections are running.
+   */
+  void FlushCommands() {
+    CheckStructuralChange("FlushCommands");
+    std::vector<EntityCommandBuffer*> buffers;
+    {
+      std::lock_guard<std::mutex> lock(command_mutex_);
+      for (const auto& buffer : command_buffers_) {
+        if (buffer && !buffer->empty()) {
+          buffers.push_back(buffer.get());
+        }
+      }
+    }
+    if (!buffers.empty()) {
+      EntityCommandBuffer::Playback(buffers.data(), buffers.size(), *this);
+    }
+  }
+
+  /**
+   * @brief Constructs the registry's resource of type T from `args`,
+   * replacing any existing one.
+   *
+   * A resource is a single value per registry that belongs to no entity,
+   * e.g. a grid map or the turn order. Looking one up is an index into a
+   * flat table, so code that would otherwise find a singleton by scanning a
+   * view can ask for it directly. Resources are independent of the storage
+   * mode, are dropped by Clear(), and are saved in snapshots once registered
+   * with RegisterSnapshotResource().
+   *
+   * Example:
+   * @code
+   * registry.SetResource<GridMap>(std::move(grid));
+   * GridMap* grid = registry.GetResource<GridMap>();
+   * @endcode
+   *
+   * @return The new resource.
+   */
+  template <typename T, typename... Args>
+  T& SetResource(Args&&... args) {
+    CheckStructuralChange("SetResource");
+    const uint32_t id = ResourceTypeId<T>();
+    if (id >= resources_.size()) {
+      resources_.resize(id + 1);
+    }
+    auto resource = std::make_unique<Resource<T>>(std::forward<Args>(args)...);
+    T& value = resource->value;
+    resources_[id] = std::move(resource);
+    return value;
+  }
+
+  /** @brief Returns the resource of type T, or nullptr if none is set. */
+  template <typename T>
+  T* GetResource() {
+    const uint32_t id = ResourceTypeId<T>();
+    if (id >= resources_.size() || !resources_[id]) {
+      return nullptr;
+    }
+    return &static_cast<Resource<T>*>(resources_[id].get())->value;
+  }
+
+  /** @brief Returns true if a resource of type T is set. */
+  template <typename T>
+  bool HasResource() const {
+    const uint32_t id = ResourceTypeId<T>();
+    return id < resources_.size() && resources_[id] != nullptr;
+  }
+
+  /** @brief Destroys the resource of type T, if any. */
+  template <typename T>
+  void RemoveResource() {
+    CheckStructuralChange("RemoveResource");
+    const uint32_t id = ResourceTypeId<T>();
+    if (id < resources_.size()) {
+      resources_[id].reset();
+    }
+  }
+
+  /**
+   * @brief Subscribes a listener to events of type T.
+   * @param listener The listener to subscribe.
+   * @param one_shot If true, the listener will be automatically unsubscribed
+   * after one event.
+   */
+  template <typename T>
+  void Subscribe(events::IEventListener<T>* listener, bool one_shot = false) {
+    GetDispatcher<T>()->Subscribe(listener, one_shot);
+  }
+
+  /**
+   * @brief Unsubscribes a listener from events of type T.
+   * @param listener The listener to unsubscribe.
+   */
+  template <typename T>
+  void Unsubscribe(events::IEventListener<T>* listener) {
+    GetDispatcher<T>()->Unsubscribe(listener);
+  }
+
+  /**
+   * @brief Publishes an event of type T.
+   *
+   * Events nobody is subscribed to are dropped right away, deferred ones
+   * included. Deferred events may be published from any thread, e.g. from
+   * inside ParallelForEach or a scheduled system; component events keep a
+   * copy of the component, so they stay valid until Update().
+   *
+   * @param event The event data.
+   * @param immediate If true, listeners are notified immediately. If false, the
+   * event is queued for the next Update() call.
+   */
+  template <typename T>
+  void Publish(const T& event, bool immediate = true) {
+    if (!HasSubscribers<T>()) {
+      return;
+    }
+    events::EventDispatcher<T>* dispatcher = GetDispatcher<T>();
+    if (immediate) {
+      dispatcher->Dispatch(event);
+    } else {
+      dispatcher->Enqueue(event);
+    }
+  }
+
+  /** @brief Returns true if any listener is subscribed to events of type T. */
+  template <typename T>
+  bool HasSubscribers() const {
+    const uint32_t id = EventTypeId<T>();
+    return id < dispatchers_.size() && dispatchers_[id] &&
+           static_cast<const events::EventDispatcher<T>*>(
+               dispatchers_[id].get())
+               ->has_listeners();
+  }
 
   /**
    * @brief Modifies a component and triggers a events::ComponentModifiedEvent.
@@ -380,10 +1624,39 @@ class Registry {
     if (HasComponent<T>(entity)) {
       T& component = GetComponent<T>(entity);
       func(component);
+      MarkChanged<T>(entity);
       Publish<events::ComponentModifiedEvent<T>>({entity, component, this});
     }
   }
 
+  /**
+   * @brief Stamps a component as changed at the current tick, for components
+   * modified through a plain reference.
+   */
+  template <typename T>
+  void MarkChanged(EntityID entity) {
+    if (!archetypes_) {
+      GetStorage<T>()->MarkChanged(entity, tick());
+    }
+  }
+
+  /** @brief Returns the tick new changes are stamped with. */
+  uint32_t tick() const { return tick_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Starts a new tick.
+   *
+   * Changes made after this call are stamped with a later tick than the one
+   * returned, so a consumer that stores the result and later filters with
+   * `Changed<T>{result}` sees exactly the changes made in between. The
+   * SystemScheduler does this around every system.
+   *
+   * @return The tick that was current before the call.
+   */
+  uint32_t AdvanceTick() {
+    return tick_.fetch_add(1, std::memory_order_relaxed);
+  }
+
   /**
    * @brief Processes all queued asynchronous events.
    *
@@ -391,8 +1664,10 @@ class Registry {
    * systems update, to ensure all deferred events are dispatched to listeners.
    */
   void Update() {
-    for (auto& [type, dispatcher] : dispatchers_) {
-      dispatcher->ProcessQueue();
+    for (auto& dispatcher : dispatchers_) {
+      if (dispatcher) {
+        dispatcher->ProcessQueue();
+      }
     }
   }
 
@@ -403,30 +1678,259 @@ class Registry {
   size_t GetEntityCount() const { return entity_manager_.GetEntityCount(); }
 
   /**
-   * @brief Clears all entities and components from the registry.
+   * @brief Reports the entity count and the memory and occupancy of every
+   * component storage and event dispatcher created so far.
+   *
+   * Walks every storage and locks every dispatcher's queues, so it is meant
+   * for diagnostics rather than every frame. Must not run concurrently with
+   * structural changes.
+   */
+  RegistryStats GetStats() const {
+    RegistryStats stats;
+    stats.entities = entity_manager_.GetEntityCount();
+    stats.entity_slots = entity_manager_.slots().size();
+    for (const auto& storage : storages_) {
+      if (storage) {
+        stats.storages.push_back(storage->stats());
+      }
+    }
+    std::sort(stats.storages.begin(), stats.storages.end(),
+              [](const StorageStats& a, const StorageStats& b) {
+                return a.bytes > b.bytes;
+              });
+    for (const auto& dispatcher : dispatchers_) {
+      if (dispatcher) {
+        stats.dispatchers.push_back(dispatcher->stats());
+      }
+    }
+    std::sort(stats.dispatchers.begin(), stats.dispatchers.end(),
+              [](const events::DispatcherStats& a,
+                 const events::DispatcherStats& b) {
+                return a.queued > b.queued;
+              });
+    if (archetypes_) {
+      stats.archetypes = archetypes_->archetype_count();
+      stats.chunks = archetypes_->chunk_count();
+      stats.chunk_bytes = archetypes_->chunk_bytes();
+    }
+    return stats;
+  }
+
+  /**
+   * @brief Clears all entities, components and resources from the registry.
    */
   void Clear() {
-    for (auto& [type, storage] : storages_) {
-      storage->Clear();
+    CheckStructuralChange("Clear");
+    ClearContents();
+    resources_.clear();
+    for (auto& dispatcher : dispatchers_) {
+      if (dispatcher) {
+        dispatcher->Clear();
+      }
     }
-    for (auto& [type, dispatcher] : dispatchers_) {
-      dispatcher->Clear();
+  }
+
+  /**
+   * @brief Writes every entity and every snapshot-registered component to a
+   * binary file.
+   *
+   * Entity handles are saved as they are, so references between entities
+   * survive a round trip. Components registered with RegisterSnapshotType()
+   * are written column by column, followed by the resources registered with
+   * RegisterSnapshotResource(); other types are skipped with a warning. Only
+   * supported in StorageMode::kSparseSet.
+   *
+   * @param path The file to write.
+   * @return True on success.
+   */
+  bool SaveSnapshot(const std::string& path);
+
+  /**
+   * @brief Replaces the registry contents with a snapshot written by
+   * SaveSnapshot().
+   *
+   * The file is memory-mapped and raw columns are copied straight from the
+   * mapping into the storages. Loaded components are stamped with the
+   * current tick, and EntityCreated and ComponentAdded events are published
+   * to existing subscribers. Saved resources replace the current ones;
+   * resources missing from the file are kept. The registry is left untouched
+   * if the file is malformed, and may be partially loaded if a column fails
+   * to decode.
+   *
+   * @param path The file to read.
+   * @return True on success.
+   */
+  bool LoadSnapshot(const std::string& path);
+
+  /**
+   * @brief Creates the storage for T ahead of time.
+   *
+   * Storage is otherwise created lazily on first use, which mutates the
+   * registry and is not safe while other threads read it. Registering every
+   * type a system touches up front lets systems run concurrently.
+   */
+  template <typename T>
+  void RegisterComponent() {
+    if (archetypes_) {
+      archetypes_->TypeId<T>();
+    } else {
+      GetStorage<T>();
     }
-    entity_manager_.Clear();
   }
 
- private:
   /**
    * @brief Gets the appropriate ComponentStorage for the given type.
-   * @returns the ComponentStorage for the template type.
+   *
+   * Systems that only need one component type can walk the storage's dense
+   * arrays directly instead of building a View. Only meaningful in
+   * StorageMode::kSparseSet; archetype registries keep their components in
+   * chunks and leave these storages empty.
+   *
+   * The storage is found by indexing a flat table with the component's
+   * family ID, so an existing storage costs one bounds check and one load.
+   *
+   * @returns the ComponentStorage for the template type, or its TagStorage
+   * if T is a tag.
    */
   template <typename T>
-  ComponentStorage<T>* GetStorage() {
-    auto type = std::type_index(typeid(T));
-    if (storages_.find(type) == storages_.end()) {
-      storages_[type] = std::make_unique<ComponentStorage<T>>();
+  StorageOf<T>* GetStorage() {
+    const uint32_t id = ComponentTypeId<T>();
+    if (id >= storages_.size()) {
+      storages_.resize(id + 1);
+    }
+    std::unique_ptr<IComponentStorage>& storage = storages_[id];
+    if (!storage) {
+      storage = std::make_unique<StorageOf<T>>(resource_);
+      storage->TrackMask(&entity_manager_, id);
+    }
+    return static_cast<StorageOf<T>*>(storage.get());
+  }
+
+ private:
+  friend class EntityCommandBuffer;
+  template <typename T>
+  friend void detail::CommandInsert(Registry&, EntityID, void*);
+
+  /**
+   * @brief Constructs a component in place without publishing a
+   * ComponentAddedEvent.
+   * @return A reference to the stored component.
+   */
+  template <typename T, typename... Args>
+  T& InsertComponent(EntityID entity, Args&&... args) {
+    if (archetypes_) {
+      return archetypes_->Emplace<T>(entity, std::forward<Args>(args)...);
+    }
+    return GetStorage<T>()->Emplace(entity, tick(),
+                                    std::forward<Args>(args)...);
+  }
+
+  template <typename T, typename Compare>
+  void SortStorage(Compare& compare, bool incremental) {
+    static_assert(!IsTag<T>::value, "Tags have no dense order to sort.");
+    CheckStructuralChange("Sort");
+    if (archetypes_) {
+      return;
+    }
+    ComponentStorage<T>* storage = GetStorage<T>();
+    size_t first = 0;
+    if (IGroupHandler* group = storage->owner()) {
+      first = group->size();
+      storage->ComputeOrder(0, first, compare, incremental, &sort_order_);
+      group->Permute(sort_order_);
+    }
+    storage->ComputeOrder(first, storage->size(), compare, incremental,
+                          &sort_order_);
+    storage->Permute(first, sort_order_);
+  }
+
+  /**
+   * @brief Aborts in debug builds if a structural change is attempted while a
+   * ParallelForEach is running.
+   */
+  void CheckStructuralChange([[maybe_unused]] const char* operation) const {
+#ifndef NDEBUG
+    if (parallel_sections_.load(std::memory_order_relaxed) > 0) {
+      LOG_ERR("Registry::%s called during ParallelForEach.", operation);
+      std::abort();
+    }
+#endif
+  }
+
+  /** @brief Calls a ForEachChunk callback with the columns of one chunk. */
+  template <typename... Components, typename Func, size_t... Is>
+  static void InvokeOnChunk(Func& func, Archetype* archetype, size_t chunk,
+                            const int* columns, std::index_sequence<Is...>) {
+    func(archetype->ChunkRowCount(chunk),
+         static_cast<const EntityID*>(archetype->ChunkEntities(chunk)),
+         static_cast<Components*>(
+             archetype->ChunkColumn(chunk, columns[Is]))...);
+  }
+
+  /**
+   * @brief Publishes a ComponentRemovedEvent for every component in the
+   * entity's mask.
+   */
+  void NotifyComponentsRemoved(EntityID entity) {
+    const uint32_t index = GetEntityIndex(entity);
+    for (size_t word = 0; word < entity_manager_.mask_words(); ++word) {
+      for (uint64_t bits = entity_manager_.ComponentMask(index)[word];
+           bits != 0; bits &= bits - 1) {
+        storages_[word * EntityManager::kMaskWordBits +
+                  std::countr_zero(bits)]
+            ->NotifyRemoved(entity, this);
+      }
     }
-    return static_cast<ComponentStorage<T>*>(storages_[type].get());
+  }
+
+  /**
+   * @brief Removes every component in the entity's mask, visiting only the
+   * storages that hold one.
+   */
+  void RemoveComponents(EntityID entity) {
+    const uint32_t index = GetEntityIndex(entity);
+    for (size_t word = 0; word < entity_manager_.mask_words(); ++word) {
+      for (uint64_t bits = entity_manager_.ComponentMask(index)[word];
+           bits != 0; bits &= bits - 1) {
+        storages_[word * EntityManager::kMaskWordBits +
+                  std::countr_zero(bits)]
+            ->Remove(entity);
+      }
+    }
+  }
+
+  /** @brief Drops every entity and component but keeps the listeners. */
+  void ClearContents() {
+    {
+      std::lock_guard<std::mutex> lock(command_mutex_);
+      for (auto& buffer : command_buffers_) {
+        if (buffer) {
+          buffer->Clear();
+        }
+      }
+    }
+    for (auto& storage : storages_) {
+      if (storage) {
+        storage->Clear();
+      }
+    }
+    for (auto& group : groups_) {
+      group->Reset();
+    }
+    for (auto& query : queries_) {
+      if (query) {
+        query->Reset();
+      }
+    }
+    for (auto& observer : observers_) {
+      if (observer) {
+        observer->Reset();
+      }
+    }
+    if (archetypes_) {
+      archetypes_->Clear();
+    }
+    entity_manager_.Clear();
   }
 
   /**
@@ -434,29 +1938,117 @@ class Registry {
    * @returns the EventDispatcher for the template type.
    */
   template <typename T>
-  EventDispatcher<T>* GetDispatcher() {
-    auto type = std::type_index(typeid(T));
-    if (dispatchers_.find(type) == dispatchers_.end()) {
-      dispatchers_[type] = std::make_unique<EventDispatcher<T>>();
+  events::EventDispatcher<T>* GetDispatcher() {
+    const uint32_t id = EventTypeId<T>();
+    if (id >= dispatchers_.size()) {
+      dispatchers_.resize(id + 1);
+    }
+    std::unique_ptr<events::IEventDispatcher>& dispatcher = dispatchers_[id];
+    if (!dispatcher) {
+      dispatcher = std::make_unique<events::EventDispatcher<T>>(resource_);
     }
-    return static_cast<EventDispatcher<T>*>(dispatchers_[type].get());
+    return static_cast<events::EventDispatcher<T>*>(dispatcher.get());
+  }
+
+  /** @brief Creates a command buffer; `command_mutex_` must be held. */
+  EntityCommandBuffer* NewCommandBuffer() {
+    command_buffers_.push_back(
+        std::make_unique<EntityCommandBuffer>(&next_placeholder_));
+    return command_buffers_.back().get();
   }
 
+  /** @brief Where storages and dispatchers allocate their arrays. */
+  std::pmr::memory_resource* resource_;
+  /** @brief Source of registry IDs. */
+  static inline std::atomic<uint64_t> next_id_{1};
+  const uint64_t id_;
   EntityManager entity_manager_;
-  std::unordered_map<std::type_index, std::unique_ptr<IComponentStorage>>
-      storages_;
-  std::unordered_map<std::type_index, std::unique_ptr<IEventDispatcher>>
-      dispatchers_;
+  /** @brief Chunked component data; only set in StorageMode::kArchetype. */
+  std::unique_ptr<ArchetypeStorage> archetypes_;
+  /** @brief Component storages indexed by ComponentTypeId; may have holes. */
+  std::vector<std::unique_ptr<IComponentStorage>> storages_;
+  /** @brief Owning groups; they sort and hook into `storages_`. */
+  std::vector<std::unique_ptr<IGroupHandler>> groups_;
+  /** @brief Persistent queries indexed by QueryFamily; may have holes. */
+  std::vector<std::unique_ptr<IQueryHandler>> queries_;
+  /** @brief Reactive observers indexed by ObserverFamily; may have holes. */
+  std::vector<std::unique_ptr<ObserverHandler>> observers_;
+  /** @brief Guards creation of groups, queries and observers. */
+  std::mutex group_mutex_;
+  /** @brief Scratch order reused by Sort() and SortIncremental(). */
+  std::vector<uint32_t> sort_order_;
+  /** @brief Resources indexed by ResourceTypeId; may have holes. */
+  std::vector<std::unique_ptr<IResource>> resources_;
+  /** @brief Event dispatchers indexed by EventTypeId; may have holes. */
+  std::vector<std::unique_ptr<events::IEventDispatcher>> dispatchers_;
+  /**
+   * @brief Number of ParallelForEach calls in flight. Atomic because systems
+   * scheduled on different workers may each open a section.
+   */
+  std::atomic<int> parallel_sections_{0};
+  /**
+   * @brief Current change tick. Starts at 1 so that every component is newer
+   * than the default last-run tick of 0.
+   */
+  std::atomic<uint32_t> tick_{1};
+  /** @brief Guards creation of the per-thread command buffers. */
+  std::mutex command_mutex_;
+  /** @brief Every command buffer, in the order they were created. */
+  std::vector<std::unique_ptr<EntityCommandBuffer>> command_buffers_;
+  /** @brief Buffers of JobSystem workers, indexed by thread index. */
+  std::vector<EntityCommandBuffer*> worker_buffers_;
+  /** @brief Buffers of the threads that report thread index 0. */
+  std::vector<std::pair<std::thread::id, EntityCommandBuffer*>>
+      outside_buffers_;
+  /** @brief Placeholder counter shared by all command buffers. */
+  std::atomic<uint32_t> next_placeholder_{0};
 };
 
 template <typename T>
 void ComponentStorage<T>::NotifyRemoved(EntityID entity, Registry* registry) {
-  if (Has(entity)) {
+  if (registry->HasSubscribers<events::ComponentRemovedEvent<T>>() &&
+      Has(entity)) {
     registry->Publish<events::ComponentRemovedEvent<T>>(
         {entity, Get(entity), registry});
   }
 }
 
+template <typename T>
+void TagStorage<T>::NotifyRemoved(EntityID entity, Registry* registry) {
+  if (registry->HasSubscribers<events::ComponentRemovedEvent<T>>() &&
+      Has(entity)) {
+    registry->Publish<events::ComponentRemovedEvent<T>>(
+        {entity, value_, registry});
+  }
+}
+
+namespace detail {
+template <typename T>
+void PublishArchetypeComponentRemoved(EntityID entity, void* component,
+                                      Registry* registry) {
+  registry->Publish<events::ComponentRemovedEvent<T>>(
+      {entity, *static_cast<T*>(component), registry});
+}
+
+template <typename T>
+void CommandInsert(Registry& registry, EntityID entity, void* component) {
+  registry.InsertComponent<T>(entity, std::move(*static_cast<T*>(component)));
+}
+
+template <typename T>
+void CommandRemove(Registry& registry, EntityID entity) {
+  registry.RemoveComponent<T>(entity);
+}
+
+template <typename T>
+void CommandPublishAdded(Registry& registry, EntityID entity) {
+  if (registry.HasComponent<T>(entity)) {
+    registry.Publish<events::ComponentAddedEvent<T>>(
+        {entity, registry.GetComponent<T>(entity), &registry});
+  }
+}
+}  // namespace detail
+
 }  // namespace engine::ecs
 
 #endif  // INCLUDE_ENGINE_ECS_REGISTRY_H_
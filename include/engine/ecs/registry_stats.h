@@ -0,0 +1,55 @@
+/**
+ * @file registry_stats.h
+ * @brief Memory and occupancy report of a Registry.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_REGISTRY_STATS_H_
+#define INCLUDE_ENGINE_ECS_REGISTRY_STATS_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/events/event_dispatcher.h>
+
+namespace engine::ecs {
+
+/**
+ * @brief Per-storage and per-dispatcher figures of a Registry, as returned by
+ * Registry::GetStats().
+ *
+ * Storages and dispatchers that were created but are empty are still listed,
+ * so storages that keep their capacity after a scene change stand out.
+ */
+struct RegistryStats {
+  /** @brief Number of live entities. */
+  size_t entities = 0;
+  /** @brief Number of entity slots allocated, live or free. */
+  size_t entity_slots = 0;
+  /** @brief Component storages, largest first by bytes. */
+  std::vector<StorageStats> storages;
+  /** @brief Event dispatchers, most queued events first. */
+  std::vector<events::DispatcherStats> dispatchers;
+  /** @brief Number of archetypes; only set in StorageMode::kArchetype. */
+  size_t archetypes = 0;
+  /** @brief Chunks allocated across the archetypes. */
+  size_t chunks = 0;
+  /** @brief Bytes allocated for those chunks. */
+  size_t chunk_bytes = 0;
+
+  /** @brief Returns the bytes held by the storages and archetype chunks. */
+  size_t total_bytes() const;
+
+  /** @brief Returns the total number of deferred events waiting. */
+  size_t queued_events() const;
+
+  /**
+   * @brief Formats the report as a table, one storage or dispatcher per line.
+   */
+  std::string ToString() const;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_REGISTRY_STATS_H_
@@ -0,0 +1,45 @@
+/**
+ * @file resource.h
+ * @brief Holders for registry resources, the one-per-world values that are
+ * not attached to any entity.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_RESOURCE_H_
+#define INCLUDE_ENGINE_ECS_RESOURCE_H_
+
+#include <utility>
+
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+/**
+ * @brief Base interface of a resource holder, so the Registry can own
+ * resources of any type.
+ */
+class IResource {
+ public:
+  virtual ~IResource() = default;
+
+ protected:
+  IResource() = default;
+};
+
+/**
+ * @brief Holds the registry's single value of type T.
+ */
+template <typename T>
+class Resource final : public IResource {
+ public:
+  template <typename... Args>
+  explicit Resource(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+  Resource(const Resource&) = delete;
+  Resource& operator=(const Resource&) = delete;
+
+  T value;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_RESOURCE_H_
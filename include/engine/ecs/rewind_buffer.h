@@ -0,0 +1,269 @@
+/**
+ * @file rewind_buffer.h
+ * @brief Fixed-size ring of in-memory component snapshots for rollback and
+ * instant replays.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_REWIND_BUFFER_H_
+#define INCLUDE_ENGINE_ECS_REWIND_BUFFER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <engine/ecs/registry.h>
+#include <engine/util/logger.h>
+
+namespace engine::ecs {
+
+/**
+ * @brief Records the state of selected component storages every frame and
+ * restores any recorded frame.
+ *
+ * Each frame stores one column per component type: the storage's entity
+ * array and its component array, split into fixed-size blocks. Blocks and
+ * entity arrays that are unchanged since the previous frame are shared
+ * rather than copied, so a frame costs memory in proportion to what changed.
+ *
+ * Restoring a storage whose entity array still matches the recorded one
+ * compares the blocks and copies back only those that differ, stamping their
+ * components as changed. If components were added or removed since, the
+ * storage is brought back in line through RemoveComponent() and
+ * AddComponent(), so events, hooks and groups see the difference.
+ *
+ * Only component state is rewound: entities created or destroyed since the
+ * frame keep their fate, and recorded components of destroyed entities are
+ * not restored.
+ *
+ * Example:
+ * @code
+ * RewindBuffer<Transform, Velocity> rewind(&registry, 120);
+ * rewind.Capture(frame);
+ * ...
+ * rewind.Restore(frame - 30);  // Then resimulate from there.
+ * @endcode
+ *
+ * @tparam Components The recorded component types; must be trivially
+ * copyable.
+ */
+template <typename... Components>
+class RewindBuffer {
+ public:
+  static_assert((std::is_trivially_copyable_v<Components> && ...),
+                "Rewound components must be trivially copyable.");
+  static_assert(!(IsTag<Components>::value || ...),
+                "Tags have no component arrays to record.");
+
+  /** @brief Number of components per shared block. */
+  static constexpr size_t kBlockSize = 256;
+
+  /**
+   * @param registry The sparse-set registry to record; must outlive the
+   * buffer.
+   * @param capacity Number of frames kept; older frames are dropped.
+   */
+  RewindBuffer(Registry* registry, size_t capacity)
+      : registry_(registry), frames_(std::max<size_t>(capacity, 1)) {
+    if (registry_->storage_mode() != StorageMode::kSparseSet) {
+      LOG_ERR("RewindBuffer requires a sparse-set registry.");
+    }
+  }
+
+  /**
+   * @brief Records the current state as `frame`.
+   *
+   * Frames are expected in increasing order. Recording a frame at or before
+   * the newest one first drops every frame from it onwards, which is what
+   * resimulating after a Restore() needs.
+   */
+  void Capture(uint64_t frame) {
+    DropFrom(frame);
+    const Frame* previous = size_ > 0 ? &At(size_ - 1) : nullptr;
+    if (size_ == frames_.size()) {
+      head_ = (head_ + 1) % frames_.size();
+      --size_;
+    }
+    Frame& slot = frames_[(head_ + size_) % frames_.size()];
+    Frame next;
+    next.frame = frame;
+    (CaptureColumn<Components>(previous, &next), ...);
+    slot = std::move(next);
+    ++size_;
+  }
+
+  /**
+   * @brief Brings the recorded storages back to their state at `frame`.
+   *
+   * Frames after it stay recorded until the next Capture() overwrites them.
+   *
+   * @return False if the frame is not in the buffer.
+   */
+  bool Restore(uint64_t frame) {
+    const Frame* recorded = Find(frame);
+    if (!recorded) {
+      return false;
+    }
+    (RestoreColumn<Components>(*recorded), ...);
+    return true;
+  }
+
+  /** @brief Returns true if `frame` is in the buffer. */
+  bool Contains(uint64_t frame) const { return Find(frame) != nullptr; }
+
+  /** @brief Drops every recorded frame. */
+  void Clear() {
+    for (Frame& frame : frames_) {
+      frame = {};
+    }
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /** @brief Returns the number of recorded frames. */
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /** @brief Returns the maximum number of recorded frames. */
+  size_t capacity() const { return frames_.size(); }
+
+  /** @brief Returns the oldest recorded frame; the buffer must not be empty. */
+  uint64_t oldest_frame() const { return At(0).frame; }
+
+  /** @brief Returns the newest recorded frame; the buffer must not be empty. */
+  uint64_t newest_frame() const { return At(size_ - 1).frame; }
+
+ private:
+  template <typename T>
+  using Block = std::vector<T>;
+
+  template <typename T>
+  struct Column {
+    std::shared_ptr<const std::vector<EntityID>> entities;
+    std::vector<std::shared_ptr<const Block<T>>> blocks;
+  };
+
+  struct Frame {
+    uint64_t frame = 0;
+    std::tuple<Column<Components>...> columns;
+  };
+
+  const Frame& At(size_t i) const {
+    return frames_[(head_ + i) % frames_.size()];
+  }
+
+  const Frame* Find(uint64_t frame) const {
+    for (size_t i = 0; i < size_; ++i) {
+      if (At(i).frame == frame) {
+        return &At(i);
+      }
+    }
+    return nullptr;
+  }
+
+  /** @brief Forgets the recorded frames from `frame` onwards. */
+  void DropFrom(uint64_t frame) {
+    while (size_ > 0 && At(size_ - 1).frame >= frame) {
+      frames_[(head_ + size_ - 1) % frames_.size()] = {};
+      --size_;
+    }
+  }
+
+  template <typename T>
+  void CaptureColumn(const Frame* previous, Frame* frame) {
+    ComponentStorage<T>* storage = registry_->GetStorage<T>();
+    const std::pmr::vector<EntityID>& entities = storage->entities();
+    const T* data = storage->data();
+    const Column<T>* last =
+        previous ? &std::get<Column<T>>(previous->columns) : nullptr;
+    Column<T>& column = std::get<Column<T>>(frame->columns);
+
+    if (last && std::ranges::equal(*last->entities, entities)) {
+      column.entities = last->entities;
+    } else {
+      column.entities = std::make_shared<const std::vector<EntityID>>(
+          entities.begin(), entities.end());
+    }
+    const size_t size = entities.size();
+    column.blocks.resize((size + kBlockSize - 1) / kBlockSize);
+    for (size_t b = 0; b < column.blocks.size(); ++b) {
+      const T* first = data + b * kBlockSize;
+      const size_t count = std::min(kBlockSize, size - b * kBlockSize);
+      if (last && b < last->blocks.size() &&
+          Equal(*last->blocks[b], first, count)) {
+        column.blocks[b] = last->blocks[b];
+      } else {
+        column.blocks[b] =
+            std::make_shared<const Block<T>>(first, first + count);
+      }
+    }
+  }
+
+  template <typename T>
+  void RestoreColumn(const Frame& frame) {
+    const Column<T>& column = std::get<Column<T>>(frame.columns);
+    ComponentStorage<T>* storage = registry_->GetStorage<T>();
+    if (std::ranges::equal(storage->entities(), *column.entities)) {
+      const std::vector<EntityID>& entities = *column.entities;
+      T* data = storage->data();
+      for (size_t b = 0; b < column.blocks.size(); ++b) {
+        const Block<T>& block = *column.blocks[b];
+        T* target = data + b * kBlockSize;
+        if (Equal(block, target, block.size())) {
+          continue;
+        }
+        std::copy(block.begin(), block.end(), target);
+        for (size_t i = 0; i < block.size(); ++i) {
+          registry_->MarkChanged<T>(entities[b * kBlockSize + i]);
+        }
+      }
+      return;
+    }
+
+    // Components were added or removed since; reconcile entity by entity.
+    std::vector<EntityID> recorded = *column.entities;
+    std::sort(recorded.begin(), recorded.end());
+    std::vector<EntityID> extra;
+    for (EntityID entity : storage->entities()) {
+      if (!std::binary_search(recorded.begin(), recorded.end(), entity)) {
+        extra.push_back(entity);
+      }
+    }
+    for (EntityID entity : extra) {
+      registry_->RemoveComponent<T>(entity);
+    }
+    const std::vector<EntityID>& entities = *column.entities;
+    for (size_t i = 0; i < entities.size(); ++i) {
+      const T& value = (*column.blocks[i / kBlockSize])[i % kBlockSize];
+      if (!registry_->IsAlive(entities[i])) {
+        continue;
+      }
+      if (storage->Has(entities[i])) {
+        storage->Get(entities[i]) = value;
+        registry_->MarkChanged<T>(entities[i]);
+      } else {
+        registry_->EmplaceComponent<T>(entities[i], value);
+      }
+    }
+  }
+
+  template <typename T>
+  static bool Equal(const Block<T>& block, const T* data, size_t count) {
+    return block.size() == count &&
+           std::memcmp(block.data(), data, count * sizeof(T)) == 0;
+  }
+
+  Registry* registry_;
+  /** @brief Ring of frames; the oldest is at `head_`. */
+  std::vector<Frame> frames_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_REWIND_BUFFER_H_
@@ -0,0 +1,566 @@
+/**
+ * @file snapshot.h
+ * @brief Binary snapshot format for Registry::SaveSnapshot() and
+ * Registry::LoadSnapshot().
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_SNAPSHOT_H_
+#define INCLUDE_ENGINE_ECS_SNAPSHOT_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <engine/ecs/registry.h>
+#include <engine/ecs/resource.h>
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+/** @brief Alignment of every column in a snapshot file. */
+constexpr size_t kSnapshotAlignment = 16;
+
+/**
+ * @brief Appends binary data to an in-memory snapshot.
+ */
+class SnapshotWriter {
+ public:
+  /** @brief Appends `size` raw bytes. */
+  void Write(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+  }
+
+  /** @brief Appends a trivially copyable value. */
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Write(&value, sizeof(T));
+  }
+
+  /** @brief Appends a length-prefixed string. */
+  void WriteString(std::string_view text) {
+    Write(static_cast<uint32_t>(text.size()));
+    Write(text.data(), text.size());
+  }
+
+  /** @brief Appends a length-prefixed array of trivially copyable values. */
+  template <typename T>
+  void WriteVector(const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Write(static_cast<uint32_t>(values.size()));
+    Write(values.data(), values.size() * sizeof(T));
+  }
+
+  /** @brief Pads with zeros up to the next multiple of `alignment`. */
+  void Align(size_t alignment) {
+    buffer_.resize((buffer_.size() + alignment - 1) / alignment * alignment);
+  }
+
+  /** @brief Overwrites a value written earlier at byte `offset`. */
+  template <typename T>
+  void Patch(size_t offset, const T& value) {
+    std::memcpy(buffer_.data() + offset, &value, sizeof(T));
+  }
+
+  size_t size() const { return buffer_.size(); }
+  const uint8_t* data() const { return buffer_.data(); }
+
+ private:
+  std::vector<uint8_t> buffer_;
+};
+
+/**
+ * @brief Reads binary data from a snapshot held in memory, usually a mapped
+ * file.
+ *
+ * Every read is bounds-checked. The first read past the end fails, and every
+ * later read fails too, so callers can check ok() once at the end.
+ */
+class SnapshotReader {
+ public:
+  SnapshotReader(const uint8_t* data, size_t size)
+      : data_(data), size_(size) {}
+
+  /**
+   * @brief Returns a pointer to the next `size` bytes and skips them, or
+   * nullptr if fewer remain.
+   */
+  const void* Read(size_t size) {
+    if (!ok_ || size > size_ - offset_) {
+      ok_ = false;
+      return nullptr;
+    }
+    const uint8_t* bytes = data_ + offset_;
+    offset_ += size;
+    return bytes;
+  }
+
+  /** @brief Reads a trivially copyable value. */
+  template <typename T>
+  bool Read(T* value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const void* bytes = Read(sizeof(T));
+    if (bytes) {
+      std::memcpy(value, bytes, sizeof(T));
+    }
+    return bytes != nullptr;
+  }
+
+  /**
+   * @brief Returns `count` values stored in place, without copying them.
+   * @note The data must have been written at a suitably aligned offset.
+   */
+  template <typename T>
+  const T* ReadArray(size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (count > (size_ - offset_) / sizeof(T)) {
+      ok_ = false;
+      return nullptr;
+    }
+    return static_cast<const T*>(Read(count * sizeof(T)));
+  }
+
+  /** @brief Reads a string written by SnapshotWriter::WriteString(). */
+  bool ReadString(std::string* text) {
+    uint32_t length = 0;
+    Read(&length);
+    const char* chars = static_cast<const char*>(Read(length));
+    if (chars) {
+      text->assign(chars, length);
+    }
+    return chars != nullptr;
+  }
+
+  /** @brief Reads an array written by SnapshotWriter::WriteVector(). */
+  template <typename T>
+  bool ReadVector(std::vector<T>* values) {
+    uint32_t count = 0;
+    Read(&count);
+    const T* first = ok_ ? ReadArray<T>(count) : nullptr;
+    if (first) {
+      values->assign(first, first + count);
+    }
+    return first != nullptr;
+  }
+
+  /** @brief Skips up to the next multiple of `alignment`. */
+  void Align(size_t alignment) {
+    const size_t aligned = (offset_ + alignment - 1) / alignment * alignment;
+    Read(aligned - offset_);
+  }
+
+  bool ok() const { return ok_; }
+  size_t offset() const { return offset_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool ok_ = true;
+};
+
+/**
+ * @brief The entity slots of a snapshot being loaded, so columns can be
+ * checked against them before the registry is replaced.
+ */
+class SnapshotSlots {
+ public:
+  SnapshotSlots(const EntityID* slots, uint32_t count)
+      : slots_(slots), count_(count) {}
+
+  /** @brief Returns the number of slots. */
+  uint32_t size() const { return count_; }
+
+  /** @brief Returns true if the entity is alive in the snapshot. */
+  bool IsAlive(EntityID entity) const {
+    const uint32_t index = GetEntityIndex(entity);
+    return index < count_ && slots_[index] == entity;
+  }
+
+  /** @brief Returns the live entity in a slot, or kInvalidEntity. */
+  EntityID GetEntity(uint32_t index) const {
+    return index < count_ && GetEntityIndex(slots_[index]) == index
+               ? slots_[index]
+               : kInvalidEntity;
+  }
+
+ private:
+  const EntityID* slots_;
+  uint32_t count_;
+};
+
+/**
+ * @brief A column decoded from a snapshot. Every column of a file is decoded
+ * before the first is committed, so a corrupt file leaves the registry as it
+ * was.
+ */
+class SnapshotColumn {
+ public:
+  virtual ~SnapshotColumn() = default;
+
+  /** @brief Adds the decoded data to the registry. */
+  virtual void Commit(Registry& registry) = 0;
+
+ protected:
+  SnapshotColumn() = default;
+};
+
+/**
+ * @brief How one component type is stored in snapshots.
+ */
+struct SnapshotType {
+  /** @brief Name the column is stored under; must be unique. */
+  std::string name;
+  /**
+   * @brief sizeof the component for raw columns, 0 for serialized ones and
+   * tags.
+   */
+  uint32_t raw_size = 0;
+  /** @brief Writes the entities and components of a storage. */
+  void (*save)(IComponentStorage& storage, SnapshotWriter& writer) = nullptr;
+  /**
+   * @brief Decodes a column written by `save`, or returns nullptr if it is
+   * corrupt or names entities that are not alive in `slots`.
+   */
+  std::unique_ptr<SnapshotColumn> (*decode)(SnapshotReader& reader,
+                                            const SnapshotSlots& slots) =
+      nullptr;
+};
+
+/**
+ * @brief How one resource type is stored in snapshots.
+ */
+struct SnapshotResourceType {
+  /** @brief Name the resource is stored under; must be unique. */
+  std::string name;
+  /** @brief sizeof the resource if stored raw, 0 if serialized. */
+  uint32_t raw_size = 0;
+  /** @brief Writes the resource. */
+  void (*save)(const IResource& resource, SnapshotWriter& writer) = nullptr;
+  /** @brief Decodes a resource written by `save`, or returns nullptr. */
+  std::unique_ptr<SnapshotColumn> (*decode)(SnapshotReader& reader) = nullptr;
+};
+
+namespace detail {
+
+/** @brief Adds a type to the table used by the snapshot functions. */
+void AddSnapshotType(uint32_t component_type, SnapshotType type);
+
+/** @brief Returns the registered type, or nullptr. */
+const SnapshotType* FindSnapshotType(uint32_t component_type);
+
+/** @brief Returns the type registered under `name`, or nullptr. */
+const SnapshotType* FindSnapshotType(std::string_view name);
+
+/** @brief Adds a resource type to the table used by the snapshot functions. */
+void AddSnapshotResourceType(uint32_t resource_type, SnapshotResourceType type);
+
+/** @brief Returns the registered resource type, or nullptr. */
+const SnapshotResourceType* FindSnapshotResourceType(uint32_t resource_type);
+
+/** @brief Returns the resource type registered under `name`, or nullptr. */
+const SnapshotResourceType* FindSnapshotResourceType(std::string_view name);
+
+/**
+ * @brief Returns true if every entity is alive in `slots` and appears once.
+ */
+bool CheckSnapshotEntities(const EntityID* entities, uint32_t count,
+                           const SnapshotSlots& slots);
+
+/** @brief Per-type serializers of non-trivial components and resources. */
+template <typename T>
+struct SnapshotCodec {
+  static inline void (*write)(const T& component, SnapshotWriter& writer) =
+      nullptr;
+  static inline bool (*read)(SnapshotReader& reader, T* component) = nullptr;
+};
+
+/** @brief Writes a tag column as the words of its bitset. */
+template <typename T>
+void SaveSnapshotTags(IComponentStorage& storage, SnapshotWriter& writer) {
+  const std::pmr::vector<uint64_t>& words =
+      static_cast<TagStorage<T>&>(storage).bits().words();
+  writer.Write(static_cast<uint32_t>(words.size()));
+  writer.Align(kSnapshotAlignment);
+  writer.Write(words.data(), words.size() * sizeof(uint64_t));
+}
+
+/** @brief A decoded tag column. */
+template <typename T>
+class TagSnapshotColumn final : public SnapshotColumn {
+ public:
+  explicit TagSnapshotColumn(std::vector<EntityID> entities)
+      : entities_(std::move(entities)) {}
+
+  void Commit(Registry& registry) override {
+    TagStorage<T>* storage = registry.GetStorage<T>();
+    for (EntityID entity : entities_) {
+      storage->Add(entity);
+    }
+    if (registry.HasSubscribers<events::ComponentAddedEvent<T>>()) {
+      for (EntityID entity : entities_) {
+        registry.Publish<events::ComponentAddedEvent<T>>(
+            {entity, storage->Get(entity), &registry});
+      }
+    }
+  }
+
+ private:
+  std::vector<EntityID> entities_;
+};
+
+template <typename T>
+std::unique_ptr<SnapshotColumn> DecodeSnapshotTags(
+    SnapshotReader& reader, const SnapshotSlots& slots) {
+  uint32_t count = 0;
+  reader.Read(&count);
+  reader.Align(kSnapshotAlignment);
+  const uint64_t* words = reader.ReadArray<uint64_t>(count);
+  if (!words) {
+    return nullptr;
+  }
+  std::vector<EntityID> entities;
+  for (uint32_t word = 0; word < count; ++word) {
+    for (uint64_t bits = words[word]; bits != 0; bits &= bits - 1) {
+      const EntityID entity = slots.GetEntity(static_cast<uint32_t>(
+          word * EntityBitset::kWordBits + std::countr_zero(bits)));
+      if (entity == kInvalidEntity) {
+        return nullptr;
+      }
+      entities.push_back(entity);
+    }
+  }
+  return std::make_unique<TagSnapshotColumn<T>>(std::move(entities));
+}
+
+template <typename T>
+void SaveSnapshotColumn(IComponentStorage& storage, SnapshotWriter& writer) {
+  auto& typed = static_cast<ComponentStorage<T>&>(storage);
+  const std::pmr::vector<EntityID>& entities = typed.entities();
+  writer.Write(static_cast<uint32_t>(entities.size()));
+  writer.Align(kSnapshotAlignment);
+  writer.Write(entities.data(), entities.size() * sizeof(EntityID));
+  writer.Align(kSnapshotAlignment);
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    writer.Write(typed.data(), entities.size() * sizeof(T));
+  } else {
+    const T* components = typed.data();
+    for (size_t i = 0; i < entities.size(); ++i) {
+      SnapshotCodec<T>::write(components[i], writer);
+    }
+  }
+}
+
+/**
+ * @brief A decoded component column. Raw columns point into the mapped file,
+ * so they are copied straight into the storage on commit.
+ */
+template <typename T>
+class ComponentSnapshotColumn final : public SnapshotColumn {
+ public:
+  ComponentSnapshotColumn(const EntityID* entities, uint32_t count,
+                          const T* raw)
+      : entities_(entities), count_(count), raw_(raw) {}
+  ComponentSnapshotColumn(const EntityID* entities, std::vector<T> decoded)
+      : entities_(entities),
+        count_(static_cast<uint32_t>(decoded.size())),
+        decoded_(std::move(decoded)) {}
+
+  void Commit(Registry& registry) override {
+    ComponentStorage<T>* storage = registry.GetStorage<T>();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      storage->Append(entities_, raw_, count_, registry.tick());
+    } else {
+      storage->Append(entities_, std::make_move_iterator(decoded_.begin()),
+                      count_, registry.tick());
+    }
+    if (registry.HasSubscribers<events::ComponentAddedEvent<T>>()) {
+      for (uint32_t i = 0; i < count_; ++i) {
+        registry.Publish<events::ComponentAddedEvent<T>>(
+            {entities_[i], storage->Get(entities_[i]), &registry});
+      }
+    }
+  }
+
+ private:
+  const EntityID* entities_;
+  uint32_t count_;
+  const T* raw_ = nullptr;
+  std::vector<T> decoded_;
+};
+
+template <typename T>
+std::unique_ptr<SnapshotColumn> DecodeSnapshotColumn(
+    SnapshotReader& reader, const SnapshotSlots& slots) {
+  uint32_t count = 0;
+  reader.Read(&count);
+  reader.Align(kSnapshotAlignment);
+  const EntityID* entities = reader.ReadArray<EntityID>(count);
+  reader.Align(kSnapshotAlignment);
+  if (!reader.ok() || !CheckSnapshotEntities(entities, count, slots)) {
+    return nullptr;
+  }
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    const T* components = reader.ReadArray<T>(count);
+    if (!components) {
+      return nullptr;
+    }
+    return std::make_unique<ComponentSnapshotColumn<T>>(entities, count,
+                                                        components);
+  } else {
+    std::vector<T> components(count);
+    for (T& component : components) {
+      if (!SnapshotCodec<T>::read(reader, &component)) {
+        return nullptr;
+      }
+    }
+    return std::make_unique<ComponentSnapshotColumn<T>>(
+        entities, std::move(components));
+  }
+}
+
+template <typename T>
+void SaveSnapshotResource(const IResource& resource, SnapshotWriter& writer) {
+  const T& value = static_cast<const Resource<T>&>(resource).value;
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    writer.Write(value);
+  } else {
+    SnapshotCodec<T>::write(value, writer);
+  }
+}
+
+/** @brief A decoded resource. */
+template <typename T>
+class ResourceSnapshotColumn final : public SnapshotColumn {
+ public:
+  explicit ResourceSnapshotColumn(T value) : value_(std::move(value)) {}
+
+  void Commit(Registry& registry) override {
+    registry.SetResource<T>(std::move(value_));
+  }
+
+ private:
+  T value_;
+};
+
+template <typename T>
+std::unique_ptr<SnapshotColumn> DecodeSnapshotResource(SnapshotReader& reader) {
+  T value{};
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    if (!reader.Read(&value)) {
+      return nullptr;
+    }
+  } else if (!SnapshotCodec<T>::read(reader, &value)) {
+    return nullptr;
+  }
+  return std::make_unique<ResourceSnapshotColumn<T>>(std::move(value));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Includes a trivially copyable component type in snapshots.
+ *
+ * Its storage is written and read back as one raw memory block, so the
+ * snapshot is only readable by builds where T has the same layout. Tags are
+ * written as their bitset.
+ *
+ * @param name Name the column is stored under.
+ */
+template <typename T>
+void RegisterSnapshotType(std::string name) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Non-trivial components need a write and read function.");
+  if constexpr (IsTag<T>::value) {
+    detail::AddSnapshotType(ComponentTypeId<T>(),
+                            {std::move(name), 0, &detail::SaveSnapshotTags<T>,
+                             &detail::DecodeSnapshotTags<T>});
+  } else {
+    detail::AddSnapshotType(ComponentTypeId<T>(),
+                            {std::move(name), static_cast<uint32_t>(sizeof(T)),
+                             &detail::SaveSnapshotColumn<T>,
+                             &detail::DecodeSnapshotColumn<T>});
+  }
+}
+
+/**
+ * @brief Includes a non-trivial component type in snapshots.
+ *
+ * Example:
+ * @code
+ * RegisterSnapshotType<Tag>(
+ *     "Tag", [](const Tag& tag, SnapshotWriter& writer) {
+ *       writer.WriteString(tag.name);
+ *     },
+ *     [](SnapshotReader& reader, Tag* tag) {
+ *       return reader.ReadString(&tag->name);
+ *     });
+ * @endcode
+ *
+ * @param name Name the column is stored under.
+ * @param write Writes one component.
+ * @param read Reads one component written by `write`; returns false on error.
+ */
+template <typename T>
+void RegisterSnapshotType(std::string name,
+                          void (*write)(const T&, SnapshotWriter&),
+                          bool (*read)(SnapshotReader&, T*)) {
+  static_assert(!std::is_trivially_copyable_v<T>,
+                "Trivially copyable components are stored as raw memory.");
+  detail::SnapshotCodec<T>::write = write;
+  detail::SnapshotCodec<T>::read = read;
+  detail::AddSnapshotType(ComponentTypeId<T>(),
+                          {std::move(name), 0, &detail::SaveSnapshotColumn<T>,
+                           &detail::DecodeSnapshotColumn<T>});
+}
+
+/**
+ * @brief Includes a trivially copyable resource type in snapshots, stored as
+ * raw memory.
+ *
+ * @param name Name the resource is stored under.
+ */
+template <typename T>
+void RegisterSnapshotResource(std::string name) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "Non-trivial resources need a write and read function.");
+  detail::AddSnapshotResourceType(
+      ResourceTypeId<T>(),
+      {std::move(name), static_cast<uint32_t>(sizeof(T)),
+       &detail::SaveSnapshotResource<T>, &detail::DecodeSnapshotResource<T>});
+}
+
+/**
+ * @brief Includes a non-trivial resource type in snapshots.
+ *
+ * @param name Name the resource is stored under.
+ * @param write Writes the resource.
+ * @param read Reads a resource written by `write`; returns false on error.
+ */
+template <typename T>
+void RegisterSnapshotResource(std::string name,
+                              void (*write)(const T&, SnapshotWriter&),
+                              bool (*read)(SnapshotReader&, T*)) {
+  static_assert(!std::is_trivially_copyable_v<T>,
+                "Trivially copyable resources are stored as raw memory.");
+  detail::SnapshotCodec<T>::write = write;
+  detail::SnapshotCodec<T>::read = read;
+  detail::AddSnapshotResourceType(
+      ResourceTypeId<T>(), {std::move(name), 0,
+                            &detail::SaveSnapshotResource<T>,
+                            &detail::DecodeSnapshotResource<T>});
+}
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_SNAPSHOT_H_
@@ -0,0 +1,184 @@
+/**
+ * @file system_scheduler.h
+ * @brief Runs registered systems in dependency order, in parallel where their
+ * declared component access allows it.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_SYSTEM_SCHEDULER_H_
+#define INCLUDE_ENGINE_ECS_SYSTEM_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <engine/ecs/registry.h>
+#include <engine/ecs/type_family.h>
+
+namespace engine::ecs {
+
+/**
+ * @brief Declares which component types a system reads and writes.
+ *
+ * Two systems conflict when one writes a type the other reads or writes, or
+ * when either is exclusive. Conflicting systems never run at the same time.
+ *
+ * Example:
+ * @code
+ * SystemAccess().Reads<Gravity, Collider>().Writes<Transform, Velocity>();
+ * @endcode
+ */
+class SystemAccess {
+ public:
+  /** @brief Declares read-only access to the given component types. */
+  template <typename... Ts>
+  SystemAccess& Reads() {
+    (Add<Ts>(&reads_), ...);
+    return *this;
+  }
+
+  /** @brief Declares read-write access to the given component types. */
+  template <typename... Ts>
+  SystemAccess& Writes() {
+    (Add<Ts>(&writes_), ...);
+    return *this;
+  }
+
+  /**
+   * @brief Marks the system as conflicting with every other system.
+   *
+   * Required for systems that create or delete entities, add or remove
+   * components directly, publish immediate events or run arbitrary callbacks
+   * (scripts, UI). Systems that record such changes into Registry::commands()
+   * or only publish deferred events do not need it.
+   */
+  SystemAccess& Exclusive() {
+    exclusive_ = true;
+    return *this;
+  }
+
+  /**
+   * @brief Forces the system onto the thread that calls
+   * SystemScheduler::Run(), e.g. for anything touching OpenGL, ImGui or Lua.
+   */
+  SystemAccess& MainThread() {
+    main_thread_ = true;
+    return *this;
+  }
+
+  /** @brief Returns true if the two systems must not run concurrently. */
+  bool ConflictsWith(const SystemAccess& other) const;
+
+  /** @brief Creates the storage of every declared type in the registry. */
+  void RegisterTypes(Registry& registry) const;
+
+  bool exclusive() const { return exclusive_; }
+  bool main_thread() const { return main_thread_; }
+
+ private:
+  template <typename T>
+  void Add(std::vector<uint32_t>* ids) {
+    ids->push_back(ComponentTypeId<T>());
+    registrars_.push_back(
+        [](Registry& registry) { registry.RegisterComponent<T>(); });
+  }
+
+  std::vector<uint32_t> reads_;
+  std::vector<uint32_t> writes_;
+  std::vector<void (*)(Registry&)> registrars_;
+  bool exclusive_ = false;
+  bool main_thread_ = false;
+};
+
+/**
+ * @brief Orders systems into a dependency graph and dispatches them on the
+ * JobSystem.
+ *
+ * Each system depends on every earlier-registered system it conflicts with.
+ * Systems are grouped into stages by their depth in that graph; the systems
+ * of a stage have no conflicts with each other and run concurrently, and
+ * each stage waits for the previous one. Conflicting systems therefore run in
+ * registration order, exactly as a hand-written serial loop would.
+ *
+ * Structural changes recorded into Registry::commands() are played back at
+ * the end of each stage, ordered by system registration order.
+ *
+ * Every system run starts a new registry tick, and Changed/Added filters
+ * created inside a system default to the tick that system last ran at, so a
+ * system sees exactly the changes made since its previous run.
+ */
+class SystemScheduler {
+ public:
+  /** @brief Signature of a system update. */
+  using SystemFunc = std::function<void(Registry& registry, float dt)>;
+
+  /** @brief Time spent in a system during the last Run(). */
+  struct SystemTiming {
+    std::string name;
+    size_t stage = 0;
+    double milliseconds = 0.0;
+  };
+
+  /**
+   * @brief Registers a system.
+   * @param name Unique name, used for timings and RemoveSystem().
+   * @param access The component types the system touches.
+   * @param func The update function.
+   */
+  void AddSystem(std::string name, SystemAccess access, SystemFunc func);
+
+  /**
+   * @brief Unregisters a system.
+   * @return True if a system with that name existed.
+   */
+  bool RemoveSystem(std::string_view name);
+
+  /** @brief Unregisters every system. */
+  void Clear();
+
+  /**
+   * @brief Runs every system once.
+   *
+   * Must be called from the main thread. Returns once all systems are done.
+   */
+  void Run(Registry& registry, float dt);
+
+  /** @brief Returns the number of registered systems. */
+  size_t system_count() const { return systems_.size(); }
+
+  /** @brief Returns the number of stages the systems are split into. */
+  size_t stage_count();
+
+  /** @brief Returns the per-system breakdown of the last Run(). */
+  const std::vector<SystemTiming>& timings() const { return timings_; }
+
+  /** @brief Returns the wall-clock duration of the last Run(). */
+  double frame_milliseconds() const { return frame_milliseconds_; }
+
+ private:
+  struct System {
+    std::string name;
+    SystemAccess access;
+    SystemFunc func;
+    /** @brief Registry tick the system last started at. */
+    uint32_t last_run = 0;
+  };
+
+  /** @brief Recomputes the stages after systems were added or removed. */
+  void Rebuild();
+
+  /** @brief Runs one system and records its timing. */
+  void RunSystem(size_t index, Registry& registry, float dt);
+
+  std::vector<System> systems_;
+  std::vector<std::vector<size_t>> stages_;
+  std::vector<SystemTiming> timings_;
+  double frame_milliseconds_ = 0.0;
+  bool dirty_ = false;
+};
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_SYSTEM_SCHEDULER_H_
@@ -0,0 +1,89 @@
+/**
+ * @file hierarchy_system.h
+ * @brief System that propagates transforms down Parent relationships.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_SYSTEMS_HIERARCHY_SYSTEM_H_
+#define INCLUDE_ENGINE_ECS_SYSTEMS_HIERARCHY_SYSTEM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <engine/ecs/components/transform.h>
+#include <engine/ecs/registry.h>
+
+namespace engine::ecs::systems {
+
+/**
+ * @brief Keeps the WorldTransform of every entity in a Parent hierarchy up
+ * to date.
+ *
+ * The hierarchy is flattened into one array in depth-first order, so every
+ * parent precedes its children and each subtree is a contiguous range.
+ * Propagation is then a single linear pass. Each node caches its last local
+ * and world transform; a node whose local transform and parent are unchanged
+ * is skipped, so only moved subtrees are recomputed and written.
+ *
+ * The array is rebuilt when a Parent component is added, changed or removed,
+ * or when the system is run on a different registry. Entities whose parent
+ * chain forms a cycle are left out with a warning.
+ *
+ * WorldTransform components are added to and removed from hierarchy members
+ * through Registry::commands(), so new members get theirs at the next
+ * command flush.
+ */
+class HierarchySystem {
+ public:
+  /**
+   * @brief Propagates transforms through the hierarchy.
+   * @param registry The ECS registry.
+   */
+  void Update(Registry* registry);
+
+  /**
+   * @brief Returns the entity followed by all of its descendants in
+   * depth-first order, or an empty span if it is not in a hierarchy.
+   *
+   * The entity's direct children are the entries whose Parent is the entity.
+   * Valid until the next Update().
+   */
+  std::span<const EntityID> Subtree(EntityID entity) const;
+
+  /** @brief Returns the number of entities in a hierarchy. */
+  size_t size() const { return order_.size(); }
+
+ private:
+  /** @brief Parent index of root nodes. */
+  static constexpr uint32_t kRoot = 0xFFFFFFFF;
+
+  struct Node {
+    uint32_t parent;
+    uint32_t subtree_size;
+    components::Transform local;
+    components::Transform world;
+    /** @brief True if the world transform was recomputed this pass. */
+    bool moved;
+    /** @brief True until the node has been propagated once. */
+    bool stale;
+  };
+
+  /** @brief Rebuilds the depth-first array from the Parent components. */
+  void Rebuild(Registry* registry);
+
+  /** @brief Nodes in depth-first order, parallel to `order_`. */
+  std::vector<Node> nodes_;
+  std::vector<EntityID> order_;
+  /** @brief Node position of each entity, indexed by entity index. */
+  std::vector<uint32_t> positions_;
+  /** @brief Registry::id() of the registry the array was built from. */
+  uint64_t registry_id_ = 0;
+  uint32_t last_sync_ = 0;
+  size_t parent_count_ = 0;
+  bool needs_rebuild_ = true;
+};
+
+}  // namespace engine::ecs::systems
+
+#endif  // INCLUDE_ENGINE_ECS_SYSTEMS_HIERARCHY_SYSTEM_H_
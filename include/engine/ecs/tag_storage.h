@@ -0,0 +1,244 @@
+/**
+ * @file tag_storage.h
+ * @brief Bitset storage for tag components, which carry no data.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_TAG_STORAGE_H_
+#define INCLUDE_ENGINE_ECS_TAG_STORAGE_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include <engine/ecs/component_storage.h>
+#include <engine/ecs/entity_manager.h>
+
+namespace engine::ecs {
+
+/**
+ * @brief Base class that marks an empty component type as a tag.
+ *
+ * Derive from it, e.g. `struct Enemy : TagComponent {};`, to store the type
+ * as one bit per entity slot instead of a sparse-set entry. Tags cannot be
+ * used with Changed or Added filters, owned by a group, sorted or recorded
+ * by RewindBuffer, so empty types stay ordinary components unless they opt
+ * in.
+ */
+struct TagComponent {};
+
+/**
+ * @brief Selects the storage of a component type: true for tags.
+ *
+ * True for types derived from TagComponent. Specialize this to opt in
+ * a type that cannot change its bases.
+ */
+template <typename T>
+struct IsTag : std::is_base_of<TagComponent, T> {};
+
+/**
+ * @brief Growable bitset indexed by entity slot.
+ */
+class EntityBitset {
+ public:
+  /** @brief Number of bits per word. */
+  static constexpr size_t kWordBits = 64;
+
+  explicit EntityBitset(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : words_(resource) {}
+
+  /**
+   * @brief Sets the bit of a slot.
+   * @return False if it was already set.
+   */
+  bool Set(uint32_t index) {
+    const size_t word = index / kWordBits;
+    if (word >= words_.size()) {
+      words_.resize(word + 1, 0);
+    }
+    const uint64_t mask = uint64_t{1} << (index % kWordBits);
+    if (words_[word] & mask) {
+      return false;
+    }
+    words_[word] |= mask;
+    ++count_;
+    return true;
+  }
+
+  /**
+   * @brief Clears the bit of a slot.
+   * @return False if it was not set.
+   */
+  bool Reset(uint32_t index) {
+    if (!Test(index)) {
+      return false;
+    }
+    words_[index / kWordBits] &= ~(uint64_t{1} << (index % kWordBits));
+    --count_;
+    return true;
+  }
+
+  /** @brief Returns true if the bit of a slot is set. */
+  bool Test(uint32_t index) const {
+    const size_t word = index / kWordBits;
+    return word < words_.size() &&
+           (words_[word] >> (index % kWordBits) & 1) != 0;
+  }
+
+  /**
+   * @brief Returns the first set slot at or after `index`, or end() if there
+   * is none. Zero words are skipped 64 slots at a time.
+   */
+  size_t NextSet(size_t index) const {
+    size_t word = index / kWordBits;
+    if (word >= words_.size()) {
+      return end();
+    }
+    uint64_t bits = words_[word] & (~uint64_t{0} << (index % kWordBits));
+    while (bits == 0) {
+      if (++word == words_.size()) {
+        return end();
+      }
+      bits = words_[word];
+    }
+    return word * kWordBits + static_cast<size_t>(std::countr_zero(bits));
+  }
+
+  /** @brief Returns one past the highest slot the bitset can hold. */
+  size_t end() const { return words_.size() * kWordBits; }
+
+  /** @brief Returns the number of set bits. */
+  size_t count() const { return count_; }
+
+  /** @brief Returns the bytes allocated for the words. */
+  size_t bytes() const { return words_.capacity() * sizeof(uint64_t); }
+
+  /** @brief Makes room for slots below `size` without reallocating. */
+  void Reserve(size_t size) {
+    words_.reserve((size + kWordBits - 1) / kWordBits);
+  }
+
+  void Clear() {
+    words_.clear();
+    count_ = 0;
+  }
+
+  /**
+   * @brief Returns the underlying words; slot `i` is bit `i % 64` of word
+   * `i / 64`.
+   */
+  const std::pmr::vector<uint64_t>& words() const { return words_; }
+
+ private:
+  std::pmr::vector<uint64_t> words_;
+  size_t count_ = 0;
+};
+
+/**
+ * @brief Storage for a tag component: one bit per entity slot.
+ *
+ * Adding, removing and testing a tag are single bit operations, and walking
+ * every tagged entity scans the bitset a word at a time, so a view driven by
+ * a rare tag skips 64 untagged entities per load. There are no dense arrays
+ * and no change ticks, so tags cannot be used with Changed or Added filters
+ * or owned by a group, and Get() returns the same shared instance for every
+ * entity.
+ *
+ * The bits are keyed by slot index only. The Registry clears an entity's
+ * tags when it is destroyed and checks the handle is alive in
+ * HasComponent(), so stale handles are not reported as tagged there; callers
+ * of Has() on the storage itself must pass live handles.
+ */
+template <typename T>
+class TagStorage final : public IComponentStorage {
+ public:
+  static_assert(std::is_empty_v<T>, "Tag components must be empty types.");
+
+  explicit TagStorage(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : bits_(resource) {}
+
+  /**
+   * @brief Tags the entity. Tagging it again has no effect.
+   *
+   * Takes the same arguments as ComponentStorage::Add() so both storages can
+   * be filled the same way; the component and tick are ignored.
+   */
+  void Add(EntityID entity, T = {}, uint32_t = 0) {
+    if (bits_.Set(GetEntityIndex(entity))) {
+      RunConstructHooks(entity);
+    }
+  }
+
+  /**
+   * @brief Tags the entity; the arguments are ignored.
+   * @return The instance shared by every tagged entity.
+   */
+  template <typename... Args>
+  T& Emplace(EntityID entity, uint32_t, Args&&...) {
+    Add(entity);
+    return value_;
+  }
+
+  /** @brief Returns the instance shared by every tagged entity. */
+  T& Get(EntityID) { return value_; }
+
+  void Remove(EntityID entity) override {
+    if (!Has(entity)) {
+      return;
+    }
+    RunDestroyHooks(entity);
+    bits_.Reset(GetEntityIndex(entity));
+  }
+
+  bool Has(EntityID entity) override {
+    return bits_.Test(GetEntityIndex(entity));
+  }
+
+  void Clear() override { bits_.Clear(); }
+
+  /** @brief Tags carry no change ticks; provided for generic callers. */
+  void MarkChanged(EntityID, uint32_t) {}
+
+  void NotifyRemoved(EntityID entity, Registry* registry) override;
+
+  /** @brief Returns the number of tagged entities. */
+  size_t size() const override { return bits_.count(); }
+  bool empty() const { return bits_.count() == 0; }
+
+  /** @brief Capacity is the number of slots the bitset spans. */
+  StorageStats stats() const override {
+    StorageStats stats;
+    stats.name = TypeName<T>();
+    stats.size = bits_.count();
+    stats.capacity = bits_.end();
+    stats.bytes = bits_.bytes();
+    if (bits_.end() > 0) {
+      stats.sparse_load = static_cast<float>(bits_.count()) /
+                          static_cast<float>(bits_.end());
+    }
+    return stats;
+  }
+
+  /** @brief Makes room for tagging slots below `count`. */
+  void Reserve(size_t count) { bits_.Reserve(count); }
+
+  /** @brief Returns the bits, indexed by entity slot. */
+  const EntityBitset& bits() const { return bits_; }
+
+ private:
+  EntityBitset bits_;
+  [[no_unique_address]] T value_{};
+};
+
+/** @brief The storage class the Registry keeps components of type T in. */
+template <typename T>
+using StorageOf = std::conditional_t<IsTag<T>::value, TagStorage<T>,
+                                     ComponentStorage<T>>;
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_TAG_STORAGE_H_
@@ -0,0 +1,102 @@
+/**
+ * @file type_family.h
+ * @brief Dense per-type integer IDs used to index ECS lookup tables.
+ */
+
+#ifndef INCLUDE_ENGINE_ECS_TYPE_FAMILY_H_
+#define INCLUDE_ENGINE_ECS_TYPE_FAMILY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace engine::ecs {
+
+/**
+ * @brief Hands out sequential IDs to types, one counter per family.
+ *
+ * Every distinct type gets an ID the first time `Id<T>()` is called for it and
+ * keeps it for the rest of the process. IDs start at zero and have no gaps
+ * within a family, so they can index a flat vector directly. After the first
+ * call the lookup is a load of a function-local static.
+ *
+ * @note IDs depend on first-use order and must not be persisted.
+ *
+ * @tparam Family Tag type that separates independent ID spaces.
+ */
+template <typename Family>
+class TypeFamily {
+ public:
+  /** @brief Returns the ID of T within this family. */
+  template <typename T>
+  static uint32_t Id() {
+    static const uint32_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    return id;
+  }
+
+  /** @brief Returns the number of IDs handed out so far. */
+  static uint32_t size() { return next_id_.load(std::memory_order_relaxed); }
+
+ private:
+  static inline std::atomic<uint32_t> next_id_{0};
+};
+
+/** @brief ID space for component types. */
+using ComponentFamily = TypeFamily<struct ComponentFamilyTag>;
+
+/** @brief ID space for event types. */
+using EventFamily = TypeFamily<struct EventFamilyTag>;
+
+/** @brief ID space for resource types. */
+using ResourceFamily = TypeFamily<struct ResourceFamilyTag>;
+
+/** @brief Returns the family ID of a component type, ignoring cv-qualifiers. */
+template <typename T>
+uint32_t ComponentTypeId() {
+  return ComponentFamily::Id<std::remove_cv_t<T>>();
+}
+
+/** @brief Returns the family ID of an event type, ignoring cv-qualifiers. */
+template <typename T>
+uint32_t EventTypeId() {
+  return EventFamily::Id<std::remove_cv_t<T>>();
+}
+
+/** @brief Returns the family ID of a resource type, ignoring cv-qualifiers. */
+template <typename T>
+uint32_t ResourceTypeId() {
+  return ResourceFamily::Id<std::remove_cv_t<T>>();
+}
+
+/**
+ * @brief Returns the name of T without its namespaces, e.g. "Transform", for
+ * diagnostics. Template arguments keep theirs.
+ */
+template <typename T>
+std::string_view TypeName() {
+#if defined(_MSC_VER)
+  std::string_view name = __FUNCSIG__;
+  const size_t begin = name.find("TypeName<") + 9;
+  name = name.substr(begin, name.rfind(">(void)") - begin);
+#else
+  std::string_view name = __PRETTY_FUNCTION__;
+  const size_t begin = name.find("T = ") + 4;
+  name = name.substr(begin, name.find_first_of(";]", begin) - begin);
+#endif
+  const size_t qualified = name.substr(0, name.find('<')).rfind("::");
+  if (qualified != std::string_view::npos) {
+    name.remove_prefix(qualified + 2);
+  }
+  for (std::string_view keyword : {"struct ", "class ", "enum "}) {
+    if (name.starts_with(keyword)) {
+      name.remove_prefix(keyword.size());
+    }
+  }
+  return name;
+}
+
+}  // namespace engine::ecs
+
+#endif  // INCLUDE_ENGINE_ECS_TYPE_FAMILY_H_
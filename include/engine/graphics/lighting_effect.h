@@ -6,6 +6,8 @@
 #ifndef INCLUDE_ENGINE_GRAPHICS_LIGHTING_EFFECT_H_
 #define INCLUDE_ENGINE_GRAPHICS_LIGHTING_EFFECT_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -49,12 +51,43 @@ class LightingEffect : public IPostProcessEffect {
              Framebuffer* output_framebuffer) override;
   std::string GetName() const override { return "LightingEffect"; }
 
-  void AddLight(const Light& light) { lights_.push_back(light); }
-  void ClearLights() { lights_.clear(); }
+  /** @brief Key of lights that were added without one. */
+  static constexpr uint32_t kNoKey = 0xFFFFFFFF;
+
+  void AddLight(const Light& light, uint32_t key = kNoKey) {
+    lights_.push_back(light);
+    light_keys_.push_back(key);
+  }
+  /**
+   * @brief Grows or shrinks the light list to `count`; new lights are
+   * default-constructed and keyed kNoKey.
+   */
+  void ResizeLights(size_t count) {
+    lights_.resize(count);
+    light_keys_.resize(count, kNoKey);
+  }
+  /** @brief Replaces the light at `index` and the key it was set under. */
+  void SetLight(size_t index, const Light& light, uint32_t key) {
+    lights_[index] = light;
+    light_keys_[index] = key;
+  }
+  void SetLightPosition(size_t index, const glm::vec2& position) {
+    lights_[index].position = position;
+  }
+  uint32_t light_key(size_t index) const { return light_keys_[index]; }
+  void ClearLights() {
+    lights_.clear();
+    light_keys_.clear();
+  }
+  size_t light_count() const { return lights_.size(); }
 
   void AddOccluder(const Occluder& occluder) { occluders_.push_back(occluder); }
   void ClearOccluders() { occluders_.clear(); }
 
+  /** @brief Registry tick UpdateLightingSystem() last synced this effect at. */
+  uint32_t sync_tick() const { return sync_tick_; }
+  void set_sync_tick(uint32_t tick) { sync_tick_ = tick; }
+
   void SetAmbientLight(const glm::vec3& color, float intensity) {
     ambient_color_ = color;
     ambient_intensity_ = intensity;
@@ -70,6 +103,9 @@ class LightingEffect : public IPostProcessEffect {
 
   std::vector<Light> lights_;
   std::vector<Occluder> occluders_;
+  /** @brief Keys of the lights, parallel to `lights_`. */
+  std::vector<uint32_t> light_keys_;
+  uint32_t sync_tick_ = 0;
 
   std::shared_ptr<Shader> lighting_shader_;
   std::shared_ptr<Shader> occluder_shader_;
@@ -9,6 +9,7 @@
 #include <string>
 
 #include <engine/ecs/registry.h>
+#include <engine/scene/scene_arena.h>
 
 namespace engine {
 
@@ -23,7 +24,10 @@ class Scene {
    * @brief Constructs a new Scene.
    * @param name The debug name of the scene.
    */
-  Scene(const std::string& name) : debug_name_(name) {}
+  Scene(const std::string& name)
+      : debug_name_(name),
+        arena_(SceneArena::Acquire()),
+        registry_(ecs::StorageMode::kSparseSet, arena_->resource()) {}
 
   /** @brief Virtual destructor. */
   virtual ~Scene() = default;
@@ -70,6 +74,11 @@ class Scene {
  protected:
   /** @brief The debug name of the scene. */
   std::string debug_name_;
+  /**
+   * @brief Memory the registry's storages and event queues come from.
+   * Declared before the registry so it is released after it.
+   */
+  SceneArena::Handle arena_;
   /** @brief The ECS registry for this scene. */
   ecs::Registry registry_;
 };
@@ -0,0 +1,100 @@
+/**
+ * @file scene_arena.h
+ * @brief Recyclable memory arena backing a scene's registry.
+ */
+
+#ifndef INCLUDE_ENGINE_SCENE_SCENE_ARENA_H_
+#define INCLUDE_ENGINE_SCENE_SCENE_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace engine {
+
+/**
+ * @brief Memory resource a scene's registry allocates its component storages
+ * and event queues from.
+ *
+ * Allocations are served by a synchronized pool on top of a monotonic
+ * buffer: blocks freed while the scene runs are recycled by the pool, and
+ * nothing is handed back to the heap piece by piece. Reset() drops every
+ * allocation at once. If the last scene outgrew the buffer, Reset() enlarges
+ * it to what that scene used, so a recycled arena usually serves the next
+ * scene from a single block.
+ *
+ * Scenes get their arena from Acquire() and return it when destroyed, after
+ * their registry, so consecutive scenes reuse the same memory.
+ */
+class SceneArena {
+ public:
+  /** @brief Size of the buffer a new arena starts with. */
+  static constexpr size_t kInitialBytes = size_t{1} << 20;
+
+  /** @brief Resets arenas and keeps them for the next Acquire(). */
+  struct Recycler {
+    void operator()(SceneArena* arena) const;
+  };
+
+  /** @brief Owning handle that recycles the arena instead of deleting it. */
+  using Handle = std::unique_ptr<SceneArena, Recycler>;
+
+  /** @brief Returns an empty arena, reusing a recycled one if available. */
+  static Handle Acquire();
+
+  explicit SceneArena(size_t initial_bytes = kInitialBytes);
+  ~SceneArena();
+
+  SceneArena(const SceneArena&) = delete;
+  SceneArena& operator=(const SceneArena&) = delete;
+
+  /** @brief Returns the thread-safe resource to allocate from. */
+  std::pmr::memory_resource* resource() { return &*pool_; }
+
+  /**
+   * @brief Releases every allocation in one step.
+   * @note Everything allocated from the arena must have been destroyed.
+   */
+  void Reset();
+
+  /** @brief Returns the size of the arena's own buffer. */
+  size_t buffer_size() const { return buffer_size_; }
+
+  /**
+   * @brief Returns the bytes taken from the heap beyond the buffer since the
+   * last Reset().
+   */
+  size_t overflow_bytes() const { return overflow_.allocated(); }
+
+ private:
+  /** @brief Heap resource that counts what the monotonic buffer asks for. */
+  class OverflowResource final : public std::pmr::memory_resource {
+   public:
+    size_t allocated() const { return allocated_; }
+    void reset() { allocated_ = 0; }
+
+   private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+
+    size_t allocated_ = 0;
+  };
+
+  /** @brief (Re)creates the buffer and the resources on top of it. */
+  void Build(size_t bytes);
+
+  size_t buffer_size_ = 0;
+  std::unique_ptr<std::byte[]> buffer_;
+  OverflowResource overflow_;
+  std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+  std::optional<std::pmr::synchronized_pool_resource> pool_;
+};
+
+}  // namespace engine
+
+#endif  // INCLUDE_ENGINE_SCENE_SCENE_ARENA_H_
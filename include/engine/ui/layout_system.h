@@ -8,6 +8,7 @@
 
 #include <glm/glm.hpp>
 
+#include <engine/ecs/components/ui_transform.h>
 #include <engine/ecs/entity_manager.h>
 #include <engine/ecs/registry.h>
 
@@ -15,12 +16,27 @@ namespace engine::ui {
 
 /**
  * @brief Handles hierarchical layout propagation and anchoring.
+ *
+ * Only subtrees rooted at a node that is flagged `is_dirty`, or whose global
+ * position no longer follows from its anchor, offset and parent (or window)
+ * rectangle, are laid out again.
  */
 class UiLayoutSystem {
  public:
   static void Update(ecs::Registry& reg, int window_width, int window_height);
 
  private:
+  /**
+   * @brief Returns where `ui` belongs inside a parent rectangle; both the
+   * layout and its up-to-date check use this, so they agree exactly.
+   */
+  static glm::vec2 LayoutPosition(
+      const ecs::components::UiTransform& ui,
+      const glm::vec2& parent_global_pos, const glm::vec2& parent_size);
+
+  /** @brief Returns the UI parent of the entity, or kInvalidEntity. */
+  static ecs::EntityID GetParent(ecs::Registry& reg, ecs::EntityID entity);
+
   static void UpdateBranch(ecs::Registry& reg, ecs::EntityID entity,
                            const glm::vec2& parent_global_pos,
                            const glm::vec2& parent_size);
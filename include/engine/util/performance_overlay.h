@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include <engine/ecs/registry_stats.h>
 #include <engine/input/input_manager.h>
 
 namespace engine::util {
@@ -56,7 +57,11 @@ class PerformanceOverlay {
 
   double ram_usage_mb_ = 0.0;
 
+  /** @brief The active scene's registry report, refreshed once a second. */
+  ecs::RegistryStats registry_stats_;
+
   void UpdateSystemMetrics();
+  void UpdateRegistryStats();
 };
 
 }  // namespace engine::util
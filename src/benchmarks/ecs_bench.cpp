@@ -0,0 +1,277 @@
+/**
+ * @file ecs_bench.cpp
+ * @brief Microbenchmarks of the core Registry operations.
+ *
+ * Every benchmark runs at 1k, 10k, 100k and 1M entities. Unless
+ * `--benchmark_out` is given, results are also written as JSON to
+ * `ecs_bench.json` in the working directory, so runs before and after a
+ * storage change can be compared with Google Benchmark's compare.py.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <engine/ecs/registry.h>
+
+namespace engine::ecs {
+namespace {
+
+struct Position {
+  float x, y;
+};
+
+struct Velocity {
+  float vx, vy;
+};
+
+struct Health {
+  int value;
+};
+
+/** @brief Distinct component types, to spread entities over many storages. */
+template <int I>
+struct Padding {
+  uint32_t value;
+};
+
+struct Ping {
+  uint32_t value;
+};
+
+struct PingListener : events::IEventListener<Ping> {
+  void OnEvent(const Ping& event) override { sum += event.value; }
+  uint64_t sum = 0;
+};
+
+constexpr int kManyStorages = 16;
+
+/** @brief Creates `count` entities with Position, Velocity and Health. */
+std::vector<EntityID> Populate(Registry& registry, size_t count) {
+  std::vector<EntityID> entities = registry.CreateEntities(count);
+  for (size_t i = 0; i < count; ++i) {
+    registry.AddComponent<Position>(entities[i], {float(i), 0.0f});
+    registry.AddComponent<Velocity>(entities[i], {1.0f, 1.0f});
+    registry.AddComponent<Health>(entities[i], {100});
+  }
+  return entities;
+}
+
+template <int... Is>
+void AddPadding(Registry& registry, EntityID entity,
+                std::integer_sequence<int, Is...>) {
+  (registry.AddComponent<Padding<Is>>(entity, {uint32_t(Is)}), ...);
+}
+
+void BM_CreateDestroyEntities(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  Registry registry;
+  std::vector<EntityID> entities(count);
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; ++i) {
+      entities[i] = registry.CreateEntity();
+    }
+    for (EntityID entity : entities) {
+      registry.DeleteEntity(entity);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_AddRemoveComponent(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  Registry registry;
+  const std::vector<EntityID> entities = registry.CreateEntities(count);
+  for (auto _ : state) {
+    for (EntityID entity : entities) {
+      registry.AddComponent<Position>(entity, {0.0f, 0.0f});
+    }
+    for (EntityID entity : entities) {
+      registry.RemoveComponent<Position>(entity);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_ViewIterate1(benchmark::State& state) {
+  Registry registry;
+  Populate(registry, static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    registry.GetView<Position>().Each(
+        [](EntityID, Position& p) { benchmark::DoNotOptimize(p.x += 1.0f); });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ViewIterate2(benchmark::State& state) {
+  Registry registry;
+  Populate(registry, static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    registry.GetView<Position, Velocity>().Each(
+        [](EntityID, Position& p, Velocity& v) {
+          p.x += v.vx;
+          benchmark::DoNotOptimize(p.y += v.vy);
+        });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ViewIterate3(benchmark::State& state) {
+  Registry registry;
+  Populate(registry, static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    registry.GetView<Position, Velocity, Health>().Each(
+        [](EntityID, Position& p, Velocity& v, Health& h) {
+          p.x += v.vx;
+          benchmark::DoNotOptimize(h.value -= 1);
+        });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ForEach(benchmark::State& state) {
+  Registry registry;
+  Populate(registry, static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    registry.ForEach<Position, Velocity>([](Position& p, Velocity& v) {
+      p.x += v.vx;
+      benchmark::DoNotOptimize(p.y += v.vy);
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/**
+ * @brief Re-sorts a storage by a key that changes for 1% of the entities per
+ * iteration, as sprite layers or spatial codes do between frames.
+ */
+void BM_SortIncremental(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  Registry registry;
+  const std::vector<EntityID> entities = Populate(registry, count);
+  auto by_x = [](const Position& a, const Position& b) { return a.x < b.x; };
+  registry.Sort<Position>(by_x);
+  size_t next = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < count / 100; ++i) {
+      next = (next + 7919) % count;
+      registry.GetComponent<Position>(entities[next]).x += 1.5f;
+    }
+    registry.SortIncremental<Position>(by_x);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+/**
+ * @brief Drains an observer after 1% of the entities changed, as an
+ * incremental system does each frame; compare with BM_ViewIterate1, the cost
+ * of scanning every entity for changes.
+ */
+void BM_ObserverDrain(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  Registry registry;
+  const std::vector<EntityID> entities = Populate(registry, count);
+  auto observer = registry.GetObserver<OnChanged<Position>>();
+  size_t next = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < count / 100; ++i) {
+      next = (next + 7919) % count;
+      registry.PatchComponent<Position>(entities[next],
+                                        [](Position& p) { p.x += 1.0f; });
+    }
+    observer.Drain([&registry](EntityID entity) {
+      benchmark::DoNotOptimize(registry.GetComponent<Position>(entity).x);
+    });
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_DeleteEntityManyStorages(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  Registry registry;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const std::vector<EntityID> entities = registry.CreateEntities(count);
+    for (EntityID entity : entities) {
+      AddPadding(registry, entity,
+                 std::make_integer_sequence<int, kManyStorages>{});
+    }
+    state.ResumeTiming();
+    for (EntityID entity : entities) {
+      registry.DeleteEntity(entity);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_PublishImmediate(benchmark::State& state) {
+  const uint32_t count = static_cast<uint32_t>(state.range(0));
+  Registry registry;
+  PingListener listener;
+  registry.Subscribe<Ping>(&listener);
+  for (auto _ : state) {
+    for (uint32_t i = 0; i < count; ++i) {
+      registry.Publish<Ping>({i});
+    }
+  }
+  benchmark::DoNotOptimize(listener.sum);
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_PublishQueued(benchmark::State& state) {
+  const uint32_t count = static_cast<uint32_t>(state.range(0));
+  Registry registry;
+  PingListener listener;
+  registry.Subscribe<Ping>(&listener);
+  for (auto _ : state) {
+    for (uint32_t i = 0; i < count; ++i) {
+      registry.Publish<Ping>({i}, false);
+    }
+    registry.Update();
+  }
+  benchmark::DoNotOptimize(listener.sum);
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+#define ECS_BENCHMARK(func) \
+  BENCHMARK(func)->RangeMultiplier(10)->Range(1000, 1000000)
+
+ECS_BENCHMARK(BM_CreateDestroyEntities);
+ECS_BENCHMARK(BM_AddRemoveComponent);
+ECS_BENCHMARK(BM_ViewIterate1);
+ECS_BENCHMARK(BM_ViewIterate2);
+ECS_BENCHMARK(BM_ViewIterate3);
+ECS_BENCHMARK(BM_ForEach);
+ECS_BENCHMARK(BM_SortIncremental);
+ECS_BENCHMARK(BM_ObserverDrain);
+ECS_BENCHMARK(BM_DeleteEntityManyStorages);
+ECS_BENCHMARK(BM_PublishImmediate);
+ECS_BENCHMARK(BM_PublishQueued);
+
+}  // namespace
+}  // namespace engine::ecs
+
+int main(int argc, char** argv) {
+  std::vector<char*> args(argv, argv + argc);
+  bool has_out = false;
+  for (int i = 1; i < argc; ++i) {
+    has_out |= std::string(argv[i]).starts_with("--benchmark_out=");
+  }
+  std::string out = "--benchmark_out=ecs_bench.json";
+  std::string format = "--benchmark_out_format=json";
+  if (!has_out) {
+    args.push_back(out.data());
+    args.push_back(format.data());
+  }
+  int count = static_cast<int>(args.size());
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
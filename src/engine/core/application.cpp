@@ -11,9 +11,25 @@
 #include <engine/core/engine.h>
 #include <engine/core/job_system.h>
 #include <engine/core/window.h>
+#include <engine/ecs/components/animation.h>
+#include <engine/ecs/components/behavior_tree.h>
+#include <engine/ecs/components/camera_component.h>
+#include <engine/ecs/components/collider.h>
+#include <engine/ecs/components/gravity.h>
+#include <engine/ecs/components/lifetime.h>
+#include <engine/ecs/components/parent.h>
 #include <engine/ecs/components/particle_emitter.h>
+#include <engine/ecs/components/sprite.h>
+#include <engine/ecs/components/state_machine.h>
+#include <engine/ecs/components/transform.h>
+#include <engine/ecs/components/ui_hierarchy.h>
+#include <engine/ecs/components/ui_transform.h>
+#include <engine/ecs/components/velocity.h>
+#include <engine/ecs/components/waypoint_path.h>
+#include <engine/ecs/components/world_transform.h>
 #include <engine/ecs/systems/ai_system.h>
 #include <engine/ecs/systems/camera_system.h>
+#include <engine/ecs/systems/hierarchy_system.h>
 #include <engine/ecs/systems/physics_system.h>
 #include <engine/ecs/systems/script_system.h>
 #include <engine/graphics/camera.h>
@@ -62,6 +78,7 @@ void Application::Run() {
   ImGui_ImplGlfw_InitForOpenGL(win.native_handle(), true);
   ImGui_ImplOpenGL3_Init("#version 330");
 
+  RegisterEngineSystems();
   OnInit();
   InputManager& input = input_manager();
   main_camera_ = std::make_unique<engine::graphics::Camera>(
@@ -113,33 +130,7 @@ void Application::Run() {
       ecs::systems::ScriptSystem::Init(&reg);
 
       if (!util::Console::Get().IsPaused()) {
-        // Scripting System (Update logic before physics)
-        ecs::systems::ScriptSystem::Update(&reg,
-                                           static_cast<float>(delta_time));
-
-        // AI System (Animations, Lifetime, Pathing)
-        ecs::systems::AISystem::Update(&reg, static_cast<float>(delta_time));
-
-        // Engine Core Systems
-        ecs::systems::PhysicsSystem::Update(&reg,
-                                            static_cast<float>(delta_time));
-
-        // Sync Camera
-        ecs::systems::CameraSystem::Update(&reg);
-
-        // Particle Systems
-        reg.ForEach<engine::ecs::components::ParticleEmitter>(
-            [dt = static_cast<float>(delta_time)](
-                engine::ecs::components::ParticleEmitter& pec) {
-              if (pec.is_active) {
-                pec.system.Update(dt);
-              }
-            });
-
-        // UI Systems
-        ui::UiSyncSystem::Update(reg);
-        ui::UiInputSystem::Update(reg);
-        ui::UiLayoutSystem::Update(reg, win.width(), win.height());
+        systems_.Run(reg, static_cast<float>(delta_time));
       }
     }
 
@@ -194,4 +185,74 @@ void Application::Run() {
   Engine::Shutdown();
 }
 
+void Application::RegisterEngineSystems() {
+  using namespace engine::ecs::components;
+
+  // Scripting System (Update logic before physics). Lua is single threaded.
+  systems_.AddSystem("Script", ecs::SystemAccess().Exclusive().MainThread(),
+                     [](ecs::Registry& reg, float dt) {
+                       ecs::systems::ScriptSystem::Update(&reg, dt);
+                     });
+
+  // AI System (Animations, Lifetime, Pathing). Plays back its own deferred
+  // deletions mid-update, so it runs alone.
+  systems_.AddSystem("AI", ecs::SystemAccess().Exclusive(),
+                     [](ecs::Registry& reg, float dt) {
+                       ecs::systems::AISystem::Update(&reg, dt);
+                     });
+
+  // Engine Core Systems. Physics invokes Collider::on_collision game
+  // callbacks, which may add or remove components, so it runs alone.
+  systems_.AddSystem("Physics", ecs::SystemAccess().Exclusive().MainThread(),
+                     [](ecs::Registry& reg, float dt) {
+                       ecs::systems::PhysicsSystem::Update(&reg, dt);
+                     });
+
+  // Transform Hierarchy (after everything that moves entities)
+  systems_.AddSystem(
+      "Hierarchy",
+      ecs::SystemAccess().Reads<Parent, Transform>().Writes<WorldTransform>(),
+      [hierarchy = std::make_shared<ecs::systems::HierarchySystem>()](
+          ecs::Registry& reg, float) { hierarchy->Update(&reg); });
+
+  // Sync Camera
+  systems_.AddSystem(
+      "Camera",
+      ecs::SystemAccess()
+          .Reads<CameraComponent, Transform, WorldTransform>()
+          .MainThread(),
+      [](ecs::Registry& reg, float) {
+        ecs::systems::CameraSystem::Update(&reg);
+      });
+
+  // Particle Systems (each emitter owns its particles, so they can be
+  // simulated in parallel one emitter per batch)
+  systems_.AddSystem("Particles", ecs::SystemAccess().Writes<ParticleEmitter>(),
+                     [](ecs::Registry& reg, float dt) {
+                       reg.ParallelForEach<ParticleEmitter>(
+                           [dt](ParticleEmitter& pec) {
+                             if (pec.is_active) {
+                               pec.system.Update(dt);
+                             }
+                           },
+                           1);
+                     });
+
+  // UI Systems. Sync and input invoke game callbacks.
+  systems_.AddSystem("UiSync", ecs::SystemAccess().Exclusive().MainThread(),
+                     [](ecs::Registry& reg, float) {
+                       ui::UiSyncSystem::Update(reg);
+                     });
+  systems_.AddSystem("UiInput", ecs::SystemAccess().Exclusive().MainThread(),
+                     [](ecs::Registry& reg, float) {
+                       ui::UiInputSystem::Update(reg);
+                     });
+  systems_.AddSystem(
+      "UiLayout",
+      ecs::SystemAccess().Reads<UiHierarchy>().Writes<UiTransform>(),
+      [&win = window()](ecs::Registry& reg, float) {
+        ui::UiLayoutSystem::Update(reg, win.width(), win.height());
+      });
+}
+
 }  // namespace engine
@@ -8,6 +8,10 @@
 
 namespace engine::core {
 
+namespace {
+thread_local size_t t_thread_index = 0;
+}  // namespace
+
 JobSystem::~JobSystem() { Shutdown(); }
 
 void JobSystem::Init() {
@@ -21,7 +25,7 @@ void JobSystem::Init() {
 
   stop_ = false;
   for (unsigned int i = 0; i < num_threads; ++i) {
-    workers_.emplace_back(&JobSystem::WorkerLoop, this);
+    workers_.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
   }
 }
 
@@ -48,13 +52,16 @@ bool JobSystem::IsMainThread() const {
   return std::this_thread::get_id() == main_thread_id_;
 }
 
+size_t JobSystem::GetThreadIndex() { return t_thread_index; }
+
 void JobSystem::Wait() {
   std::unique_lock<std::mutex> lock(queue_mutex_);
   wait_condition_.wait(lock,
                        [this]() { return tasks_.empty() && busy_tasks_ == 0; });
 }
 
-void JobSystem::WorkerLoop() {
+void JobSystem::WorkerLoop(size_t thread_index) {
+  t_thread_index = thread_index;
   while (true) {
     std::function<void()> task;
     {
@@ -53,6 +53,34 @@ TEST_F(JobSystemTest, WaitFunctionality) {
   EXPECT_EQ(counter.load(), num_tasks);
 }
 
+TEST_F(JobSystemTest, ParallelForCoversEveryIndexOnce) {
+  const size_t count = 10007;
+  std::vector<std::atomic<int>> hits(count);
+
+  JobSystem::Get().ParallelFor(count, 64, [&hits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      hits[i]++;
+    }
+  });
+
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(hits[i].load(), 1) << "index " << i;
+  }
+}
+
+TEST_F(JobSystemTest, ParallelForRunsInlineWithoutWorkers) {
+  JobSystem::Get().Shutdown();
+  EXPECT_EQ(JobSystem::Get().worker_count(), 0u);
+
+  size_t calls = 0;
+  JobSystem::Get().ParallelFor(1000, 10, [&calls](size_t begin, size_t end) {
+    EXPECT_EQ(begin, 0u);
+    EXPECT_EQ(end, 1000u);
+    calls++;
+  });
+  EXPECT_EQ(calls, 1u);
+}
+
 TEST_F(JobSystemTest, IsMainThread) {
   // Since the test runs on the thread that initialized the JobSystem (in
   // SetUp), IsMainThread() should return true.
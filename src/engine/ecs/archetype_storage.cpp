@@ -0,0 +1,250 @@
+/**
+ * @file archetype_storage.cpp
+ * @brief Archetype and ArchetypeStorage implementation.
+ */
+
+#include <algorithm>
+
+#include <engine/ecs/archetype_storage.h>
+
+namespace engine::ecs {
+
+namespace {
+
+size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+Archetype::Archetype(std::vector<uint32_t> signature,
+                     std::vector<const ComponentTypeInfo*> types)
+    : signature_(std::move(signature)), types_(std::move(types)) {
+  if (!signature_.empty()) {
+    column_of_.assign(signature_.back() + 1, -1);
+  }
+  size_t row_bytes = sizeof(EntityID);
+  chunk_alignment_ = std::max(alignof(std::max_align_t), alignof(EntityID));
+  for (size_t column = 0; column < signature_.size(); ++column) {
+    column_of_[signature_[column]] = static_cast<int>(column);
+    row_bytes += types_[column]->size;
+    chunk_alignment_ = std::max(chunk_alignment_, types_[column]->alignment);
+  }
+
+  // Fit as many rows as possible into one chunk, accounting for the padding
+  // needed to align each column. Oversized rows get a single-row chunk.
+  column_offsets_.resize(signature_.size());
+  chunk_capacity_ = std::max<size_t>(1, kChunkSize / row_bytes);
+  while (true) {
+    size_t offset = chunk_capacity_ * sizeof(EntityID);
+    for (size_t column = 0; column < signature_.size(); ++column) {
+      offset = AlignUp(offset, types_[column]->alignment);
+      column_offsets_[column] = offset;
+      offset += chunk_capacity_ * types_[column]->size;
+    }
+    if (offset <= kChunkSize || chunk_capacity_ == 1) {
+      chunk_bytes_ = std::max(offset, kChunkSize);
+      break;
+    }
+    --chunk_capacity_;
+  }
+}
+
+Archetype::~Archetype() {
+  for (uint32_t row = 0; row < size_; ++row) {
+    for (size_t column = 0; column < types_.size(); ++column) {
+      types_[column]->destroy(ComponentAt(row, static_cast<int>(column)));
+    }
+  }
+}
+
+uint32_t Archetype::AllocateRow(EntityID entity) {
+  if (size_ == chunks_.size() * chunk_capacity_) {
+    auto* memory = static_cast<std::byte*>(
+        ::operator new[](chunk_bytes_, std::align_val_t(chunk_alignment_)));
+    chunks_.emplace_back(memory, ChunkDeleter{chunk_alignment_});
+  }
+  const uint32_t row = static_cast<uint32_t>(size_++);
+  ChunkEntities(row / chunk_capacity_)[row % chunk_capacity_] = entity;
+  return row;
+}
+
+EntityID Archetype::RemoveRow(uint32_t row) {
+  const uint32_t last = static_cast<uint32_t>(size_ - 1);
+  for (size_t column = 0; column < types_.size(); ++column) {
+    types_[column]->destroy(ComponentAt(row, static_cast<int>(column)));
+  }
+
+  EntityID moved = kInvalidEntity;
+  if (row != last) {
+    for (size_t column = 0; column < types_.size(); ++column) {
+      void* src = ComponentAt(last, static_cast<int>(column));
+      types_[column]->move_construct(ComponentAt(row, static_cast<int>(column)),
+                                     src);
+      types_[column]->destroy(src);
+    }
+    moved = EntityAt(last);
+    ChunkEntities(row / chunk_capacity_)[row % chunk_capacity_] = moved;
+  }
+
+  --size_;
+  // Release the trailing chunk once it no longer holds any rows.
+  if (size_ <= (chunks_.size() - 1) * chunk_capacity_) {
+    chunks_.pop_back();
+  }
+  return moved;
+}
+
+ArchetypeStorage::ArchetypeStorage() { root_ = FindOrCreate({}); }
+
+ArchetypeStorage::~ArchetypeStorage() = default;
+
+void ArchetypeStorage::RemoveEntity(EntityID entity) {
+  Location* location = Find(entity);
+  if (!location) {
+    return;
+  }
+  EraseRow(location->archetype, location->row);
+  location->archetype = nullptr;
+}
+
+void ArchetypeStorage::CollectMatching(const std::vector<uint32_t>& type_ids,
+                                       std::vector<Archetype*>* out) const {
+  for (const auto& [signature, archetype] : archetypes_) {
+    if (archetype->size() == 0) {
+      continue;
+    }
+    bool matches = true;
+    for (uint32_t type_id : type_ids) {
+      if (archetype->ColumnOf(type_id) < 0) {
+        matches = false;
+        break;
+      }
+    }
+    if (matches) {
+      out->push_back(archetype.get());
+    }
+  }
+}
+
+size_t ArchetypeStorage::chunk_count() const {
+  size_t count = 0;
+  for (const auto& [signature, archetype] : archetypes_) {
+    count += archetype->chunk_count();
+  }
+  return count;
+}
+
+size_t ArchetypeStorage::chunk_bytes() const {
+  size_t bytes = 0;
+  for (const auto& [signature, archetype] : archetypes_) {
+    bytes += archetype->chunk_count() * archetype->chunk_bytes();
+  }
+  return bytes;
+}
+
+void ArchetypeStorage::Clear() {
+  archetypes_.clear();
+  locations_.clear();
+  root_ = FindOrCreate({});
+}
+
+ArchetypeStorage::Location& ArchetypeStorage::AssureLocation(EntityID entity) {
+  const uint32_t index = GetEntityIndex(entity);
+  if (index >= locations_.size()) {
+    locations_.resize(index + 1);
+  }
+  return locations_[index];
+}
+
+Archetype* ArchetypeStorage::AddTransition(Archetype* from, uint32_t type_id) {
+  if (!from) {
+    from = root_;
+  }
+  auto it = from->add_edges().find(type_id);
+  if (it != from->add_edges().end()) {
+    return it->second;
+  }
+  std::vector<uint32_t> signature = from->signature();
+  signature.insert(
+      std::lower_bound(signature.begin(), signature.end(), type_id), type_id);
+  Archetype* target = FindOrCreate(std::move(signature));
+  from->add_edges()[type_id] = target;
+  target->remove_edges()[type_id] = from;
+  return target;
+}
+
+Archetype* ArchetypeStorage::RemoveTransition(Archetype* from,
+                                              uint32_t type_id) {
+  auto it = from->remove_edges().find(type_id);
+  if (it != from->remove_edges().end()) {
+    return it->second;
+  }
+  std::vector<uint32_t> signature = from->signature();
+  signature.erase(
+      std::lower_bound(signature.begin(), signature.end(), type_id));
+  Archetype* target = FindOrCreate(std::move(signature));
+  from->remove_edges()[type_id] = target;
+  target->add_edges()[type_id] = from;
+  return target;
+}
+
+Archetype* ArchetypeStorage::FindOrCreate(std::vector<uint32_t> signature) {
+  auto it = archetypes_.find(signature);
+  if (it != archetypes_.end()) {
+    return it->second.get();
+  }
+  std::vector<const ComponentTypeInfo*> types;
+  types.reserve(signature.size());
+  for (uint32_t type_id : signature) {
+    types.push_back(types_[type_id].get());
+  }
+  auto archetype = std::make_unique<Archetype>(signature, std::move(types));
+  Archetype* result = archetype.get();
+  archetypes_.emplace(std::move(signature), std::move(archetype));
+  return result;
+}
+
+void ArchetypeStorage::RemoveType(EntityID entity, uint32_t type_id) {
+  Location* location = Find(entity);
+  if (!location || location->archetype->ColumnOf(type_id) < 0) {
+    return;
+  }
+  Archetype* target = RemoveTransition(location->archetype, type_id);
+  if (target == root_) {
+    EraseRow(location->archetype, location->row);
+    location->archetype = nullptr;
+    return;
+  }
+  MoveEntity(entity, target);
+}
+
+void ArchetypeStorage::MoveEntity(EntityID entity, Archetype* target) {
+  Location& location = locations_[GetEntityIndex(entity)];
+  Archetype* source = location.archetype;
+  const uint32_t new_row = target->AllocateRow(entity);
+  if (source) {
+    for (int column = 0; column < static_cast<int>(source->signature().size());
+         ++column) {
+      int target_column = target->ColumnOf(source->signature()[column]);
+      if (target_column >= 0) {
+        source->type(column).move_construct(
+            target->ComponentAt(new_row, target_column),
+            source->ComponentAt(location.row, column));
+      }
+    }
+    // Destroys the moved-from values along with any dropped component.
+    EraseRow(source, location.row);
+  }
+  location.archetype = target;
+  location.row = new_row;
+}
+
+void ArchetypeStorage::EraseRow(Archetype* archetype, uint32_t row) {
+  EntityID moved = archetype->RemoveRow(row);
+  if (moved != kInvalidEntity) {
+    locations_[GetEntityIndex(moved)].row = row;
+  }
+}
+
+}  // namespace engine::ecs
@@ -69,7 +69,7 @@ void ECSBindings::BindComponents(sol::state& lua) {
   };
   lua["add_sprite"] = [&lua](EntityID entity, const std::string& texture) {
     Registry* reg = lua["registry"];
-    reg->AddComponent(entity, engine::ecs::components::Sprite{texture});
+    reg->EmplaceComponent<engine::ecs::components::Sprite>(entity, texture);
   };
 
   lua["get_velocity"] =
@@ -93,7 +93,8 @@ void ECSBindings::BindComponents(sol::state& lua) {
       &engine::ecs::components::UiTransform::size, "anchor_min",
       &engine::ecs::components::UiTransform::anchor_min, "anchor_max",
       &engine::ecs::components::UiTransform::anchor_max, "z_index",
-      &engine::ecs::components::UiTransform::z_index);
+      &engine::ecs::components::UiTransform::z_index, "is_dirty",
+      &engine::ecs::components::UiTransform::is_dirty);
 
   lua.new_usertype<engine::ecs::components::UiInteractable>(
       "UiInteractableComponent", "is_hovered",
@@ -0,0 +1,183 @@
+/**
+ * @file entity_command_buffer.cpp
+ * @brief EntityCommandBuffer implementation.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include <engine/ecs/entity_command_buffer.h>
+#include <engine/ecs/registry.h>
+#include <engine/util/logger.h>
+
+namespace engine::ecs {
+
+EntityCommandBuffer::EntityCommandBuffer(
+    std::atomic<uint32_t>* placeholder_counter)
+    : placeholder_counter_(placeholder_counter ? placeholder_counter
+                                               : &own_counter_) {}
+
+EntityCommandBuffer::~EntityCommandBuffer() { ReleasePayloads(&commands_); }
+
+EntityID EntityCommandBuffer::CreateEntity() {
+  const uint32_t slot =
+      placeholder_counter_->fetch_add(1, std::memory_order_relaxed);
+  if (slot >= kEntityIndexMask) {
+    LOG_ERR("EntityCommandBuffer is out of placeholder handles.");
+    return kInvalidEntity;
+  }
+  const EntityID placeholder = MakeEntityID(slot, kPlaceholderGeneration);
+  Record(Op::kCreate, placeholder, nullptr, nullptr);
+  return placeholder;
+}
+
+void EntityCommandBuffer::DeleteEntity(EntityID entity) {
+  Record(Op::kDelete, entity, nullptr, nullptr);
+}
+
+void EntityCommandBuffer::Clear() {
+  ReleasePayloads(&commands_);
+  commands_.clear();
+  block_ = 0;
+  block_used_ = 0;
+  if (placeholder_counter_ == &own_counter_) {
+    own_counter_.store(0, std::memory_order_relaxed);
+  }
+}
+
+void EntityCommandBuffer::Playback(Registry& registry) {
+  EntityCommandBuffer* self = this;
+  Playback(&self, 1, registry);
+}
+
+void EntityCommandBuffer::Playback(EntityCommandBuffer* const* buffers,
+                                   size_t count, Registry& registry) {
+  // Take the commands first so listeners may record new ones while we play
+  // these back; those are left for the next playback.
+  std::vector<std::vector<Command>> taken(count);
+  size_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    taken[i] = std::move(buffers[i]->commands_);
+    buffers[i]->commands_.clear();
+    total += taken[i].size();
+  }
+  std::vector<Command*> order;
+  order.reserve(total);
+  for (std::vector<Command>& commands : taken) {
+    for (Command& command : commands) {
+      order.push_back(&command);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [](const Command* a, const Command* b) {
+                     return a->sort_key < b->sort_key;
+                   });
+
+  // Spawn every entity up front so commands can target placeholders
+  // regardless of where the creation landed in the sorted stream.
+  std::vector<EntityID> resolved;
+  std::vector<EntityID> created;
+  for (const Command* command : order) {
+    if (command->op != Op::kCreate) {
+      continue;
+    }
+    const uint32_t slot = GetEntityIndex(command->entity);
+    if (slot >= resolved.size()) {
+      resolved.resize(slot + 1, kInvalidEntity);
+    }
+    resolved[slot] = registry.entity_manager_.CreateEntity();
+    created.push_back(resolved[slot]);
+  }
+  auto resolve = [&resolved](EntityID entity) {
+    if (!IsPlaceholderEntity(entity)) {
+      return entity;
+    }
+    const uint32_t slot = GetEntityIndex(entity);
+    return slot < resolved.size() ? resolved[slot] : kInvalidEntity;
+  };
+
+  std::vector<std::pair<EntityID, const ComponentOps*>> added;
+  for (Command* command : order) {
+    const EntityID entity = resolve(command->entity);
+    switch (command->op) {
+      case Op::kCreate:
+        break;
+      case Op::kDelete:
+        registry.DeleteEntity(entity);
+        break;
+      case Op::kAdd:
+        if (registry.IsAlive(entity)) {
+          command->ops->insert(registry, entity, command->payload);
+          added.emplace_back(entity, command->ops);
+        }
+        command->ops->destroy(command->payload);
+        command->payload = nullptr;
+        break;
+      case Op::kRemove:
+        command->ops->remove(registry, entity);
+        break;
+    }
+  }
+
+  for (EntityID entity : created) {
+    if (registry.IsAlive(entity)) {
+      registry.Publish<events::EntityCreatedEvent>({entity, &registry});
+    }
+  }
+  for (const auto& [entity, ops] : added) {
+    ops->publish_added(registry, entity);
+  }
+
+  bool pending = false;
+  for (size_t i = 0; i < count; ++i) {
+    buffers[i]->ReleasePayloads(&taken[i]);
+    if (buffers[i]->commands_.empty()) {
+      buffers[i]->block_ = 0;
+      buffers[i]->block_used_ = 0;
+    } else {
+      pending = true;
+    }
+  }
+  // Placeholder handles only need to be unique within one playback.
+  if (!pending) {
+    for (size_t i = 0; i < count; ++i) {
+      buffers[i]->placeholder_counter_->store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void* EntityCommandBuffer::Allocate(size_t size, size_t alignment) {
+  while (true) {
+    if (block_ < blocks_.size()) {
+      const auto base = reinterpret_cast<uintptr_t>(blocks_[block_].get());
+      const uintptr_t start =
+          (base + block_used_ + alignment - 1) / alignment * alignment;
+      if (start + size <= base + block_sizes_[block_]) {
+        block_used_ = start + size - base;
+        return reinterpret_cast<void*>(start);
+      }
+      if (block_ + 1 < blocks_.size()) {
+        ++block_;
+        block_used_ = 0;
+        continue;
+      }
+    }
+    const size_t bytes = std::max(kBlockSize, size + alignment);
+    blocks_.emplace_back(new std::byte[bytes]);
+    block_sizes_.push_back(bytes);
+    block_ = blocks_.size() - 1;
+    block_used_ = 0;
+  }
+}
+
+void EntityCommandBuffer::ReleasePayloads(std::vector<Command>* commands) {
+  for (Command& command : *commands) {
+    if (command.payload) {
+      command.ops->destroy(command.payload);
+      command.payload = nullptr;
+    }
+  }
+}
+
+}  // namespace engine::ecs
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <engine/core/job_system.h>
+#include <engine/ecs/entity_command_buffer.h>
+#include <engine/ecs/registry.h>
+
+namespace engine::ecs {
+
+struct Position {
+  float x, y;
+};
+
+struct Name {
+  std::string value;
+};
+
+class EntityCommandBufferTest : public ::testing::Test {
+ protected:
+  Registry registry;
+  EntityCommandBuffer buffer;
+};
+
+TEST_F(EntityCommandBufferTest, PlaceholdersBecomeEntities) {
+  EntityID placeholder = buffer.CreateEntity();
+  EXPECT_TRUE(IsPlaceholderEntity(placeholder));
+  buffer.AddComponent<Name>(placeholder, {"spawned"});
+  EXPECT_EQ(registry.GetEntityCount(), 0u);
+
+  buffer.Playback(registry);
+  EXPECT_TRUE(buffer.empty());
+  ASSERT_EQ(registry.GetEntityCount(), 1u);
+
+  int found = 0;
+  registry.GetView<Name>().Each([&found](EntityID entity, Name& name) {
+    EXPECT_FALSE(IsPlaceholderEntity(entity));
+    EXPECT_EQ(name.value, "spawned");
+    found++;
+  });
+  EXPECT_EQ(found, 1);
+}
+
+TEST_F(EntityCommandBufferTest, EmplaceIsAppliedAtPlayback) {
+  EntityID e = registry.CreateEntity();
+  buffer.EmplaceComponent<Name>(e, "emplaced");
+  buffer.EmplaceComponent<Position>(e, 3.0f, 4.0f);
+  EXPECT_FALSE(registry.HasComponent<Name>(e));
+
+  buffer.Playback(registry);
+  EXPECT_EQ(registry.GetComponent<Name>(e).value, "emplaced");
+  EXPECT_EQ(registry.GetComponent<Position>(e).y, 4.0f);
+}
+
+TEST_F(EntityCommandBufferTest, ChangesAreDeferredUntilPlayback) {
+  std::vector<EntityID> entities;
+  for (int i = 0; i < 10; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {static_cast<float>(i), 0.0f});
+    entities.push_back(e);
+  }
+
+  int visited = 0;
+  registry.GetView<Position>().Each([&](EntityID entity, Position& p) {
+    if (static_cast<int>(p.x) % 2 == 0) {
+      buffer.DeleteEntity(entity);
+    } else {
+      buffer.RemoveComponent<Position>(entity);
+    }
+    visited++;
+  });
+  EXPECT_EQ(visited, 10);
+  EXPECT_EQ(registry.GetEntityCount(), 10u);
+
+  buffer.Playback(registry);
+  EXPECT_EQ(registry.GetEntityCount(), 5u);
+  for (EntityID e : entities) {
+    EXPECT_FALSE(registry.HasComponent<Position>(e));
+  }
+}
+
+TEST_F(EntityCommandBufferTest, AddedEventsAreBatchedAfterPlayback) {
+  struct Listener : events::IEventListener<events::EntityCreatedEvent>,
+                    events::IEventListener<events::ComponentAddedEvent<Name>> {
+    void OnEvent(const events::EntityCreatedEvent& event) override {
+      // Components are already in place when the creation is announced.
+      created++;
+      if (event.registry->HasComponent<Name>(event.entity)) {
+        named_on_create++;
+      }
+    }
+    void OnEvent(const events::ComponentAddedEvent<Name>& event) override {
+      added.push_back(event.component.value);
+    }
+    int created = 0;
+    int named_on_create = 0;
+    std::vector<std::string> added;
+  } listener;
+  registry.Subscribe<events::EntityCreatedEvent>(&listener);
+  registry.Subscribe<events::ComponentAddedEvent<Name>>(&listener);
+
+  EntityID kept = buffer.CreateEntity();
+  buffer.AddComponent<Name>(kept, {"kept"});
+  EntityID dropped = buffer.CreateEntity();
+  buffer.AddComponent<Name>(dropped, {"dropped"});
+  buffer.RemoveComponent<Name>(dropped);
+  buffer.Playback(registry);
+
+  EXPECT_EQ(listener.created, 2);
+  EXPECT_EQ(listener.named_on_create, 1);
+  ASSERT_EQ(listener.added.size(), 1u);
+  EXPECT_EQ(listener.added[0], "kept");
+}
+
+TEST_F(EntityCommandBufferTest, UnplayedPayloadsAreDestroyed) {
+  buffer.AddComponent<Name>(buffer.CreateEntity(),
+                            {std::string(1000, 'x')});
+  buffer.Clear();
+  EXPECT_TRUE(buffer.empty());
+  buffer.Playback(registry);
+  EXPECT_EQ(registry.GetEntityCount(), 0u);
+}
+
+TEST(RegistryCommandsTest, ParallelPlaybackIsDeterministic) {
+  core::JobSystem::Get().Init();
+  Registry registry;
+  for (int i = 0; i < 2000; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {static_cast<float>(i), 0.0f});
+  }
+
+  // Every entity spawns a child carrying its index. Playback follows entity
+  // order, so children are created in the same order on every run.
+  registry.ParallelForEach<Position>(
+      [&registry](EntityID, Position& p) {
+        EntityCommandBuffer& commands = registry.commands();
+        EntityID child = commands.CreateEntity();
+        commands.AddComponent<Name>(child,
+                                    {std::to_string(static_cast<int>(p.x))});
+      },
+      16);
+  registry.FlushCommands();
+  core::JobSystem::Get().Shutdown();
+
+  ASSERT_EQ(registry.GetEntityCount(), 4000u);
+  for (uint32_t i = 0; i < 2000; ++i) {
+    EntityID child = MakeEntityID(2000 + i, 0);
+    ASSERT_TRUE(registry.HasComponent<Name>(child));
+    EXPECT_EQ(registry.GetComponent<Name>(child).value, std::to_string(i));
+  }
+}
+
+TEST(RegistryCommandsTest, OutsideThreadsGetTheirOwnBuffers) {
+  Registry registry;
+  EntityCommandBuffer* main_buffer = &registry.commands();
+  EntityCommandBuffer* outside_buffer = nullptr;
+  std::thread outside([&registry, &outside_buffer]() {
+    outside_buffer = &registry.commands();
+    for (int i = 0; i < 1000; ++i) {
+      outside_buffer->CreateEntity();
+    }
+  });
+  for (int i = 0; i < 1000; ++i) {
+    main_buffer->CreateEntity();
+  }
+  outside.join();
+
+  EXPECT_NE(main_buffer, outside_buffer);
+  EXPECT_EQ(&registry.commands(), main_buffer);
+  registry.FlushCommands();
+  EXPECT_EQ(registry.GetEntityCount(), 2000u);
+}
+
+}  // namespace engine::ecs
@@ -9,36 +9,69 @@
  */
 
 #include <algorithm>
+#include <utility>
 
 #include <engine/ecs/entity_manager.h>
+#include <engine/util/logger.h>
 
 namespace engine::ecs {
 
 EntityID EntityManager::CreateEntity() {
-  // Pop a free entity.
-  if (free_entities_.size() > 0) {
-    int ret = free_entities_[0];
-    free_entities_.erase(free_entities_.begin());
-    return ret;
+  // Pop a free slot, keeping the generation it was released with.
+  if (!free_indices_.empty()) {
+    uint32_t index = free_indices_.back();
+    free_indices_.pop_back();
+    EntityID entity = MakeEntityID(index, GetEntityGeneration(slots_[index]));
+    slots_[index] = entity;
+    return entity;
   }
-  return next_id_++;
+  if (slots_.size() >= kMaxEntities) {
+    LOG_ERR("EntityManager is out of entity slots (%u in use).", kMaxEntities);
+    return kInvalidEntity;
+  }
+  EntityID entity = MakeEntityID(static_cast<uint32_t>(slots_.size()), 0);
+  slots_.push_back(entity);
+  masks_.resize(slots_.size() * mask_words_, 0);
+  return entity;
 }
 
 void EntityManager::DestroyEntity(EntityID entity) {
-  free_entities_.push_back(entity);
-}
-
-bool EntityManager::IsAlive(EntityID entity) const {
-  auto it = std::find(free_entities_.begin(), free_entities_.end(), entity);
-  return entity < next_id_ && it == free_entities_.end();
+  if (!IsAlive(entity)) {
+    return;
+  }
+  uint32_t index = GetEntityIndex(entity);
+  uint32_t generation = GetEntityGeneration(entity) + 1;
+  if (generation == kPlaceholderGeneration) {
+    generation = 0;
+  }
+  slots_[index] = MakeEntityID(kEntityIndexMask, generation);
+  free_indices_.push_back(index);
 }
 
 size_t EntityManager::GetEntityCount() const {
-  return static_cast<size_t>(next_id_) - free_entities_.size();
+  return slots_.size() - free_indices_.size();
 }
 
 void EntityManager::Clear() {
-  next_id_ = 0;
-  free_entities_.clear();
+  slots_.clear();
+  free_indices_.clear();
+  masks_.clear();
+}
+
+void EntityManager::Restore(const EntityID* slots, size_t slot_count,
+                            const uint32_t* free_indices, size_t free_count) {
+  slots_.assign(slots, slots + slot_count);
+  free_indices_.assign(free_indices, free_indices + free_count);
+  masks_.assign(slot_count * mask_words_, 0);
+}
+
+void EntityManager::WidenMasks(size_t words) {
+  std::vector<uint64_t> widened(slots_.size() * words, 0);
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    std::copy_n(masks_.begin() + i * mask_words_, mask_words_,
+                widened.begin() + i * words);
+  }
+  masks_ = std::move(widened);
+  mask_words_ = words;
 }
 }  // namespace engine::ecs
@@ -26,10 +26,34 @@ TEST(EntityManagerTest, ReuseEntityID) {
   EntityID e1 = manager.CreateEntity();
   manager.DestroyEntity(e1);
   EntityID e2 = manager.CreateEntity();
-  EXPECT_EQ(e1, e2);
+  EXPECT_EQ(GetEntityIndex(e1), GetEntityIndex(e2));
+  EXPECT_NE(GetEntityGeneration(e1), GetEntityGeneration(e2));
   EXPECT_TRUE(manager.IsAlive(e2));
 }
 
+TEST(EntityManagerTest, StaleHandleIsNotAlive) {
+  EntityManager manager;
+  EntityID e1 = manager.CreateEntity();
+  manager.DestroyEntity(e1);
+  EntityID e2 = manager.CreateEntity();
+  EXPECT_FALSE(manager.IsAlive(e1));
+  EXPECT_TRUE(manager.IsAlive(e2));
+
+  // Destroying the stale handle must not release the reused slot.
+  manager.DestroyEntity(e1);
+  EXPECT_TRUE(manager.IsAlive(e2));
+  EXPECT_EQ(manager.GetEntityCount(), 1);
+}
+
+TEST(EntityManagerTest, GetEntity) {
+  EntityManager manager;
+  EntityID e1 = manager.CreateEntity();
+  EXPECT_EQ(manager.GetEntity(GetEntityIndex(e1)), e1);
+  manager.DestroyEntity(e1);
+  EXPECT_EQ(manager.GetEntity(GetEntityIndex(e1)), kInvalidEntity);
+  EXPECT_FALSE(manager.IsAlive(kInvalidEntity));
+}
+
 TEST(EntityManagerTest, Clear) {
   EntityManager manager;
   manager.CreateEntity();
@@ -61,4 +85,41 @@ TEST(EntityManagerTest, GetEntityCount) {
   EXPECT_EQ(manager.GetEntityCount(), 0);
 }
 
+TEST(EntityManagerTest, GenerationNeverReachesPlaceholder) {
+  EntityManager manager;
+  EntityID e = manager.CreateEntity();
+  for (uint32_t i = 0; i < kEntityGenerationMask + 1; ++i) {
+    EXPECT_FALSE(IsPlaceholderEntity(e));
+    manager.DestroyEntity(e);
+    e = manager.CreateEntity();
+  }
+  EXPECT_EQ(GetEntityIndex(e), 0u);
+}
+
+TEST(EntityManagerTest, ComponentMasks) {
+  EntityManager manager;
+  manager.AddComponentType(3);
+  EntityID e1 = manager.CreateEntity();
+  EntityID e2 = manager.CreateEntity();
+  manager.SetComponentBit(GetEntityIndex(e1), 3);
+  EXPECT_TRUE(manager.HasComponentBit(GetEntityIndex(e1), 3));
+  EXPECT_FALSE(manager.HasComponentBit(GetEntityIndex(e2), 3));
+  EXPECT_FALSE(manager.HasComponentBit(GetEntityIndex(e1), 200));
+
+  // Widening keeps the bits already set.
+  manager.AddComponentType(130);
+  EXPECT_EQ(manager.mask_words(), 3u);
+  manager.SetComponentBit(GetEntityIndex(e2), 130);
+  EXPECT_TRUE(manager.HasComponentBit(GetEntityIndex(e1), 3));
+  EXPECT_TRUE(manager.HasComponentBit(GetEntityIndex(e2), 130));
+  EXPECT_EQ(manager.ComponentMask(GetEntityIndex(e2))[2], uint64_t{1} << 2);
+
+  // Once its bits are cleared, the slot can be reused with an empty mask.
+  manager.ResetComponentBit(GetEntityIndex(e1), 3);
+  manager.DestroyEntity(e1);
+  EntityID e3 = manager.CreateEntity();
+  EXPECT_EQ(GetEntityIndex(e3), GetEntityIndex(e1));
+  EXPECT_FALSE(manager.HasComponentBit(GetEntityIndex(e3), 3));
+}
+
 }  // namespace engine::ecs
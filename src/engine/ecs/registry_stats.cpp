@@ -0,0 +1,67 @@
+/**
+ * @file registry_stats.cpp
+ * @brief Formatting of registry memory reports.
+ */
+
+#include <engine/ecs/registry_stats.h>
+
+#include <cstdio>
+#include <string>
+
+namespace engine::ecs {
+
+namespace {
+
+/** @brief Formats a printf-style line and appends it to `out`. */
+template <typename... Args>
+void AppendLine(std::string* out, const char* format, Args... args) {
+  char line[160];
+  std::snprintf(line, sizeof(line), format, args...);
+  out->append(line);
+  out->push_back('\n');
+}
+
+}  // namespace
+
+size_t RegistryStats::total_bytes() const {
+  size_t bytes = chunk_bytes;
+  for (const StorageStats& storage : storages) {
+    bytes += storage.bytes;
+  }
+  return bytes;
+}
+
+size_t RegistryStats::queued_events() const {
+  size_t queued = 0;
+  for (const events::DispatcherStats& dispatcher : dispatchers) {
+    queued += dispatcher.queued;
+  }
+  return queued;
+}
+
+std::string RegistryStats::ToString() const {
+  std::string out;
+  AppendLine(&out, "Entities: %zu live, %zu slots", entities, entity_slots);
+  if (archetypes > 0) {
+    AppendLine(&out, "Archetypes: %zu, %zu chunks, %.1f KB", archetypes,
+               chunks, chunk_bytes / 1024.0);
+  }
+  AppendLine(&out, "%-28s %9s %9s %10s %6s", "Component", "Size", "Capacity",
+             "KB", "Load");
+  for (const StorageStats& storage : storages) {
+    AppendLine(&out, "%-28.*s %9zu %9zu %10.1f %5.0f%%",
+               static_cast<int>(storage.name.size()), storage.name.data(),
+               storage.size, storage.capacity, storage.bytes / 1024.0,
+               storage.sparse_load * 100.0f);
+  }
+  AppendLine(&out, "%-28s %9s %9s", "Event", "Listeners", "Queued");
+  for (const events::DispatcherStats& dispatcher : dispatchers) {
+    AppendLine(&out, "%-28.*s %9zu %9zu",
+               static_cast<int>(dispatcher.name.size()), dispatcher.name.data(),
+               dispatcher.listeners, dispatcher.queued);
+  }
+  AppendLine(&out, "Total: %.1f KB", total_bytes() / 1024.0);
+  return out;
+}
+
+}  // namespace engine::ecs
@@ -1,4 +1,11 @@
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include <engine/ecs/registry.h>
 
 namespace engine::ecs {
@@ -24,6 +31,21 @@ TEST_F(RegistryTest, EntityLifecycle) {
   EXPECT_FALSE(registry.IsAlive(e));
 }
 
+TEST_F(RegistryTest, StaleHandleDoesNotSeeNewComponents) {
+  EntityID old_e = registry.CreateEntity();
+  registry.DeleteEntity(old_e);
+  EntityID new_e = registry.CreateEntity();
+  registry.AddComponent<Position>(new_e, {1.0f, 2.0f});
+
+  EXPECT_FALSE(registry.IsAlive(old_e));
+  EXPECT_FALSE(registry.HasComponent<Position>(old_e));
+
+  // Deleting through the stale handle must leave the new entity intact.
+  registry.DeleteEntity(old_e);
+  EXPECT_TRUE(registry.IsAlive(new_e));
+  EXPECT_TRUE(registry.HasComponent<Position>(new_e));
+}
+
 TEST_F(RegistryTest, ComponentManagement) {
   EntityID e = registry.CreateEntity();
 
@@ -59,6 +81,68 @@ TEST_F(RegistryTest, ViewIteration) {
   EXPECT_EQ(count, 2);
 }
 
+TEST_F(RegistryTest, ViewMatchesOnlyEntitiesWithAllComponents) {
+  std::vector<EntityID> expected;
+  for (int i = 0; i < 100; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+    if (i % 25 == 0) {
+      registry.AddComponent<Velocity>(e, {1.0f, 1.0f});
+      expected.push_back(e);
+    }
+  }
+
+  auto view = registry.GetView<Position, Velocity>();
+  std::vector<EntityID> matched(view.begin(), view.end());
+  std::sort(matched.begin(), matched.end());
+  EXPECT_EQ(matched, expected);
+}
+
+TEST_F(RegistryTest, ViewEachProvidesComponents) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {1.0f, 2.0f});
+  registry.AddComponent<Velocity>(e, {3.0f, 4.0f});
+
+  registry.GetView<Position, Velocity>().Each(
+      [e](EntityID entity, Position& p, Velocity& v) {
+        EXPECT_EQ(entity, e);
+        p.x += v.vx;
+      });
+
+  EXPECT_EQ(registry.GetComponent<Position>(e).x, 4.0f);
+}
+
+TEST_F(RegistryTest, EmptyViewIteratesNothing) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {1.0f, 2.0f});
+
+  auto view = registry.GetView<Position, Velocity>();
+  EXPECT_EQ(view.begin(), view.end());
+}
+
+TEST(TypeFamilyTest, IdsAreStableAndDistinct) {
+  const uint32_t position = ComponentTypeId<Position>();
+  EXPECT_EQ(ComponentTypeId<Position>(), position);
+  EXPECT_EQ(ComponentTypeId<const Position>(), position);
+  EXPECT_NE(ComponentTypeId<Velocity>(), position);
+  EXPECT_LT(position, ComponentFamily::size());
+}
+
+TEST_F(RegistryTest, RegistriesShareTypeIds) {
+  // A second registry that registers types in a different order must still
+  // resolve each type to its own storage.
+  Registry other;
+  EntityID a = other.CreateEntity();
+  other.AddComponent<Velocity>(a, {3.0f, 4.0f});
+  EntityID b = registry.CreateEntity();
+  registry.AddComponent<Position>(b, {1.0f, 2.0f});
+
+  EXPECT_EQ(other.GetComponent<Velocity>(a).vx, 3.0f);
+  EXPECT_FALSE(other.HasComponent<Position>(a));
+  EXPECT_EQ(registry.GetComponent<Position>(b).x, 1.0f);
+  EXPECT_FALSE(registry.HasComponent<Velocity>(b));
+}
+
 TEST_F(RegistryTest, PatchComponent) {
   EntityID e = registry.CreateEntity();
   registry.AddComponent<Position>(e, {10.0f, 10.0f});
@@ -70,6 +154,38 @@ TEST_F(RegistryTest, PatchComponent) {
   EXPECT_EQ(registry.GetComponent<Position>(e).x, 15.0f);
 }
 
+TEST_F(RegistryTest, RemoveKeepsOtherComponents) {
+  EntityID e1 = registry.CreateEntity();
+  EntityID e2 = registry.CreateEntity();
+  EntityID e3 = registry.CreateEntity();
+  registry.AddComponent<Position>(e1, {1.0f, 1.0f});
+  registry.AddComponent<Position>(e2, {2.0f, 2.0f});
+  registry.AddComponent<Position>(e3, {3.0f, 3.0f});
+
+  registry.RemoveComponent<Position>(e1);
+
+  EXPECT_FALSE(registry.HasComponent<Position>(e1));
+  EXPECT_EQ(registry.GetComponent<Position>(e2).x, 2.0f);
+  EXPECT_EQ(registry.GetComponent<Position>(e3).x, 3.0f);
+}
+
+TEST_F(RegistryTest, StorageIsDense) {
+  for (int i = 0; i < 10; ++i) {
+    EntityID e = registry.CreateEntity();
+    if (i % 2 == 0) {
+      registry.AddComponent<Position>(e, {static_cast<float>(i), 0.0f});
+    }
+  }
+
+  auto* storage = registry.GetStorage<Position>();
+  ASSERT_EQ(storage->size(), 5u);
+  for (size_t i = 0; i < storage->size(); ++i) {
+    EntityID owner = storage->entities()[i];
+    EXPECT_EQ(storage->data()[i].x,
+              static_cast<float>(GetEntityIndex(owner)));
+  }
+}
+
 TEST_F(RegistryTest, Clear) {
   EntityID e = registry.CreateEntity();
   registry.AddComponent<Position>(e, {1.0f, 1.0f});
@@ -81,4 +197,1007 @@ TEST_F(RegistryTest, Clear) {
   EXPECT_EQ(new_e, 0); // Assuming ID reuse from 0 after clear
 }
 
+TEST_F(RegistryTest, ParallelForEachVisitsEveryMatchOnce) {
+  core::JobSystem::Get().Init();
+  for (int i = 0; i < 5000; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+    if (i % 4 != 0) {
+      registry.AddComponent<Velocity>(e, {1.0f, 2.0f});
+    }
+  }
+
+  registry.ParallelForEach<Position, Velocity>(
+      [](Position& p, Velocity& v) {
+        p.x += v.vx;
+        p.y += v.vy;
+      },
+      64);
+  core::JobSystem::Get().Shutdown();
+
+  int moved = 0;
+  registry.ForEach<Position>([&moved](Position& p) {
+    if (p.x != 0.0f) {
+      EXPECT_EQ(p.x, 1.0f);
+      EXPECT_EQ(p.y, 2.0f);
+      moved++;
+    }
+  });
+  EXPECT_EQ(moved, 3750);
+}
+
+#ifndef NDEBUG
+TEST_F(RegistryTest, ParallelForEachRejectsStructuralChanges) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {0.0f, 0.0f});
+
+  EXPECT_DEATH(registry.ParallelForEach<Position>(
+                   [this](Position&) { registry.CreateEntity(); }),
+               "");
+}
+#endif
+
+TEST_F(RegistryTest, OneShotAndUnsubscribeDuringDispatch) {
+  struct Counter : events::IEventListener<events::EntityCreatedEvent> {
+    void OnEvent(const events::EntityCreatedEvent&) override {
+      ++count;
+      if (other) {
+        registry->Unsubscribe<events::EntityCreatedEvent>(other);
+      }
+    }
+    Registry* registry = nullptr;
+    Counter* other = nullptr;
+    int count = 0;
+  };
+  Counter once, remover, removed;
+  remover.registry = &registry;
+  remover.other = &removed;
+  registry.Subscribe<events::EntityCreatedEvent>(&once, true);
+  registry.Subscribe<events::EntityCreatedEvent>(&remover);
+  registry.Subscribe<events::EntityCreatedEvent>(&removed);
+
+  registry.CreateEntity();
+  registry.CreateEntity();
+  EXPECT_EQ(once.count, 1);
+  EXPECT_EQ(remover.count, 2);
+  EXPECT_EQ(removed.count, 0);
+}
+
+TEST_F(RegistryTest, DeferredComponentEventKeepsItsOwnCopy) {
+  struct Listener
+      : events::IEventListener<events::ComponentModifiedEvent<Position>> {
+    void OnEvent(
+        const events::ComponentModifiedEvent<Position>& event) override {
+      seen.push_back(event.component.x);
+    }
+    std::vector<float> seen;
+  } listener;
+  registry.Subscribe<events::ComponentModifiedEvent<Position>>(&listener);
+
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {1.0f, 0.0f});
+  Position& position = registry.GetComponent<Position>(e);
+  registry.Publish<events::ComponentModifiedEvent<Position>>(
+      {e, position, &registry}, false);
+  position.x = 2.0f;
+  registry.Publish<events::ComponentModifiedEvent<Position>>(
+      {e, position, &registry}, false);
+  registry.RemoveComponent<Position>(e);
+  EXPECT_TRUE(listener.seen.empty());
+
+  registry.Update();
+  EXPECT_EQ(listener.seen, (std::vector<float>{1.0f, 2.0f}));
+}
+
+TEST_F(RegistryTest, WorkersPublishDeferredEvents) {
+  struct Hit {
+    EntityID entity;
+  };
+  struct Listener : events::IEventListener<Hit> {
+    void OnEvent(const Hit&) override { ++count; }
+    int count = 0;
+  } listener;
+  registry.Subscribe<Hit>(&listener);
+
+  core::JobSystem::Get().Init();
+  for (int i = 0; i < 5000; ++i) {
+    registry.AddComponent<Position>(registry.CreateEntity(), {0.0f, 0.0f});
+  }
+  registry.ParallelForEach<Position>(
+      [this](EntityID entity, Position&) {
+        registry.Publish<Hit>({entity}, false);
+      },
+      64);
+  core::JobSystem::Get().Shutdown();
+
+  EXPECT_EQ(listener.count, 0);
+  registry.Update();
+  EXPECT_EQ(listener.count, 5000);
+  registry.Update();
+  EXPECT_EQ(listener.count, 5000);
+}
+
+TEST_F(RegistryTest, ChangedAndAddedFilters) {
+  EntityID old_e = registry.CreateEntity();
+  registry.AddComponent<Position>(old_e, {0.0f, 0.0f});
+  registry.AddComponent<Velocity>(old_e, {0.0f, 0.0f});
+  const uint32_t since = registry.AdvanceTick();
+
+  EntityID new_e = registry.CreateEntity();
+  registry.AddComponent<Position>(new_e, {0.0f, 0.0f});
+  registry.AddComponent<Velocity>(new_e, {0.0f, 0.0f});
+  registry.PatchComponent<Velocity>(old_e, [](Velocity& v) { v.vx = 1.0f; });
+
+  auto collect = [](auto view) {
+    std::vector<EntityID> result(view.begin(), view.end());
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  EXPECT_EQ(collect(registry.GetView<Position>(Added<Position>{since})),
+            std::vector<EntityID>{new_e});
+  EXPECT_EQ(collect(registry.GetView<Position>(Changed<Velocity>{since})),
+            (std::vector<EntityID>{old_e, new_e}));
+  EXPECT_EQ(collect(registry.GetView<Position>(Changed<Position>{since},
+                                               Changed<Velocity>{since})),
+            std::vector<EntityID>{new_e});
+  // Unqualified filters outside of a scheduled system match everything.
+  EXPECT_EQ(collect(registry.GetView<Position>(Changed<Position>{})).size(),
+            2u);
+
+  const uint32_t later = registry.AdvanceTick();
+  registry.GetComponent<Position>(old_e).x = 5.0f;
+  EXPECT_TRUE(collect(registry.GetView<Position>(Changed<Position>{later}))
+                  .empty());
+  registry.MarkChanged<Position>(old_e);
+  EXPECT_EQ(collect(registry.GetView<Position>(Changed<Position>{later})),
+            std::vector<EntityID>{old_e});
+}
+
+TEST_F(RegistryTest, BulkCreateInsertAndDestroy) {
+  struct Listener
+      : events::IEventListener<events::ComponentAddedEvent<Position>>,
+        events::IEventListener<events::ComponentRemovedEvent<Position>> {
+    void OnEvent(const events::ComponentAddedEvent<Position>& event) override {
+      // Every component of the batch is stored before the first event.
+      EXPECT_TRUE(event.registry->HasComponent<Position>(last));
+      ++added;
+    }
+    void OnEvent(const events::ComponentRemovedEvent<Position>&) override {
+      ++removed;
+    }
+    EntityID last = kInvalidEntity;
+    int added = 0;
+    int removed = 0;
+  } listener;
+
+  std::vector<EntityID> entities = registry.CreateEntities(100);
+  ASSERT_EQ(entities.size(), 100u);
+  EXPECT_EQ(registry.GetEntityCount(), 100u);
+  EXPECT_FALSE(registry.HasSubscribers<events::EntityCreatedEvent>());
+
+  registry.Subscribe<events::ComponentAddedEvent<Position>>(&listener);
+  registry.Subscribe<events::ComponentRemovedEvent<Position>>(&listener);
+  EXPECT_TRUE(registry.HasSubscribers<events::ComponentAddedEvent<Position>>());
+  listener.last = entities.back();
+  std::vector<Position> positions(entities.size());
+  for (size_t i = 0; i < positions.size(); ++i) {
+    positions[i] = {static_cast<float>(i), 0.0f};
+  }
+  registry.InsertComponents<Position>(entities, positions);
+  EXPECT_EQ(listener.added, 100);
+  EXPECT_EQ(registry.GetComponent<Position>(entities[42]).x, 42.0f);
+
+  std::vector<EntityID> doomed(entities.begin(), entities.begin() + 60);
+  doomed.push_back(entities[7]);
+  registry.DestroyEntities(doomed);
+  EXPECT_EQ(listener.removed, 60);
+  EXPECT_EQ(registry.GetEntityCount(), 40u);
+  EXPECT_EQ(registry.GetStorage<Position>()->size(), 40u);
+  EXPECT_FALSE(registry.IsAlive(entities[0]));
+  EXPECT_EQ(registry.GetComponent<Position>(entities[99]).x, 99.0f);
+}
+
+// Checks that the first group.size() entries of both storages line up.
+void ExpectLockstep(Registry& registry, size_t size) {
+  const std::pmr::vector<EntityID>& positions =
+      registry.GetStorage<Position>()->entities();
+  const std::pmr::vector<EntityID>& velocities =
+      registry.GetStorage<Velocity>()->entities();
+  ASSERT_GE(positions.size(), size);
+  ASSERT_GE(velocities.size(), size);
+  for (size_t i = 0; i < size; ++i) {
+    EXPECT_EQ(positions[i], velocities[i]);
+  }
+}
+
+TEST_F(RegistryTest, GroupKeepsOwnedStoragesInLockstep) {
+  std::vector<EntityID> both;
+  for (int i = 0; i < 8; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {static_cast<float>(i), 0.0f});
+    if (i % 2 == 0) {
+      registry.AddComponent<Velocity>(e, {1.0f, 0.0f});
+      both.push_back(e);
+    }
+  }
+  registry.AddComponent<Velocity>(registry.CreateEntity(), {2.0f, 0.0f});
+
+  auto group = registry.GetGroup<Position, Velocity>();
+  EXPECT_EQ(group.size(), both.size());
+  ExpectLockstep(registry, group.size());
+
+  // Joining, leaving and dying all keep the prefix packed.
+  EntityID joiner = registry.CreateEntity();
+  registry.AddComponent<Velocity>(joiner, {3.0f, 0.0f});
+  registry.AddComponent<Position>(joiner, {9.0f, 0.0f});
+  registry.RemoveComponent<Velocity>(both[0]);
+  registry.DeleteEntity(both[1]);
+  EXPECT_EQ(group.size(), both.size() - 1);
+  ExpectLockstep(registry, group.size());
+  EXPECT_TRUE(group.Contains(joiner));
+  EXPECT_FALSE(group.Contains(both[0]));
+
+  group.Each([](EntityID, Position& p, Velocity& v) { p.x += v.vx; });
+  EXPECT_EQ(registry.GetComponent<Position>(joiner).x, 12.0f);
+  EXPECT_EQ(registry.GetComponent<Position>(both[2]).x, 5.0f);
+  EXPECT_EQ(registry.GetComponent<Position>(both[0]).x, 0.0f);
+
+  const EntityID* members = group.entities();
+  Velocity* velocities = group.data<Velocity>();
+  for (size_t i = 0; i < group.size(); ++i) {
+    EXPECT_EQ(&registry.GetComponent<Velocity>(members[i]), &velocities[i]);
+  }
+}
+
+TEST_F(RegistryTest, GroupWithObservedType) {
+  EntityID moving = registry.CreateEntity();
+  registry.AddComponent<Velocity>(moving, {1.0f, 0.0f});
+  EntityID placed = registry.CreateEntity();
+  registry.AddComponent<Velocity>(placed, {1.0f, 0.0f});
+  registry.AddComponent<Position>(placed, {0.0f, 0.0f});
+
+  auto group = registry.GetGroup<Velocity>(With<Position>{});
+  EXPECT_EQ(group.size(), 1u);
+  EXPECT_EQ(group.entities()[0], placed);
+
+  registry.AddComponent<Position>(moving, {0.0f, 0.0f});
+  EXPECT_EQ(group.size(), 2u);
+  registry.RemoveComponent<Position>(placed);
+  ASSERT_EQ(group.size(), 1u);
+  EXPECT_EQ(group.entities()[0], moving);
+
+  int visited = 0;
+  group.Each([&visited](EntityID, Velocity&, Position&) { ++visited; });
+  EXPECT_EQ(visited, 1);
+}
+
+TEST_F(RegistryTest, GroupOwnershipIsExclusive) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {0.0f, 0.0f});
+  registry.AddComponent<Velocity>(e, {0.0f, 0.0f});
+
+  auto group = registry.GetGroup<Position, Velocity>();
+  EXPECT_EQ(group.size(), 1u);
+  // The same group is shared; a different owner of Position is rejected.
+  auto again = registry.GetGroup<Position, Velocity>();
+  EXPECT_EQ(again.size(), 1u);
+#ifndef NDEBUG
+  EXPECT_DEATH(registry.GetGroup<Position>(), "");
+#else
+  // Release builds fall back to a view, so the caller still sees every match.
+  auto conflicting = registry.GetGroup<Position>();
+  EXPECT_EQ(conflicting.entities(), nullptr);
+  int visited = 0;
+  conflicting.Each([&visited](EntityID, Position&) { ++visited; });
+  EXPECT_EQ(visited, 1);
+#endif
+
+  registry.Clear();
+  EXPECT_EQ(group.size(), 0u);
+}
+
+bool ByX(const Position& a, const Position& b) { return a.x < b.x; }
+
+/** @brief Expects the Position storage's range to be ordered by x. */
+void ExpectSortedByX(Registry& registry, size_t first, size_t last) {
+  ComponentStorage<Position>* storage = registry.GetStorage<Position>();
+  EXPECT_TRUE(std::is_sorted(storage->data() + first, storage->data() + last,
+                             ByX));
+  for (size_t i = first; i < last; ++i) {
+    EXPECT_EQ(storage->IndexOf(storage->entities()[i]), i);
+  }
+}
+
+TEST_F(RegistryTest, SortOrdersDenseArrays) {
+  std::vector<EntityID> entities;
+  for (int i = 0; i < 64; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(
+        e, {static_cast<float>((i * 37) % 16), static_cast<float>(i)});
+    entities.push_back(e);
+  }
+  registry.Sort<Position>(ByX);
+  ExpectSortedByX(registry, 0, entities.size());
+  // Stable: equal keys keep their insertion order, tracked here by y.
+  const Position* data = registry.GetStorage<Position>()->data();
+  for (size_t i = 1; i < entities.size(); ++i) {
+    if (data[i - 1].x == data[i].x) {
+      EXPECT_LT(data[i - 1].y, data[i].y);
+    }
+  }
+  for (size_t i = 0; i < entities.size(); ++i) {
+    EXPECT_EQ(registry.GetComponent<Position>(entities[i]).y,
+              static_cast<float>(i));
+  }
+
+  // A few keys move between frames.
+  registry.GetComponent<Position>(entities[3]).x = -1.0f;
+  registry.GetComponent<Position>(entities[10]).x = 20.0f;
+  registry.SortIncremental<Position>(ByX);
+  ExpectSortedByX(registry, 0, entities.size());
+  EXPECT_EQ(registry.GetStorage<Position>()->entities().front(), entities[3]);
+  EXPECT_EQ(registry.GetStorage<Position>()->entities().back(), entities[10]);
+
+  // Reversing every key exceeds the insertion budget and falls back.
+  for (EntityID e : entities) {
+    registry.GetComponent<Position>(e).x *= -1.0f;
+  }
+  registry.SortIncremental<Position>(ByX);
+  ExpectSortedByX(registry, 0, entities.size());
+}
+
+TEST_F(RegistryTest, SortOwnedStorageKeepsTheGroupPacked) {
+  std::vector<EntityID> members;
+  for (int i = 0; i < 16; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {static_cast<float>(16 - i), 0.0f});
+    if (i % 3 == 0) {
+      registry.AddComponent<Velocity>(e, {static_cast<float>(16 - i), 0.0f});
+      members.push_back(e);
+    }
+  }
+  auto group = registry.GetGroup<Position, Velocity>();
+  ASSERT_EQ(group.size(), members.size());
+
+  registry.SortIncremental<Position>(ByX);
+  EXPECT_EQ(group.size(), members.size());
+  ExpectLockstep(registry, group.size());
+  ExpectSortedByX(registry, 0, group.size());
+  ExpectSortedByX(registry, group.size(), 16);
+  for (EntityID e : members) {
+    EXPECT_TRUE(group.Contains(e));
+  }
+  group.Each([](EntityID, Position& p, Velocity& v) { EXPECT_EQ(p.x, v.vx); });
+}
+
+/** @brief Counts how often instances are copied and moved. */
+struct Counted {
+  static inline int copies = 0;
+  static inline int moves = 0;
+
+  explicit Counted(std::string name) : name(std::move(name)) {}
+  Counted(const Counted& other) : name(other.name) { ++copies; }
+  Counted(Counted&& other) noexcept : name(std::move(other.name)) { ++moves; }
+  Counted& operator=(const Counted& other) {
+    name = other.name;
+    ++copies;
+    return *this;
+  }
+  Counted& operator=(Counted&& other) noexcept {
+    name = std::move(other.name);
+    ++moves;
+    return *this;
+  }
+
+  std::string name;
+};
+
+TEST_F(RegistryTest, EmplaceConstructsInPlace) {
+  registry.Reserve<Counted>(4);
+  Counted::copies = 0;
+  Counted::moves = 0;
+  EntityID a = registry.CreateEntity();
+  Counted* counted = registry.EmplaceComponent<Counted>(a, "in place");
+  ASSERT_NE(counted, nullptr);
+  EXPECT_EQ(counted->name, "in place");
+  EXPECT_EQ(Counted::copies, 0);
+  EXPECT_EQ(Counted::moves, 0);
+
+  // An rvalue reaches its storage with one move and no copy.
+  EntityID b = registry.CreateEntity();
+  registry.AddComponent(b, Counted("moved"));
+  EXPECT_EQ(Counted::copies, 0);
+  EXPECT_EQ(Counted::moves, 1);
+
+  // Aggregates are built from their members.
+  registry.EmplaceComponent<Position>(a, 1.0f, 2.0f);
+  EXPECT_EQ(registry.GetComponent<Position>(a).y, 2.0f);
+
+  EntityID dead = registry.CreateEntity();
+  registry.DeleteEntity(dead);
+  EXPECT_EQ(registry.EmplaceComponent<Counted>(dead, "dead"), nullptr);
+  EXPECT_EQ(registry.GetOrEmplace<Counted>(dead, "dead"), nullptr);
+}
+
+TEST_F(RegistryTest, GetOrEmplaceKeepsExistingComponents) {
+  using Added = events::ComponentAddedEvent<Position>;
+  struct Listener : events::IEventListener<Added> {
+    void OnEvent(const Added&) override { ++added; }
+    int added = 0;
+  } listener;
+  registry.Subscribe<Added>(&listener);
+  EntityID e = registry.CreateEntity();
+  Position* first = registry.GetOrEmplace<Position>(e, 1.0f, 0.0f);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->x, 1.0f);
+  Position* second = registry.GetOrEmplace<Position>(e, 5.0f, 0.0f);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(second->x, 1.0f);
+  EXPECT_EQ(listener.added, 1);
+}
+
+struct Settings {
+  int difficulty = 1;
+  std::string name;
+};
+
+TEST_F(RegistryTest, ResourcesAreOnePerRegistry) {
+  EXPECT_FALSE(registry.HasResource<Settings>());
+  EXPECT_EQ(registry.GetResource<Settings>(), nullptr);
+
+  Settings& settings = registry.SetResource<Settings>(Settings{2, "hard"});
+  EXPECT_TRUE(registry.HasResource<Settings>());
+  EXPECT_EQ(registry.GetResource<Settings>(), &settings);
+  registry.GetResource<Settings>()->difficulty = 3;
+  EXPECT_EQ(settings.difficulty, 3);
+
+  // Setting again replaces the value; other registries are unaffected.
+  registry.SetResource<Settings>();
+  EXPECT_EQ(registry.GetResource<Settings>()->difficulty, 1);
+  Registry other;
+  EXPECT_FALSE(other.HasResource<Settings>());
+
+  registry.RemoveResource<Settings>();
+  EXPECT_FALSE(registry.HasResource<Settings>());
+  registry.SetResource<Settings>();
+  registry.Clear();
+  EXPECT_FALSE(registry.HasResource<Settings>());
+}
+
+struct Enemy : TagComponent {};
+
+struct Downed : TagComponent {};
+
+TEST_F(RegistryTest, TagsAreStoredAsBits) {
+  static_assert(std::is_same_v<StorageOf<Enemy>, TagStorage<Enemy>>);
+  std::vector<EntityID> entities = registry.CreateEntities(1000);
+  for (size_t i = 0; i < entities.size(); i += 100) {
+    registry.AddComponent<Enemy>(entities[i], {});
+  }
+  EXPECT_EQ(registry.GetStorage<Enemy>()->size(), 10u);
+  EXPECT_TRUE(registry.HasComponent<Enemy>(entities[300]));
+  EXPECT_FALSE(registry.HasComponent<Enemy>(entities[301]));
+
+  registry.RemoveComponent<Enemy>(entities[300]);
+  EXPECT_FALSE(registry.HasComponent<Enemy>(entities[300]));
+
+  // Destroying clears the bit, so the slot's next entity starts untagged and
+  // the stale handle is not reported as tagged either.
+  registry.AddComponent<Enemy>(entities[5], {});
+  registry.DeleteEntity(entities[5]);
+  EntityID reused = registry.CreateEntity();
+  ASSERT_EQ(GetEntityIndex(reused), GetEntityIndex(entities[5]));
+  EXPECT_FALSE(registry.HasComponent<Enemy>(reused));
+  registry.AddComponent<Enemy>(reused, {});
+  EXPECT_FALSE(registry.HasComponent<Enemy>(entities[5]));
+  EXPECT_EQ(registry.GetStorage<Enemy>()->size(), 10u);
+}
+
+struct Marker {};
+
+TEST_F(RegistryTest, TagsAreOptIn) {
+  // An empty type that does not derive from TagComponent keeps its ticks.
+  static_assert(std::is_same_v<StorageOf<Marker>, ComponentStorage<Marker>>);
+  const uint32_t since = registry.AdvanceTick();
+  EntityID marked = registry.CreateEntity();
+  registry.AddComponent<Marker>(marked, {});
+  auto added = registry.GetView<Marker>(Added<Marker>{since});
+  EXPECT_EQ(std::vector<EntityID>(added.begin(), added.end()),
+            std::vector<EntityID>{marked});
+
+  // Tags are reserved by entity slot, not by tag count.
+  registry.CreateEntities(1000);
+  registry.Reserve<Enemy>(200);
+  EXPECT_GE(registry.GetStorage<Enemy>()->stats().bytes,
+            (1200 + 63) / 64 * sizeof(uint64_t));
+}
+
+TEST_F(RegistryTest, TagsInViewsAndFilters) {
+  std::vector<EntityID> entities = registry.CreateEntities(500);
+  for (size_t i = 0; i < entities.size(); ++i) {
+    registry.AddComponent<Position>(entities[i], {static_cast<float>(i), 0});
+    if (i % 50 == 0) {
+      registry.AddComponent<Enemy>(entities[i], {});
+    }
+    if (i % 100 == 0) {
+      registry.AddComponent<Downed>(entities[i], {});
+    }
+  }
+
+  // Driven by the Enemy bitset rather than by the 500 positions.
+  std::vector<EntityID> enemies;
+  registry.GetView<Enemy>().Each(
+      [&enemies](EntityID e, Enemy&) { enemies.push_back(e); });
+  ASSERT_EQ(enemies.size(), 10u);
+  EXPECT_EQ(enemies[1], entities[50]);
+
+  float sum = 0.0f;
+  registry.GetView<Position>(With<Enemy>{}, Without<Downed>{})
+      .Each([&sum](EntityID, Position& p) { sum += p.x; });
+  EXPECT_EQ(sum, 50.0f + 150.0f + 250.0f + 350.0f + 450.0f);
+
+  size_t visited = 0;
+  registry.ParallelForEach<Position, Enemy>(
+      [&visited](Position&, Enemy&) { ++visited; }, 16);
+  EXPECT_EQ(visited, 10u);
+
+  auto group = registry.GetGroup<Position>(With<Downed>{});
+  EXPECT_EQ(group.size(), 5u);
+  registry.RemoveComponent<Downed>(entities[0]);
+  EXPECT_EQ(group.size(), 4u);
+}
+
+TEST_F(RegistryTest, StatsReportStoragesAndDispatchers) {
+  struct Listener : events::IEventListener<events::EntityCreatedEvent> {
+    void OnEvent(const events::EntityCreatedEvent&) override {}
+  } listener;
+  registry.Subscribe<events::EntityCreatedEvent>(&listener);
+  std::vector<EntityID> entities = registry.CreateEntities(100);
+  for (EntityID e : entities) {
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+  }
+  registry.AddComponent<Enemy>(entities[0], {});
+  registry.Publish<events::EntityCreatedEvent>({entities[0], &registry},
+                                               false);
+
+  RegistryStats stats = registry.GetStats();
+  EXPECT_EQ(stats.entities, 100u);
+  ASSERT_GE(stats.storages.size(), 2u);
+  const StorageStats& positions = stats.storages[0];
+  EXPECT_EQ(positions.name, "Position");
+  EXPECT_EQ(positions.size, 100u);
+  EXPECT_GE(positions.capacity, 100u);
+  EXPECT_GE(positions.bytes, 100 * sizeof(Position));
+  EXPECT_GT(positions.sparse_load, 0.0f);
+  EXPECT_EQ(stats.queued_events(), 1u);
+  EXPECT_EQ(stats.dispatchers[0].listeners, 1u);
+  EXPECT_NE(stats.ToString().find("Enemy"), std::string::npos);
+
+  // Emptied storages keep their capacity, which the report shows.
+  registry.DestroyEntities(entities);
+  registry.Update();
+  stats = registry.GetStats();
+  EXPECT_EQ(stats.storages[0].size, 0u);
+  EXPECT_GE(stats.storages[0].capacity, 100u);
+  EXPECT_EQ(stats.queued_events(), 0u);
+}
+
+TEST_F(RegistryTest, QueryFollowsAddsAndRemoves) {
+  std::vector<EntityID> entities = registry.CreateEntities(10);
+  for (size_t i = 0; i < entities.size(); ++i) {
+    registry.AddComponent<Position>(entities[i], {float(i), 0.0f});
+    if (i % 2 == 0) {
+      registry.AddComponent<Velocity>(entities[i], {1.0f, 0.0f});
+    }
+  }
+
+  auto query = registry.GetQuery<Position, Velocity>();
+  EXPECT_EQ(query.size(), 5u);
+  EXPECT_TRUE(query.Contains(entities[2]));
+  EXPECT_FALSE(query.Contains(entities[3]));
+
+  registry.AddComponent<Velocity>(entities[3], {1.0f, 0.0f});
+  registry.RemoveComponent<Position>(entities[4]);
+  registry.DeleteEntity(entities[6]);
+  EXPECT_EQ(query.size(), 4u);
+  EXPECT_TRUE(query.Contains(entities[3]));
+  EXPECT_FALSE(query.Contains(entities[4]));
+  EXPECT_FALSE(query.Contains(entities[6]));
+
+  // Later calls return the same, already populated query.
+  auto again = registry.GetQuery<Position, Velocity>();
+  EXPECT_EQ(again.entities().data(), query.entities().data());
+  std::vector<EntityID> visited;
+  again.Each([&visited](EntityID entity, Position& p, Velocity& v) {
+    p.x += v.vx;
+    visited.push_back(entity);
+  });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, (std::vector<EntityID>{entities[0], entities[2],
+                                            entities[3], entities[8]}));
+  EXPECT_EQ(registry.GetComponent<Position>(entities[3]).x, 4.0f);
+
+  registry.Clear();
+  EXPECT_TRUE(query.empty());
+}
+
+TEST_F(RegistryTest, QueryObservesTags) {
+  std::vector<EntityID> entities = registry.CreateEntities(4);
+  for (EntityID e : entities) {
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+  }
+  auto enemies = registry.GetQuery<Position>(With<Enemy>{});
+  auto all = registry.GetQuery<Position>();
+  EXPECT_TRUE(enemies.empty());
+  EXPECT_EQ(all.size(), 4u);
+
+  registry.AddComponent<Enemy>(entities[1], {});
+  registry.AddComponent<Enemy>(entities[2], {});
+  EXPECT_EQ(enemies.size(), 2u);
+  registry.RemoveComponent<Enemy>(entities[1]);
+  EXPECT_EQ(enemies.size(), 1u);
+  EXPECT_TRUE(enemies.Contains(entities[2]));
+  EXPECT_EQ(all.size(), 4u);
+}
+
+TEST_F(RegistryTest, ObserverCollectsAddsAndChanges) {
+  std::vector<EntityID> entities = registry.CreateEntities(6);
+  for (EntityID e : entities) {
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+  }
+
+  auto observer =
+      registry.GetObserver<OnAdded<Velocity>, OnChanged<Position>>();
+  EXPECT_TRUE(observer.empty());
+
+  registry.AddComponent<Velocity>(entities[0], {1.0f, 0.0f});
+  registry.PatchComponent<Position>(entities[1],
+                                    [](Position& p) { p.x = 1.0f; });
+  registry.MarkChanged<Position>(entities[2]);
+  registry.AddComponent<Position>(entities[3], {2.0f, 0.0f});
+  // Firing again, or through another trigger, collects an entity once.
+  registry.MarkChanged<Position>(entities[0]);
+  registry.MarkChanged<Position>(entities[1]);
+  // Writes through a plain reference go unnoticed.
+  registry.GetComponent<Position>(entities[4]).x = 3.0f;
+  EXPECT_EQ(observer.size(), 4u);
+  EXPECT_TRUE(observer.Contains(entities[3]));
+  EXPECT_FALSE(observer.Contains(entities[4]));
+
+  registry.DeleteEntity(entities[2]);
+  std::vector<EntityID> drained;
+  observer.Drain([&drained](EntityID entity) { drained.push_back(entity); });
+  EXPECT_EQ(drained, (std::vector<EntityID>{entities[0], entities[1],
+                                            entities[3]}));
+  EXPECT_TRUE(observer.empty());
+
+  // Nothing fired, so nothing is visited.
+  drained.clear();
+  registry.GetObserver<OnAdded<Velocity>, OnChanged<Position>>().Drain(
+      [&drained](EntityID entity) { drained.push_back(entity); });
+  EXPECT_TRUE(drained.empty());
+
+  // Entities that fire while being drained land in the next batch.
+  registry.MarkChanged<Position>(entities[5]);
+  observer.Drain([this](EntityID entity) {
+    registry.MarkChanged<Position>(entity);
+  });
+  EXPECT_EQ(observer.size(), 1u);
+  EXPECT_TRUE(observer.Contains(entities[5]));
+
+  registry.Clear();
+  EXPECT_TRUE(observer.empty());
+}
+
+TEST_F(RegistryTest, ObserverSeesTagsAdded) {
+  EntityID e = registry.CreateEntity();
+  auto observer = registry.GetObserver<OnAdded<Enemy>>();
+  registry.AddComponent<Enemy>(e, {});
+  EXPECT_TRUE(observer.Contains(e));
+  observer.Clear();
+  EXPECT_TRUE(observer.empty());
+}
+
+template <int I>
+struct Numbered {
+  int value;
+};
+
+template <int... Is>
+void AddNumbered(Registry& registry, EntityID entity,
+                 std::integer_sequence<int, Is...>) {
+  (registry.AddComponent<Numbered<Is>>(entity, {Is}), ...);
+}
+
+TEST_F(RegistryTest, ComponentMasksFollowEveryStorage) {
+  EntityID a = registry.CreateEntity();
+  EntityID b = registry.CreateEntity();
+  registry.AddComponent<Position>(a, {0.0f, 0.0f});
+  registry.AddComponent<Enemy>(a, {});
+  // Enough types to need more than one mask word.
+  AddNumbered(registry, b, std::make_integer_sequence<int, 70>{});
+  registry.AddComponent<Position>(b, {1.0f, 0.0f});
+
+  EXPECT_TRUE(registry.HasComponent<Enemy>(a));
+  EXPECT_FALSE(registry.HasComponent<Numbered<69>>(a));
+  EXPECT_TRUE(registry.HasComponent<Numbered<69>>(b));
+  auto numbered = registry.GetView<Position>(With<Numbered<69>>{});
+  EXPECT_TRUE(numbered.Contains(b));
+  EXPECT_FALSE(numbered.Contains(a));
+  size_t matches = 0;
+  registry.GetView<Position, Numbered<0>, Numbered<69>>().Each(
+      [&matches](EntityID, Position&, Numbered<0>&, Numbered<69>&) {
+        ++matches;
+      });
+  EXPECT_EQ(matches, 1u);
+  matches = 0;
+  registry.GetView<Position>(Without<Numbered<35>>{})
+      .Each([&matches](EntityID, Position&) { ++matches; });
+  EXPECT_EQ(matches, 1u);
+
+  registry.RemoveComponent<Numbered<35>>(b);
+  EXPECT_FALSE(registry.HasComponent<Numbered<35>>(b));
+  registry.DeleteEntity(b);
+  EXPECT_EQ(registry.GetStorage<Numbered<69>>()->size(), 0u);
+  EXPECT_EQ(registry.GetStorage<Position>()->size(), 1u);
+
+  // The slot is reused with an empty mask.
+  EntityID c = registry.CreateEntity();
+  EXPECT_EQ(GetEntityIndex(c), GetEntityIndex(b));
+  EXPECT_FALSE(registry.HasComponent<Numbered<0>>(c));
+  EXPECT_FALSE(registry.HasComponent<Position>(b));
+}
+
+TEST(RegistryResourceTest, StoragesAndQueuesUseTheResource) {
+  struct CountingResource : std::pmr::memory_resource {
+    void* do_allocate(size_t bytes, size_t alignment) override {
+      outstanding += bytes;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+      outstanding -= bytes;
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+    size_t outstanding = 0;
+  } resource;
+
+  {
+    Registry registry(StorageMode::kSparseSet, &resource);
+    EXPECT_EQ(registry.resource(), &resource);
+    std::vector<EntityID> entities = registry.CreateEntities(100);
+    for (EntityID e : entities) {
+      registry.AddComponent<Position>(e, {0.0f, 0.0f});
+    }
+    const size_t with_storage = resource.outstanding;
+    EXPECT_GE(with_storage, 100 * sizeof(Position));
+    registry.AddComponent<Enemy>(entities[0], {});
+    registry.Publish<events::EntityCreatedEvent>({entities[0], &registry},
+                                                 false);
+    EXPECT_GT(resource.outstanding, with_storage);
+  }
+  EXPECT_EQ(resource.outstanding, 0u);
+}
+
+class ArchetypeRegistryTest : public ::testing::Test {
+ protected:
+  Registry registry{StorageMode::kArchetype};
+};
+
+struct Name {
+  std::string value;
+};
+
+TEST_F(ArchetypeRegistryTest, ComponentManagement) {
+  EXPECT_EQ(registry.storage_mode(), StorageMode::kArchetype);
+  EntityID e = registry.CreateEntity();
+
+  registry.AddComponent<Position>(e, {10.0f, 20.0f});
+  registry.AddComponent<Velocity>(e, {1.0f, 2.0f});
+  EXPECT_TRUE(registry.HasComponent<Position>(e));
+  EXPECT_TRUE(registry.HasComponent<Velocity>(e));
+
+  // Moving between archetypes must preserve the existing values.
+  registry.RemoveComponent<Velocity>(e);
+  EXPECT_FALSE(registry.HasComponent<Velocity>(e));
+  EXPECT_EQ(registry.GetComponent<Position>(e).x, 10.0f);
+  EXPECT_EQ(registry.GetComponent<Position>(e).y, 20.0f);
+
+  registry.RemoveComponent<Position>(e);
+  EXPECT_FALSE(registry.HasComponent<Position>(e));
+  EXPECT_TRUE(registry.IsAlive(e));
+}
+
+TEST_F(ArchetypeRegistryTest, NonTrivialComponentsSurviveRowMoves) {
+  std::vector<EntityID> entities;
+  for (int i = 0; i < 1000; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Name>(e, {"entity_" + std::to_string(i)});
+    registry.AddComponent<Position>(e, {static_cast<float>(i), 0.0f});
+    entities.push_back(e);
+  }
+  // Deleting from the front repeatedly moves rows across chunks.
+  for (int i = 0; i < 500; ++i) {
+    registry.DeleteEntity(entities[i]);
+  }
+  for (int i = 500; i < 1000; ++i) {
+    EXPECT_EQ(registry.GetComponent<Name>(entities[i]).value,
+              "entity_" + std::to_string(i));
+    EXPECT_EQ(registry.GetComponent<Position>(entities[i]).x,
+              static_cast<float>(i));
+  }
+}
+
+TEST_F(ArchetypeRegistryTest, EmplaceAndGetOrEmplace) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {1.0f, 2.0f});
+  Name* name = registry.EmplaceComponent<Name>(e, "archetype");
+  ASSERT_NE(name, nullptr);
+  EXPECT_EQ(name->value, "archetype");
+  EXPECT_EQ(registry.GetComponent<Position>(e).y, 2.0f);
+  EXPECT_EQ(registry.GetOrEmplace<Name>(e, "ignored")->value, "archetype");
+  registry.EmplaceComponent<Name>(e, "replaced");
+  EXPECT_EQ(registry.GetComponent<Name>(e).value, "replaced");
+}
+
+TEST_F(ArchetypeRegistryTest, ViewSpansArchetypes) {
+  for (int i = 0; i < 300; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {1.0f, 1.0f});
+    if (i % 2 == 0) {
+      registry.AddComponent<Velocity>(e, {1.0f, 1.0f});
+    }
+    if (i % 3 == 0) {
+      registry.AddComponent<Name>(e, {"named"});
+    }
+  }
+
+  int count = 0;
+  registry.ForEach<Position, Velocity>([&count](Position& p, Velocity& v) {
+    p.x += v.vx;
+    count++;
+  });
+  EXPECT_EQ(count, 150);
+
+  auto view = registry.GetView<Position, Velocity>();
+  EXPECT_EQ(std::distance(view.begin(), view.end()), 150);
+  for (EntityID e : view) {
+    EXPECT_EQ(registry.GetComponent<Position>(e).x, 2.0f);
+  }
+}
+
+TEST_F(ArchetypeRegistryTest, ForEachChunkWalksColumns) {
+  for (int i = 0; i < 2000; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+    registry.AddComponent<Velocity>(e, {1.0f, 2.0f});
+  }
+
+  size_t rows = 0;
+  registry.ForEachChunk<Position, Velocity>(
+      [&rows](size_t count, const EntityID*, Position* p, Velocity* v) {
+        for (size_t i = 0; i < count; ++i) {
+          p[i].x += v[i].vx;
+          p[i].y += v[i].vy;
+        }
+        rows += count;
+      });
+
+  EXPECT_EQ(rows, 2000u);
+  registry.ForEach<Position>([](Position& p) {
+    EXPECT_EQ(p.x, 1.0f);
+    EXPECT_EQ(p.y, 2.0f);
+  });
+}
+
+TEST_F(ArchetypeRegistryTest, ParallelForEachSpansArchetypes) {
+  core::JobSystem::Get().Init();
+  for (int i = 0; i < 3000; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {0.0f, 0.0f});
+    registry.AddComponent<Velocity>(e, {1.0f, 0.0f});
+    if (i % 2 == 0) {
+      registry.AddComponent<Name>(e, {"named"});
+    }
+  }
+
+  registry.ParallelForEach<Position, Velocity>(
+      [](Position& p, Velocity& v) { p.x += v.vx; }, 100);
+  core::JobSystem::Get().Shutdown();
+
+  int count = 0;
+  registry.ForEach<Position>([&count](Position& p) {
+    EXPECT_EQ(p.x, 1.0f);
+    count++;
+  });
+  EXPECT_EQ(count, 3000);
+}
+
+TEST_F(ArchetypeRegistryTest, DeleteEntityPublishesRemovals) {
+  struct Listener
+      : events::IEventListener<events::ComponentRemovedEvent<Name>> {
+    void OnEvent(const events::ComponentRemovedEvent<Name>& event) override {
+      removed = event.component.value;
+    }
+    std::string removed;
+  } listener;
+  registry.Subscribe<events::ComponentRemovedEvent<Name>>(&listener);
+
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Name>(e, {"doomed"});
+  registry.DeleteEntity(e);
+
+  EXPECT_EQ(listener.removed, "doomed");
+  EXPECT_FALSE(registry.IsAlive(e));
+}
+
+TEST_F(ArchetypeRegistryTest, WithAndWithoutFilters) {
+  for (int i = 0; i < 4; ++i) {
+    EntityID e = registry.CreateEntity();
+    registry.AddComponent<Position>(e, {static_cast<float>(i), 0.0f});
+    if (i % 2 == 0) {
+      registry.AddComponent<Enemy>(e, {});
+    }
+    if (i == 2) {
+      registry.AddComponent<Downed>(e, {});
+    }
+  }
+  std::vector<float> xs;
+  registry.GetView<Position>(With<Enemy>{}, Without<Downed>{})
+      .Each([&xs](EntityID, Position& p) { xs.push_back(p.x); });
+  EXPECT_EQ(xs, std::vector<float>{0.0f});
+}
+
+TEST_F(ArchetypeRegistryTest, GroupIteratesLikeAView) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {1.0f, 0.0f});
+  registry.AddComponent<Velocity>(e, {2.0f, 0.0f});
+  registry.AddComponent<Position>(registry.CreateEntity(), {0.0f, 0.0f});
+
+  auto group = registry.GetGroup<Position, Velocity>();
+  EXPECT_EQ(group.size(), 1u);
+  EXPECT_TRUE(group.Contains(e));
+  EXPECT_EQ(group.entities(), nullptr);
+  group.Each([](EntityID, Position& p, Velocity& v) { p.x += v.vx; });
+  EXPECT_EQ(registry.GetComponent<Position>(e).x, 3.0f);
+}
+
+TEST_F(ArchetypeRegistryTest, QueryIteratesLikeAView) {
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {1.0f, 0.0f});
+  registry.AddComponent<Velocity>(e, {2.0f, 0.0f});
+  registry.AddComponent<Position>(registry.CreateEntity(), {0.0f, 0.0f});
+
+  auto query = registry.GetQuery<Position>(With<Velocity>{});
+  EXPECT_EQ(query.size(), 1u);
+  EXPECT_TRUE(query.Contains(e));
+  EXPECT_TRUE(query.entities().empty());
+  query.Each([](EntityID, Position& p) { p.x += 1.0f; });
+  EXPECT_EQ(registry.GetComponent<Position>(e).x, 2.0f);
+}
+
+TEST_F(ArchetypeRegistryTest, ObserverDrainsEveryTriggerComponent) {
+  EntityID a = registry.CreateEntity();
+  EntityID b = registry.CreateEntity();
+  registry.AddComponent<Position>(a, {0.0f, 0.0f});
+  registry.AddComponent<Velocity>(a, {0.0f, 0.0f});
+  registry.AddComponent<Velocity>(b, {0.0f, 0.0f});
+  registry.AddComponent<Position>(registry.CreateEntity(), {0.0f, 0.0f});
+
+  // Without change ticks every entity with a trigger component is visited.
+  std::vector<EntityID> drained;
+  registry.GetObserver<OnChanged<Velocity>>().Drain(
+      [&drained](EntityID entity) { drained.push_back(entity); });
+  std::sort(drained.begin(), drained.end());
+  EXPECT_EQ(drained, (std::vector<EntityID>{a, b}));
+
+  drained.clear();
+  registry.GetObserver<OnAdded<Position>, OnChanged<Velocity>>().Drain(
+      [&drained](EntityID entity) { drained.push_back(entity); });
+  EXPECT_EQ(drained.size(), 3u);
+}
+
 } // namespace engine::ecs
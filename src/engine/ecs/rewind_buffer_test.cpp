@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <engine/ecs/registry.h>
+#include <engine/ecs/rewind_buffer.h>
+
+namespace engine::ecs {
+
+struct Position {
+  float x, y;
+};
+
+struct Health {
+  int value;
+};
+
+class RewindBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    entities = registry.CreateEntities(1000);
+    for (EntityID e : entities) {
+      registry.AddComponent<Position>(e, {0.0f, 0.0f});
+    }
+  }
+
+  void Step() {
+    registry.ForEach<Position>([](Position& p) { p.x += 1.0f; });
+  }
+
+  Registry registry;
+  std::vector<EntityID> entities;
+};
+
+TEST_F(RewindBufferTest, RestoresRecordedFrames) {
+  RewindBuffer<Position, Health> rewind(&registry, 120);
+  for (uint64_t frame = 0; frame < 10; ++frame) {
+    rewind.Capture(frame);
+    Step();
+  }
+  EXPECT_EQ(rewind.size(), 10u);
+  EXPECT_EQ(registry.GetComponent<Position>(entities[5]).x, 10.0f);
+
+  ASSERT_TRUE(rewind.Restore(4));
+  EXPECT_EQ(registry.GetComponent<Position>(entities[5]).x, 4.0f);
+  EXPECT_EQ(registry.GetComponent<Position>(entities[999]).x, 4.0f);
+
+  // Resimulating drops the frames that were rewound past.
+  rewind.Capture(5);
+  EXPECT_EQ(rewind.newest_frame(), 5u);
+  EXPECT_FALSE(rewind.Contains(6));
+  EXPECT_FALSE(rewind.Restore(9));
+}
+
+TEST_F(RewindBufferTest, KeepsOnlyTheLastFrames) {
+  RewindBuffer<Position> rewind(&registry, 3);
+  for (uint64_t frame = 0; frame < 5; ++frame) {
+    rewind.Capture(frame);
+    Step();
+  }
+  EXPECT_EQ(rewind.size(), 3u);
+  EXPECT_EQ(rewind.oldest_frame(), 2u);
+  EXPECT_FALSE(rewind.Restore(1));
+  ASSERT_TRUE(rewind.Restore(2));
+  EXPECT_EQ(registry.GetComponent<Position>(entities[0]).x, 2.0f);
+}
+
+TEST_F(RewindBufferTest, OnlyChangedComponentsAreTouched) {
+  RewindBuffer<Position> rewind(&registry, 8);
+  rewind.Capture(0);
+  registry.GetComponent<Position>(entities[700]).y = 5.0f;
+  const uint32_t since = registry.AdvanceTick();
+
+  ASSERT_TRUE(rewind.Restore(0));
+  EXPECT_EQ(registry.GetComponent<Position>(entities[700]).y, 0.0f);
+  size_t changed = 0;
+  registry.GetView<Position>(Changed<Position>{since})
+      .Each([&changed](EntityID, Position&) { ++changed; });
+  EXPECT_EQ(changed, RewindBuffer<Position>::kBlockSize);
+}
+
+TEST_F(RewindBufferTest, RestoresAddedAndRemovedComponents) {
+  RewindBuffer<Position, Health> rewind(&registry, 8);
+  registry.AddComponent<Health>(entities[1], {10});
+  rewind.Capture(0);
+
+  registry.RemoveComponent<Health>(entities[1]);
+  registry.AddComponent<Health>(entities[2], {20});
+  registry.RemoveComponent<Position>(entities[3]);
+  ASSERT_TRUE(rewind.Restore(0));
+
+  ASSERT_TRUE(registry.HasComponent<Health>(entities[1]));
+  EXPECT_EQ(registry.GetComponent<Health>(entities[1]).value, 10);
+  EXPECT_FALSE(registry.HasComponent<Health>(entities[2]));
+  EXPECT_TRUE(registry.HasComponent<Position>(entities[3]));
+  EXPECT_EQ(registry.GetStorage<Position>()->size(), 1000u);
+}
+
+}  // namespace engine::ecs
@@ -0,0 +1,575 @@
+/**
+ * @file snapshot.cpp
+ * @brief Registry snapshot saving and memory-mapped loading.
+ */
+
+#include <engine/ecs/snapshot.h>
+
+#include <fstream>
+#include <memory>
+#include <utility>
+
+#include <engine/ecs/components/camera_component.h>
+#include <engine/ecs/components/circle.h>
+#include <engine/ecs/components/collider.h>
+#include <engine/ecs/components/gravity.h>
+#include <engine/ecs/components/lifetime.h>
+#include <engine/ecs/components/light.h>
+#include <engine/ecs/components/line.h>
+#include <engine/ecs/components/occluder.h>
+#include <engine/ecs/components/parent.h>
+#include <engine/ecs/components/point.h>
+#include <engine/ecs/components/polygon.h>
+#include <engine/ecs/components/quad.h>
+#include <engine/ecs/components/sprite.h>
+#include <engine/ecs/components/text.h>
+#include <engine/ecs/components/transform.h>
+#include <engine/ecs/components/triangle.h>
+#include <engine/ecs/components/ui_hierarchy.h>
+#include <engine/ecs/components/ui_transform.h>
+#include <engine/ecs/components/velocity.h>
+#include <engine/ecs/components/waypoint_path.h>
+#include <engine/ecs/components/world_transform.h>
+#include <engine/util/logger.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine::ecs {
+
+namespace {
+
+/** @brief "GESS" in little-endian byte order. */
+constexpr uint32_t kSnapshotMagic = 0x53534547;
+
+/** @brief Bumped whenever the layout below changes. */
+constexpr uint32_t kSnapshotVersion = 2;
+
+/**
+ * @brief Read-only view of a whole file, mapped into memory.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      return;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+      return;
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+      return;
+    }
+    data_ = static_cast<const uint8_t*>(
+        MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    size_ = data_ ? static_cast<size_t>(size.QuadPart) : 0;
+#else
+    fd_ = open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      return;
+    }
+    struct stat info;
+    if (fstat(fd_, &info) != 0 || info.st_size == 0) {
+      return;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                      MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+      return;
+    }
+    data_ = static_cast<const uint8_t*>(data);
+    size_ = static_cast<size_t>(info.st_size);
+#endif
+  }
+
+  ~MappedFile() {
+#ifdef _WIN32
+    if (data_) {
+      UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+      CloseHandle(mapping_);
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+      CloseHandle(file_);
+    }
+#else
+    if (data_) {
+      munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+#ifdef _WIN32
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+/** @brief A column as laid out in the file. */
+struct ColumnHeader {
+  std::string name;
+  uint32_t raw_size = 0;
+  const uint8_t* payload = nullptr;
+  uint64_t payload_size = 0;
+};
+
+/** @brief Reads the header of the next column and skips its payload. */
+bool ReadColumnHeader(SnapshotReader& reader, ColumnHeader* column) {
+  uint64_t size = 0;
+  reader.ReadString(&column->name);
+  reader.Read(&column->raw_size);
+  reader.Read(&size);
+  reader.Align(kSnapshotAlignment);
+  column->payload = static_cast<const uint8_t*>(
+      reader.Read(static_cast<size_t>(size)));
+  column->payload_size = size;
+  reader.Align(kSnapshotAlignment);
+  return reader.ok();
+}
+
+/** @brief Registers the engine's own components on first use. */
+void RegisterEngineTypes() {
+  using namespace components;
+  RegisterSnapshotType<CameraComponent>("CameraComponent");
+  RegisterSnapshotType<Circle>("Circle");
+  RegisterSnapshotType<Gravity>("Gravity");
+  RegisterSnapshotType<Lifetime>("Lifetime");
+  RegisterSnapshotType<Light>("Light");
+  RegisterSnapshotType<Line>("Line");
+  RegisterSnapshotType<Occluder>("Occluder");
+  RegisterSnapshotType<Parent>("Parent");
+  RegisterSnapshotType<Point>("Point");
+  RegisterSnapshotType<Quad>("Quad");
+  RegisterSnapshotType<Transform>("Transform");
+  RegisterSnapshotType<Triangle>("Triangle");
+  RegisterSnapshotType<UiTransform>("UiTransform");
+  RegisterSnapshotType<Velocity>("Velocity");
+  RegisterSnapshotType<WorldTransform>("WorldTransform");
+
+  // The collision callback cannot be serialized and is left empty.
+  RegisterSnapshotType<Collider>(
+      "Collider",
+      [](const Collider& collider, SnapshotWriter& writer) {
+        writer.Write(collider.size);
+        writer.Write(collider.offset);
+        writer.Write(collider.is_static);
+        writer.Write(collider.is_trigger);
+      },
+      [](SnapshotReader& reader, Collider* collider) {
+        reader.Read(&collider->size);
+        reader.Read(&collider->offset);
+        reader.Read(&collider->is_static);
+        return reader.Read(&collider->is_trigger);
+      });
+  RegisterSnapshotType<Polygon>(
+      "Polygon",
+      [](const Polygon& polygon, SnapshotWriter& writer) {
+        writer.WriteVector(polygon.vertices);
+        writer.Write(polygon.color);
+        writer.Write(polygon.z_index);
+      },
+      [](SnapshotReader& reader, Polygon* polygon) {
+        reader.ReadVector(&polygon->vertices);
+        reader.Read(&polygon->color);
+        return reader.Read(&polygon->z_index);
+      });
+  RegisterSnapshotType<Sprite>(
+      "Sprite",
+      [](const Sprite& sprite, SnapshotWriter& writer) {
+        writer.WriteString(sprite.texture_name);
+        writer.WriteString(sprite.sprite_sheet_name);
+        writer.Write(sprite.sprite_index);
+        writer.Write(sprite.tint);
+        writer.Write(sprite.origin);
+        writer.Write(sprite.z_index);
+        writer.Write(sprite.visible);
+      },
+      [](SnapshotReader& reader, Sprite* sprite) {
+        reader.ReadString(&sprite->texture_name);
+        reader.ReadString(&sprite->sprite_sheet_name);
+        reader.Read(&sprite->sprite_index);
+        reader.Read(&sprite->tint);
+        reader.Read(&sprite->origin);
+        reader.Read(&sprite->z_index);
+        return reader.Read(&sprite->visible);
+      });
+  RegisterSnapshotType<Text>(
+      "Text",
+      [](const Text& text, SnapshotWriter& writer) {
+        writer.WriteString(text.content);
+        writer.WriteString(text.font_name);
+        writer.Write(text.scale);
+        writer.Write(text.color);
+        writer.Write(text.z_index);
+      },
+      [](SnapshotReader& reader, Text* text) {
+        reader.ReadString(&text->content);
+        reader.ReadString(&text->font_name);
+        reader.Read(&text->scale);
+        reader.Read(&text->color);
+        return reader.Read(&text->z_index);
+      });
+  RegisterSnapshotType<UiHierarchy>(
+      "UiHierarchy",
+      [](const UiHierarchy& hierarchy, SnapshotWriter& writer) {
+        writer.Write(hierarchy.parent);
+        writer.WriteVector(hierarchy.children);
+      },
+      [](SnapshotReader& reader, UiHierarchy* hierarchy) {
+        reader.Read(&hierarchy->parent);
+        return reader.ReadVector(&hierarchy->children);
+      });
+  RegisterSnapshotType<WaypointPath>(
+      "WaypointPath",
+      [](const WaypointPath& path, SnapshotWriter& writer) {
+        writer.WriteVector(path.points);
+        writer.Write(path.current_index);
+        writer.Write(path.speed);
+        writer.Write(path.loop);
+        writer.Write(path.finished);
+        writer.Write(path.arrival_threshold);
+      },
+      [](SnapshotReader& reader, WaypointPath* path) {
+        reader.ReadVector(&path->points);
+        reader.Read(&path->current_index);
+        reader.Read(&path->speed);
+        reader.Read(&path->loop);
+        reader.Read(&path->finished);
+        return reader.Read(&path->arrival_threshold);
+      });
+}
+
+/**
+ * @brief Snapshot types indexed by ComponentTypeId; may have holes. The
+ * engine's own components are registered on first use.
+ */
+std::vector<std::unique_ptr<SnapshotType>>& SnapshotTypes() {
+  static std::vector<std::unique_ptr<SnapshotType>> types;
+  static bool engine_types_registered = false;
+  if (!engine_types_registered) {
+    engine_types_registered = true;
+    RegisterEngineTypes();
+  }
+  return types;
+}
+
+/** @brief Resource snapshot types indexed by ResourceTypeId; may have holes. */
+std::vector<std::unique_ptr<SnapshotResourceType>>& SnapshotResourceTypes() {
+  static std::vector<std::unique_ptr<SnapshotResourceType>> types;
+  return types;
+}
+
+/**
+ * @brief Writes one column: its name, raw size and payload size, then the
+ * payload produced by `save`.
+ */
+template <typename Save>
+void WriteColumn(SnapshotWriter& writer, const std::string& name,
+                 uint32_t raw_size, Save&& save) {
+  writer.WriteString(name);
+  writer.Write(raw_size);
+  const size_t size_offset = writer.size();
+  writer.Write(uint64_t{0});
+  writer.Align(kSnapshotAlignment);
+  const size_t payload_start = writer.size();
+  save(writer);
+  writer.Patch(size_offset,
+               static_cast<uint64_t>(writer.size() - payload_start));
+  writer.Align(kSnapshotAlignment);
+}
+
+}  // namespace
+
+namespace detail {
+
+bool CheckSnapshotEntities(const EntityID* entities, uint32_t count,
+                           const SnapshotSlots& slots) {
+  std::vector<bool> seen(slots.size());
+  for (uint32_t i = 0; i < count; ++i) {
+    if (!slots.IsAlive(entities[i])) {
+      return false;
+    }
+    const uint32_t index = GetEntityIndex(entities[i]);
+    if (seen[index]) {
+      return false;
+    }
+    seen[index] = true;
+  }
+  return true;
+}
+
+void AddSnapshotType(uint32_t component_type, SnapshotType type) {
+  std::vector<std::unique_ptr<SnapshotType>>& types = SnapshotTypes();
+  for (uint32_t id = 0; id < types.size(); ++id) {
+    if (id != component_type && types[id] && types[id]->name == type.name) {
+      LOG_ERR("Snapshot type name '%s' is already in use.", type.name.c_str());
+      return;
+    }
+  }
+  if (component_type >= types.size()) {
+    types.resize(component_type + 1);
+  }
+  types[component_type] = std::make_unique<SnapshotType>(std::move(type));
+}
+
+const SnapshotType* FindSnapshotType(uint32_t component_type) {
+  const std::vector<std::unique_ptr<SnapshotType>>& types = SnapshotTypes();
+  return component_type < types.size() ? types[component_type].get() : nullptr;
+}
+
+const SnapshotType* FindSnapshotType(std::string_view name) {
+  for (const auto& type : SnapshotTypes()) {
+    if (type && type->name == name) {
+      return type.get();
+    }
+  }
+  return nullptr;
+}
+
+void AddSnapshotResourceType(uint32_t resource_type,
+                             SnapshotResourceType type) {
+  std::vector<std::unique_ptr<SnapshotResourceType>>& types =
+      SnapshotResourceTypes();
+  for (uint32_t id = 0; id < types.size(); ++id) {
+    if (id != resource_type && types[id] && types[id]->name == type.name) {
+      LOG_ERR("Snapshot resource name '%s' is already in use.",
+              type.name.c_str());
+      return;
+    }
+  }
+  if (resource_type >= types.size()) {
+    types.resize(resource_type + 1);
+  }
+  types[resource_type] =
+      std::make_unique<SnapshotResourceType>(std::move(type));
+}
+
+const SnapshotResourceType* FindSnapshotResourceType(uint32_t resource_type) {
+  const std::vector<std::unique_ptr<SnapshotResourceType>>& types =
+      SnapshotResourceTypes();
+  return resource_type < types.size() ? types[resource_type].get() : nullptr;
+}
+
+const SnapshotResourceType* FindSnapshotResourceType(std::string_view name) {
+  for (const auto& type : SnapshotResourceTypes()) {
+    if (type && type->name == name) {
+      return type.get();
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace detail
+
+bool Registry::SaveSnapshot(const std::string& path) {
+  if (archetypes_) {
+    LOG_ERR("Snapshots are not supported by archetype registries.");
+    return false;
+  }
+  std::vector<std::pair<const SnapshotType*, IComponentStorage*>> columns;
+  for (uint32_t id = 0; id < storages_.size(); ++id) {
+    if (!storages_[id] || storages_[id]->size() == 0) {
+      continue;
+    }
+    const SnapshotType* type = detail::FindSnapshotType(id);
+    if (!type) {
+      LOG_WARN("Component type %u has no snapshot serializer; skipped.", id);
+      continue;
+    }
+    columns.emplace_back(type, storages_[id].get());
+  }
+  std::vector<std::pair<const SnapshotResourceType*, IResource*>> resources;
+  for (uint32_t id = 0; id < resources_.size(); ++id) {
+    if (!resources_[id]) {
+      continue;
+    }
+    const SnapshotResourceType* type = detail::FindSnapshotResourceType(id);
+    if (!type) {
+      LOG_WARN("Resource type %u has no snapshot serializer; skipped.", id);
+      continue;
+    }
+    resources.emplace_back(type, resources_[id].get());
+  }
+
+  const std::vector<EntityID>& slots = entity_manager_.slots();
+  const std::vector<uint32_t>& free_indices = entity_manager_.free_indices();
+  SnapshotWriter writer;
+  writer.Write(kSnapshotMagic);
+  writer.Write(kSnapshotVersion);
+  writer.Write(static_cast<uint32_t>(slots.size()));
+  writer.Write(static_cast<uint32_t>(free_indices.size()));
+  writer.Write(static_cast<uint32_t>(columns.size()));
+  writer.Write(static_cast<uint32_t>(resources.size()));
+  writer.Align(kSnapshotAlignment);
+  writer.Write(slots.data(), slots.size() * sizeof(EntityID));
+  writer.Write(free_indices.data(), free_indices.size() * sizeof(uint32_t));
+  writer.Align(kSnapshotAlignment);
+
+  for (const auto& [type, storage] : columns) {
+    WriteColumn(writer, type->name, type->raw_size,
+                [&](SnapshotWriter& out) { type->save(*storage, out); });
+  }
+  for (const auto& [type, resource] : resources) {
+    WriteColumn(writer, type->name, type->raw_size,
+                [&](SnapshotWriter& out) { type->save(*resource, out); });
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(writer.data()),
+             static_cast<std::streamsize>(writer.size()));
+  if (!file) {
+    LOG_ERR("Failed to write snapshot '%s'.", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool Registry::LoadSnapshot(const std::string& path) {
+  CheckStructuralChange("LoadSnapshot");
+  if (archetypes_) {
+    LOG_ERR("Snapshots are not supported by archetype registries.");
+    return false;
+  }
+  MappedFile file(path);
+  if (!file.data()) {
+    LOG_ERR("Failed to open snapshot '%s'.", path.c_str());
+    return false;
+  }
+
+  // Validate the whole file before touching the registry.
+  SnapshotReader reader(file.data(), file.size());
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t slot_count = 0;
+  uint32_t free_count = 0;
+  uint32_t column_count = 0;
+  uint32_t resource_count = 0;
+  reader.Read(&magic);
+  reader.Read(&version);
+  reader.Read(&slot_count);
+  reader.Read(&free_count);
+  reader.Read(&column_count);
+  reader.Read(&resource_count);
+  if (!reader.ok() || magic != kSnapshotMagic ||
+      version != kSnapshotVersion) {
+    LOG_ERR("'%s' is not a version %u snapshot.", path.c_str(),
+            kSnapshotVersion);
+    return false;
+  }
+  reader.Align(kSnapshotAlignment);
+  const EntityID* slots = reader.ReadArray<EntityID>(slot_count);
+  const uint32_t* free_indices = reader.ReadArray<uint32_t>(free_count);
+  reader.Align(kSnapshotAlignment);
+  std::vector<ColumnHeader> columns(column_count);
+  for (ColumnHeader& column : columns) {
+    ReadColumnHeader(reader, &column);
+  }
+  std::vector<ColumnHeader> resources(resource_count);
+  for (ColumnHeader& resource : resources) {
+    ReadColumnHeader(reader, &resource);
+  }
+  bool valid = reader.ok() && slot_count <= kMaxEntities;
+  for (uint32_t i = 0; valid && i < slot_count; ++i) {
+    const uint32_t index = GetEntityIndex(slots[i]);
+    valid = index == i || index == kEntityIndexMask;
+  }
+  for (uint32_t i = 0; valid && i < free_count; ++i) {
+    valid = free_indices[i] < slot_count &&
+            GetEntityIndex(slots[free_indices[i]]) == kEntityIndexMask;
+  }
+  if (!valid) {
+    LOG_ERR("Snapshot '%s' is truncated or corrupt.", path.c_str());
+    return false;
+  }
+
+  // Decode every column too, so a corrupt one is caught while the registry
+  // is still intact.
+  const SnapshotSlots live(slots, slot_count);
+  std::vector<std::unique_ptr<SnapshotColumn>> decoded;
+  for (const ColumnHeader& column : columns) {
+    const SnapshotType* type = detail::FindSnapshotType(column.name);
+    if (!type) {
+      LOG_WARN("Snapshot column '%s' has no registered type; skipped.",
+               column.name.c_str());
+      continue;
+    }
+    if (type->raw_size != column.raw_size) {
+      LOG_ERR("Snapshot column '%s' was saved with a different layout.",
+              column.name.c_str());
+      continue;
+    }
+    SnapshotReader column_reader(column.payload,
+                                 static_cast<size_t>(column.payload_size));
+    decoded.push_back(type->decode(column_reader, live));
+    if (!decoded.back()) {
+      LOG_ERR("Snapshot column '%s' is corrupt.", column.name.c_str());
+      return false;
+    }
+  }
+  for (const ColumnHeader& resource : resources) {
+    const SnapshotResourceType* type =
+        detail::FindSnapshotResourceType(resource.name);
+    if (!type) {
+      LOG_WARN("Snapshot resource '%s' has no registered type; skipped.",
+               resource.name.c_str());
+      continue;
+    }
+    if (type->raw_size != resource.raw_size) {
+      LOG_ERR("Snapshot resource '%s' was saved with a different layout.",
+              resource.name.c_str());
+      continue;
+    }
+    SnapshotReader resource_reader(resource.payload,
+                                   static_cast<size_t>(resource.payload_size));
+    decoded.push_back(type->decode(resource_reader));
+    if (!decoded.back()) {
+      LOG_ERR("Snapshot resource '%s' is corrupt.", resource.name.c_str());
+      return false;
+    }
+  }
+
+  ClearContents();
+  entity_manager_.Restore(slots, slot_count, free_indices, free_count);
+  for (const auto& column : decoded) {
+    column->Commit(*this);
+  }
+
+  if (HasSubscribers<events::EntityCreatedEvent>()) {
+    for (uint32_t i = 0; i < slot_count; ++i) {
+      if (GetEntityIndex(slots[i]) == i) {
+        Publish<events::EntityCreatedEvent>({slots[i], this});
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace engine::ecs
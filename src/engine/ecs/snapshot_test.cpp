@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <engine/ecs/components/sprite.h>
+#include <engine/ecs/components/transform.h>
+#include <engine/ecs/components/velocity.h>
+#include <engine/ecs/components/waypoint_path.h>
+#include <engine/ecs/registry.h>
+#include <engine/ecs/snapshot.h>
+
+namespace engine::ecs {
+
+using components::Sprite;
+using components::Transform;
+using components::Velocity;
+using components::WaypointPath;
+
+struct Tag {
+  std::string name;
+};
+
+struct Unsaved {
+  int value;
+};
+
+/** @brief Serialized component whose reader rejects the name "corrupt". */
+struct Fragile {
+  std::string name;
+};
+
+class SnapshotTest : public ::testing::Test {
+ protected:
+  void TearDown() override { std::remove(path.c_str()); }
+
+  std::string path =
+      (std::filesystem::temp_directory_path() / "snapshot_test.bin").string();
+  Registry registry;
+};
+
+TEST_F(SnapshotTest, RoundTripKeepsHandlesAndComponents) {
+  std::vector<EntityID> entities = registry.CreateEntities(1000);
+  for (size_t i = 0; i < entities.size(); ++i) {
+    const float x = static_cast<float>(i);
+    registry.AddComponent<Transform>(entities[i], {{x, 2.0f * x}});
+    if (i % 2 == 0) {
+      registry.AddComponent<Velocity>(entities[i], {{1.0f, x}});
+    }
+  }
+  registry.AddComponent<Sprite>(entities[3], {"hero", "sheet", 7});
+  registry.AddComponent<WaypointPath>(entities[4], {{{1, 2}, {3, 4}}, 1});
+  registry.AddComponent<Unsaved>(entities[5], {42});
+  registry.DeleteEntity(entities[10]);
+  registry.DeleteEntity(entities[11]);
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+
+  Registry loaded;
+  loaded.CreateEntity();
+  ASSERT_TRUE(loaded.LoadSnapshot(path));
+  EXPECT_EQ(loaded.GetEntityCount(), 998u);
+  EXPECT_FALSE(loaded.IsAlive(entities[10]));
+  ASSERT_TRUE(loaded.IsAlive(entities[999]));
+  EXPECT_EQ(loaded.GetStorage<Transform>()->size(), 998u);
+  EXPECT_EQ(loaded.GetComponent<Transform>(entities[999]).position.y, 1998.0f);
+  EXPECT_EQ(loaded.GetComponent<Velocity>(entities[998]).velocity.y, 998.0f);
+  EXPECT_FALSE(loaded.HasComponent<Velocity>(entities[999]));
+  EXPECT_EQ(loaded.GetComponent<Sprite>(entities[3]).texture_name, "hero");
+  EXPECT_EQ(loaded.GetComponent<Sprite>(entities[3]).sprite_index, 7);
+  const WaypointPath& waypoints =
+      loaded.GetComponent<WaypointPath>(entities[4]);
+  ASSERT_EQ(waypoints.points.size(), 2u);
+  EXPECT_EQ(waypoints.points[1].x, 3.0f);
+  EXPECT_EQ(waypoints.current_index, 1);
+  EXPECT_FALSE(loaded.HasComponent<Unsaved>(entities[5]));
+
+  // The free list comes back too, so slots are reused in the same order.
+  EXPECT_EQ(loaded.CreateEntity(), registry.CreateEntity());
+}
+
+TEST_F(SnapshotTest, CustomSerializer) {
+  RegisterSnapshotType<Tag>(
+      "SnapshotTest.Tag",
+      [](const Tag& tag, SnapshotWriter& writer) {
+        writer.WriteString(tag.name);
+      },
+      [](SnapshotReader& reader, Tag* tag) {
+        return reader.ReadString(&tag->name);
+      });
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Tag>(e, {"player"});
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+
+  registry.Clear();
+  ASSERT_TRUE(registry.LoadSnapshot(path));
+  ASSERT_TRUE(registry.HasComponent<Tag>(e));
+  EXPECT_EQ(registry.GetComponent<Tag>(e).name, "player");
+}
+
+struct Boss : TagComponent {};
+
+TEST_F(SnapshotTest, TagsRoundTrip) {
+  RegisterSnapshotType<Boss>("SnapshotTest.Boss");
+  std::vector<EntityID> entities = registry.CreateEntities(200);
+  registry.AddComponent<Boss>(entities[3], {});
+  registry.AddComponent<Boss>(entities[130], {});
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+
+  Registry loaded;
+  ASSERT_TRUE(loaded.LoadSnapshot(path));
+  EXPECT_EQ(loaded.GetStorage<Boss>()->size(), 2u);
+  EXPECT_TRUE(loaded.HasComponent<Boss>(entities[3]));
+  EXPECT_TRUE(loaded.HasComponent<Boss>(entities[130]));
+  EXPECT_FALSE(loaded.HasComponent<Boss>(entities[4]));
+}
+
+TEST_F(SnapshotTest, LoadedComponentsJoinGroups) {
+  std::vector<EntityID> entities = registry.CreateEntities(10);
+  for (EntityID e : entities) {
+    registry.AddComponent<Transform>(e, {});
+  }
+  registry.AddComponent<Velocity>(entities[7], {});
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+
+  Registry loaded;
+  auto group = loaded.GetGroup<Velocity>(With<Transform>{});
+  ASSERT_TRUE(loaded.LoadSnapshot(path));
+  ASSERT_EQ(group.size(), 1u);
+  EXPECT_EQ(group.entities()[0], entities[7]);
+}
+
+struct Clock {
+  uint64_t frame;
+  float scale;
+};
+
+struct Weather {
+  std::string name;
+};
+
+TEST_F(SnapshotTest, ResourcesRoundTrip) {
+  RegisterSnapshotResource<Clock>("SnapshotTest.Clock");
+  RegisterSnapshotResource<Weather>(
+      "SnapshotTest.Weather",
+      [](const Weather& weather, SnapshotWriter& writer) {
+        writer.WriteString(weather.name);
+      },
+      [](SnapshotReader& reader, Weather* weather) {
+        return reader.ReadString(&weather->name);
+      });
+  registry.SetResource<Clock>(Clock{120, 0.5f});
+  registry.SetResource<Weather>(Weather{"rain"});
+  registry.SetResource<Unsaved>(Unsaved{7});
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+
+  Registry loaded;
+  loaded.SetResource<Unsaved>(Unsaved{3});
+  ASSERT_TRUE(loaded.LoadSnapshot(path));
+  ASSERT_NE(loaded.GetResource<Clock>(), nullptr);
+  EXPECT_EQ(loaded.GetResource<Clock>()->frame, 120u);
+  EXPECT_EQ(loaded.GetResource<Clock>()->scale, 0.5f);
+  ASSERT_NE(loaded.GetResource<Weather>(), nullptr);
+  EXPECT_EQ(loaded.GetResource<Weather>()->name, "rain");
+  // Unregistered resources are not saved, and survive a load.
+  EXPECT_EQ(loaded.GetResource<Unsaved>()->value, 3);
+}
+
+TEST_F(SnapshotTest, RejectsTruncatedFiles) {
+  std::vector<EntityID> entities = registry.CreateEntities(100);
+  for (EntityID e : entities) {
+    registry.AddComponent<Transform>(e, {});
+  }
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+  Registry loaded;
+  EntityID kept = loaded.CreateEntity();
+  EXPECT_FALSE(loaded.LoadSnapshot(path));
+  EXPECT_TRUE(loaded.IsAlive(kept));
+  EXPECT_EQ(loaded.GetEntityCount(), 1u);
+
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a snapshot";
+  EXPECT_FALSE(loaded.LoadSnapshot(path));
+  EXPECT_FALSE(loaded.LoadSnapshot(path + ".missing"));
+  EXPECT_EQ(loaded.GetEntityCount(), 1u);
+}
+
+TEST_F(SnapshotTest, CorruptColumnsLeaveTheRegistryIntact) {
+  RegisterSnapshotType<Fragile>(
+      "SnapshotTest.Fragile",
+      [](const Fragile& fragile, SnapshotWriter& writer) {
+        writer.WriteString(fragile.name);
+      },
+      [](SnapshotReader& reader, Fragile* fragile) {
+        return reader.ReadString(&fragile->name) && fragile->name != "corrupt";
+      });
+  std::vector<EntityID> entities = registry.CreateEntities(2);
+  for (EntityID e : entities) {
+    registry.AddComponent<Velocity>(e, {{1.0f, 2.0f}});
+  }
+  registry.AddComponent<Fragile>(entities[0], {"corrupt"});
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+
+  Registry loaded;
+  EntityID kept = loaded.CreateEntity();
+  loaded.AddComponent<Transform>(kept, {});
+  // The Velocity column decodes fine, but nothing is applied because a later
+  // column does not.
+  EXPECT_FALSE(loaded.LoadSnapshot(path));
+  EXPECT_EQ(loaded.GetEntityCount(), 1u);
+  EXPECT_TRUE(loaded.HasComponent<Transform>(kept));
+  EXPECT_FALSE(loaded.HasComponent<Velocity>(kept));
+
+  // A column naming an entity twice is rejected rather than appended.
+  registry.RemoveComponent<Fragile>(entities[0]);
+  ASSERT_TRUE(registry.SaveSnapshot(path));
+  std::string bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  const size_t name = bytes.find("Velocity");
+  ASSERT_NE(name, std::string::npos);
+  // Name, raw size and payload size, then the aligned entity count and the
+  // aligned entity array.
+  size_t offset = name + 8 + sizeof(uint32_t) + sizeof(uint64_t);
+  offset = (offset + 15) / 16 * 16 + 16;
+  EntityID first = 0;
+  std::memcpy(&first, bytes.data() + offset, sizeof(EntityID));
+  ASSERT_EQ(first, entities[0]);
+  std::memcpy(bytes.data() + offset + sizeof(EntityID), &first,
+              sizeof(EntityID));
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+  EXPECT_FALSE(loaded.LoadSnapshot(path));
+  EXPECT_EQ(loaded.GetEntityCount(), 1u);
+  EXPECT_TRUE(loaded.HasComponent<Transform>(kept));
+}
+
+}  // namespace engine::ecs
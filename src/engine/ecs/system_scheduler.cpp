@@ -0,0 +1,172 @@
+/**
+ * @file system_scheduler.cpp
+ * @brief SystemScheduler implementation.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+
+#include <engine/core/job_system.h>
+#include <engine/ecs/system_scheduler.h>
+#include <engine/util/logger.h>
+
+namespace engine::ecs {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool Overlaps(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  for (uint32_t id : a) {
+    if (std::find(b.begin(), b.end(), id) != b.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+double MillisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+bool SystemAccess::ConflictsWith(const SystemAccess& other) const {
+  if (exclusive_ || other.exclusive_) {
+    return true;
+  }
+  return Overlaps(writes_, other.writes_) || Overlaps(writes_, other.reads_) ||
+         Overlaps(reads_, other.writes_);
+}
+
+void SystemAccess::RegisterTypes(Registry& registry) const {
+  for (auto registrar : registrars_) {
+    registrar(registry);
+  }
+}
+
+void SystemScheduler::AddSystem(std::string name, SystemAccess access,
+                                SystemFunc func) {
+  for (const System& system : systems_) {
+    if (system.name == name) {
+      LOG_WARN("System '%s' is already registered.", name.c_str());
+      return;
+    }
+  }
+  systems_.push_back({std::move(name), std::move(access), std::move(func)});
+  dirty_ = true;
+}
+
+bool SystemScheduler::RemoveSystem(std::string_view name) {
+  auto it = std::find_if(systems_.begin(), systems_.end(),
+                         [name](const System& system) {
+                           return system.name == name;
+                         });
+  if (it == systems_.end()) {
+    return false;
+  }
+  systems_.erase(it);
+  dirty_ = true;
+  return true;
+}
+
+void SystemScheduler::Clear() {
+  systems_.clear();
+  dirty_ = true;
+}
+
+size_t SystemScheduler::stage_count() {
+  if (dirty_) {
+    Rebuild();
+  }
+  return stages_.size();
+}
+
+void SystemScheduler::Run(Registry& registry, float dt) {
+  if (dirty_) {
+    Rebuild();
+  }
+  // Lazily created storages would otherwise be allocated from worker threads.
+  for (const System& system : systems_) {
+    system.access.RegisterTypes(registry);
+  }
+
+  core::JobSystem& jobs = core::JobSystem::Get();
+  const bool has_workers = jobs.worker_count() > 0;
+  const Clock::time_point frame_start = Clock::now();
+  std::vector<size_t> local;
+  std::vector<std::future<void>> pending;
+  for (const std::vector<size_t>& stage : stages_) {
+    local.clear();
+    pending.clear();
+    for (size_t index : stage) {
+      if (!has_workers || systems_[index].access.main_thread()) {
+        local.push_back(index);
+      }
+    }
+    for (size_t index : stage) {
+      if (!has_workers || systems_[index].access.main_thread()) {
+        continue;
+      }
+      // Keep the calling thread busy instead of idling until the stage ends.
+      if (local.empty()) {
+        local.push_back(index);
+        continue;
+      }
+      pending.push_back(jobs.Execute(
+          [this, index, &registry, dt]() { RunSystem(index, registry, dt); }));
+    }
+    for (size_t index : local) {
+      RunSystem(index, registry, dt);
+    }
+    for (std::future<void>& system : pending) {
+      if (system.valid()) {
+        system.get();
+      }
+    }
+    // Stage boundaries are the sync points for deferred structural changes.
+    registry.FlushCommands();
+  }
+  frame_milliseconds_ = MillisecondsSince(frame_start);
+}
+
+void SystemScheduler::Rebuild() {
+  // A system's stage is one past the deepest earlier system it conflicts with.
+  std::vector<size_t> depth(systems_.size(), 0);
+  size_t stage_total = 0;
+  for (size_t i = 0; i < systems_.size(); ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (systems_[i].access.ConflictsWith(systems_[j].access)) {
+        depth[i] = std::max(depth[i], depth[j] + 1);
+      }
+    }
+    stage_total = std::max(stage_total, depth[i] + 1);
+  }
+
+  stages_.assign(stage_total, {});
+  timings_.resize(systems_.size());
+  for (size_t i = 0; i < systems_.size(); ++i) {
+    stages_[depth[i]].push_back(i);
+    timings_[i] = {systems_[i].name, depth[i], 0.0};
+  }
+  dirty_ = false;
+}
+
+void SystemScheduler::RunSystem(size_t index, Registry& registry, float dt) {
+  const Clock::time_point start = Clock::now();
+  // Commands are played back in system order, whichever thread ran them.
+  ScopedCommandSortKey sort_key(static_cast<uint64_t>(index + 1) << 32);
+  System& system = systems_[index];
+  const uint32_t this_run = registry.AdvanceTick();
+  {
+    ScopedLastRunTick last_run(system.last_run);
+    system.func(registry, dt);
+  }
+  system.last_run = this_run;
+  // Each system owns its slot, so concurrent writes never alias.
+  timings_[index].milliseconds = MillisecondsSince(start);
+}
+
+}  // namespace engine::ecs
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <engine/core/job_system.h>
+#include <engine/ecs/registry.h>
+#include <engine/ecs/system_scheduler.h>
+
+namespace engine::ecs {
+
+struct Position {
+  float x, y;
+};
+
+struct Velocity {
+  float vx, vy;
+};
+
+struct Health {
+  int value;
+};
+
+TEST(SystemAccessTest, Conflicts) {
+  SystemAccess reads_position = SystemAccess().Reads<Position>();
+  SystemAccess writes_position = SystemAccess().Writes<Position>();
+  SystemAccess writes_health = SystemAccess().Writes<Health>();
+
+  EXPECT_FALSE(
+      reads_position.ConflictsWith(SystemAccess().Reads<Position>()));
+  EXPECT_TRUE(reads_position.ConflictsWith(writes_position));
+  EXPECT_TRUE(writes_position.ConflictsWith(reads_position));
+  EXPECT_TRUE(writes_position.ConflictsWith(writes_position));
+  EXPECT_FALSE(writes_position.ConflictsWith(writes_health));
+  EXPECT_TRUE(writes_health.ConflictsWith(SystemAccess().Exclusive()));
+}
+
+TEST(SystemSchedulerTest, StagesFollowConflicts) {
+  SystemScheduler scheduler;
+  auto noop = [](Registry&, float) {};
+  scheduler.AddSystem("Move",
+                      SystemAccess().Reads<Velocity>().Writes<Position>(),
+                      noop);
+  scheduler.AddSystem("Heal", SystemAccess().Writes<Health>(), noop);
+  scheduler.AddSystem("Follow", SystemAccess().Reads<Position>(), noop);
+  scheduler.AddSystem("Cleanup", SystemAccess().Exclusive(), noop);
+
+  EXPECT_EQ(scheduler.stage_count(), 3u);
+
+  Registry registry;
+  scheduler.Run(registry, 0.0f);
+  const auto& timings = scheduler.timings();
+  ASSERT_EQ(timings.size(), 4u);
+  EXPECT_EQ(timings[0].name, "Move");
+  EXPECT_EQ(timings[0].stage, 0u);
+  EXPECT_EQ(timings[1].stage, 0u);
+  EXPECT_EQ(timings[2].stage, 1u);
+  EXPECT_EQ(timings[3].stage, 2u);
+
+  EXPECT_TRUE(scheduler.RemoveSystem("Cleanup"));
+  EXPECT_FALSE(scheduler.RemoveSystem("Cleanup"));
+  EXPECT_EQ(scheduler.stage_count(), 2u);
+}
+
+TEST(SystemSchedulerTest, ConflictingSystemsRunInRegistrationOrder) {
+  core::JobSystem::Get().Init();
+  Registry registry;
+  EntityID e = registry.CreateEntity();
+  registry.AddComponent<Position>(e, {0.0f, 0.0f});
+  registry.AddComponent<Velocity>(e, {1.0f, 0.0f});
+
+  SystemScheduler scheduler;
+  scheduler.AddSystem(
+      "Move", SystemAccess().Reads<Velocity>().Writes<Position>(),
+      [](Registry& reg, float dt) {
+        reg.ForEach<Position, Velocity>(
+            [dt](Position& p, Velocity& v) { p.x += v.vx * dt; });
+      });
+  scheduler.AddSystem("Double", SystemAccess().Writes<Position>(),
+                      [](Registry& reg, float) {
+                        reg.ForEach<Position>([](Position& p) { p.x *= 2.0f; });
+                      });
+
+  for (int i = 0; i < 10; ++i) {
+    scheduler.Run(registry, 1.0f);
+  }
+  core::JobSystem::Get().Shutdown();
+
+  // (x + 1) * 2 applied ten times in order.
+  float expected = 0.0f;
+  for (int i = 0; i < 10; ++i) {
+    expected = (expected + 1.0f) * 2.0f;
+  }
+  EXPECT_EQ(registry.GetComponent<Position>(e).x, expected);
+}
+
+TEST(SystemSchedulerTest, IndependentSystemsRunConcurrently) {
+  core::JobSystem::Get().Init();
+  if (core::JobSystem::Get().worker_count() == 0) {
+    GTEST_SKIP();
+  }
+  Registry registry;
+  std::atomic<int> running{0};
+  std::atomic<int> peak{0};
+  auto track = [&running, &peak](Registry&, float) {
+    int now = ++running;
+    int seen = peak.load();
+    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    --running;
+  };
+
+  SystemScheduler scheduler;
+  scheduler.AddSystem("A", SystemAccess().Writes<Position>(), track);
+  scheduler.AddSystem("B", SystemAccess().Writes<Velocity>(), track);
+  scheduler.Run(registry, 0.0f);
+  core::JobSystem::Get().Shutdown();
+
+  EXPECT_EQ(scheduler.stage_count(), 1u);
+  EXPECT_EQ(peak.load(), 2);
+  EXPECT_GT(scheduler.frame_milliseconds(), 0.0);
+}
+
+TEST(SystemSchedulerTest, ChangedFiltersSeeChangesSinceLastRun) {
+  Registry registry;
+  EntityID a = registry.CreateEntity();
+  EntityID b = registry.CreateEntity();
+  registry.AddComponent<Position>(a, {0.0f, 0.0f});
+  registry.AddComponent<Position>(b, {0.0f, 0.0f});
+
+  std::vector<EntityID> seen;
+  SystemScheduler scheduler;
+  scheduler.AddSystem("Watch", SystemAccess().Reads<Position>(),
+                      [&seen](Registry& reg, float) {
+                        seen.clear();
+                        for (EntityID entity :
+                             reg.GetView<Position>(Changed<Position>{})) {
+                          seen.push_back(entity);
+                        }
+                      });
+
+  scheduler.Run(registry, 0.0f);
+  EXPECT_EQ(seen.size(), 2u);
+  scheduler.Run(registry, 0.0f);
+  EXPECT_TRUE(seen.empty());
+
+  registry.PatchComponent<Position>(b, [](Position& p) { p.x = 1.0f; });
+  scheduler.Run(registry, 0.0f);
+  EXPECT_EQ(seen, std::vector<EntityID>{b});
+}
+
+}  // namespace engine::ecs
@@ -7,7 +7,6 @@
 #include <engine/ecs/components/waypoint_path.h>
 #include <engine/ecs/components/transform.h>
 #include <glm/glm.hpp>
-#include <vector>
 
 namespace engine::ecs::systems {
 
@@ -28,87 +27,79 @@ void AISystem::Update(Registry* registry, float dt) {
         comp.tree.Tick(dt);
       });
 
-  // 3. Update Animations
-  auto anim_view = registry->GetView<engine::ecs::components::Animation, engine::ecs::components::Sprite>();
-  for (auto entity : anim_view) {
-    auto& anim = registry->GetComponent<engine::ecs::components::Animation>(entity);
-    auto& sprite = registry->GetComponent<engine::ecs::components::Sprite>(entity);
-
-    if (!anim.is_playing || anim.current_clip.empty()) {
-      continue;
-    }
-
-    const auto* clip = anim.GetClip(anim.current_clip);
-    if (!clip || clip->frames.empty()) {
-      continue;
-    }
-
-    anim.timer += dt;
-    if (anim.timer >= clip->frames[anim.current_frame].duration) {
-      anim.timer = 0.0f;
-      anim.current_frame++;
-
-      if (anim.current_frame >= static_cast<int>(clip->frames.size())) {
-        if (clip->loop) {
-          anim.current_frame = 0;
-        } else {
-          anim.current_frame = static_cast<int>(clip->frames.size()) - 1;
-          anim.is_playing = false;
+  // 3. Update Animations (independent per entity, so run on the workers)
+  registry->ParallelForEach<engine::ecs::components::Animation, engine::ecs::components::Sprite>(
+      [dt](engine::ecs::components::Animation& anim,
+           engine::ecs::components::Sprite& sprite) {
+        if (!anim.is_playing || anim.current_clip.empty()) {
+          return;
         }
-      }
-      sprite.sprite_index = clip->frames[anim.current_frame].sprite_index;
-    }
-  }
-
-  // 4. Update Lifetime
-  std::vector<EntityID> to_destroy;
-  auto life_view = registry->GetView<engine::ecs::components::Lifetime>();
-  for (auto entity : life_view) {
-    auto& life = registry->GetComponent<engine::ecs::components::Lifetime>(entity);
-    life.remaining -= dt;
-    if (life.remaining <= 0.0f) {
-      to_destroy.push_back(entity);
-    }
-  }
-
-  for (auto entity : to_destroy) {
-    registry->DeleteEntity(entity);
-  }
 
-  // 5. Update Waypoint Pathing
-  auto path_view = registry->GetView<engine::ecs::components::WaypointPath, engine::ecs::components::Transform>();
-  for (auto entity : path_view) {
-    auto& path = registry->GetComponent<engine::ecs::components::WaypointPath>(entity);
-    auto& transform = registry->GetComponent<engine::ecs::components::Transform>(entity);
+        const auto* clip = anim.GetClip(anim.current_clip);
+        if (!clip || clip->frames.empty()) {
+          return;
+        }
 
-    if (path.finished || path.points.empty()) {
-      continue;
-    }
+        anim.timer += dt;
+        if (anim.timer >= clip->frames[anim.current_frame].duration) {
+          anim.timer = 0.0f;
+          anim.current_frame++;
+
+          if (anim.current_frame >= static_cast<int>(clip->frames.size())) {
+            if (clip->loop) {
+              anim.current_frame = 0;
+            } else {
+              anim.current_frame = static_cast<int>(clip->frames.size()) - 1;
+              anim.is_playing = false;
+            }
+          }
+          sprite.sprite_index = clip->frames[anim.current_frame].sprite_index;
+        }
+      });
 
-    glm::vec2 target = path.points[path.current_index];
-    glm::vec2 direction = target - transform.position;
-    float distance = glm::length(direction);
+  // 4. Update Lifetime (expired entities are deleted through the command
+  // buffers, then played back before pathing sees them)
+  registry->ParallelForEach<engine::ecs::components::Lifetime>(
+      [registry, dt](EntityID entity, engine::ecs::components::Lifetime& life) {
+        life.remaining -= dt;
+        if (life.remaining <= 0.0f) {
+          registry->commands().DeleteEntity(entity);
+        }
+      });
+  registry->FlushCommands();
+
+  // 5. Update Waypoint Pathing (independent per entity, so run on the workers)
+  registry->ParallelForEach<engine::ecs::components::WaypointPath, engine::ecs::components::Transform>(
+      [dt](engine::ecs::components::WaypointPath& path,
+           engine::ecs::components::Transform& transform) {
+        if (path.finished || path.points.empty()) {
+          return;
+        }
 
-    if (distance <= path.arrival_threshold) {
-      path.current_index++;
-      if (path.current_index >= static_cast<int>(path.points.size())) {
-        if (path.loop) {
-          path.current_index = 0;
-        } else {
-          path.finished = true;
-          continue;
+        glm::vec2 target = path.points[path.current_index];
+        glm::vec2 direction = target - transform.position;
+        float distance = glm::length(direction);
+
+        if (distance <= path.arrival_threshold) {
+          path.current_index++;
+          if (path.current_index >= static_cast<int>(path.points.size())) {
+            if (path.loop) {
+              path.current_index = 0;
+            } else {
+              path.finished = true;
+              return;
+            }
+          }
+          // Re-calculate target for the next waypoint to avoid stuttering this frame
+          target = path.points[path.current_index];
+          direction = target - transform.position;
+          distance = glm::length(direction);
         }
-      }
-      // Re-calculate target for the next waypoint to avoid stuttering this frame
-      target = path.points[path.current_index];
-      direction = target - transform.position;
-      distance = glm::length(direction);
-    }
 
-    if (distance > 0.0f) {
-      transform.position += (direction / distance) * path.speed * dt;
-    }
-  }
+        if (distance > 0.0f) {
+          transform.position += (direction / distance) * path.speed * dt;
+        }
+      });
 }
 
 }  // namespace engine::ecs::systems
@@ -1,6 +1,7 @@
 #include <engine/core/application.h>
 #include <engine/ecs/components/camera_component.h>
 #include <engine/ecs/components/transform.h>
+#include <engine/ecs/components/world_transform.h>
 #include <engine/ecs/systems/camera_system.h>
 #include <engine/graphics/camera.h>
 
@@ -11,28 +12,36 @@ void CameraSystem::Update(Registry* registry) {
     return;
   }
 
-  auto view = registry->GetView<engine::ecs::components::CameraComponent,
-                                engine::ecs::components::Transform>();
-  for (auto entity : view) {
-    auto& camera_comp =
-        registry->GetComponent<engine::ecs::components::CameraComponent>(
-            entity);
-    if (camera_comp.is_active) {
-      auto& transform =
-          registry->GetComponent<engine::ecs::components::Transform>(entity);
+  bool found = false;
+  registry
+      ->GetQuery<engine::ecs::components::CameraComponent,
+                 engine::ecs::components::Transform>()
+      .Each([registry, &found](
+                EntityID entity,
+                engine::ecs::components::CameraComponent& camera_comp,
+                engine::ecs::components::Transform& local) {
+        // Only use the first active camera
+        if (found || !camera_comp.is_active) {
+          return;
+        }
+        found = true;
+        // Cameras attached to a rig follow its world transform.
+        const engine::ecs::components::Transform& transform =
+            registry->HasComponent<engine::ecs::components::WorldTransform>(
+                entity)
+                ? registry->GetComponent<
+                      engine::ecs::components::WorldTransform>(entity)
+                : local;
 
-      auto& main_camera = Application::Get().camera();
-      main_camera.set_position({transform.position.x + camera_comp.offset_x,
-                                transform.position.y + camera_comp.offset_y,
-                                0.0f});
+        auto& main_camera = Application::Get().camera();
+        main_camera.set_position(
+            {transform.position.x + camera_comp.offset_x,
+             transform.position.y + camera_comp.offset_y, 0.0f});
 
-      // Note: Camera class doesn't currently support zoom in its public API
-      // in a simple way without recalculating projection.
-      // For now we just sync position.
-
-      break;  // Only use the first active camera
-    }
-  }
+        // Note: Camera class doesn't currently support zoom in its public API
+        // in a simple way without recalculating projection.
+        // For now we just sync position.
+      });
 }
 
 }  // namespace engine::ecs::systems
@@ -0,0 +1,197 @@
+/**
+ * @file hierarchy_system.cpp
+ * @brief Implementation of the transform hierarchy system.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include <engine/ecs/components/parent.h>
+#include <engine/ecs/components/world_transform.h>
+#include <engine/ecs/systems/hierarchy_system.h>
+#include <engine/util/logger.h>
+
+namespace engine::ecs::systems {
+
+namespace {
+
+using components::Parent;
+using components::Transform;
+using components::WorldTransform;
+
+/** @brief Applies a local transform on top of its parent's world transform. */
+Transform Combine(const Transform& parent, const Transform& local) {
+  const float radians = glm::radians(parent.rotation);
+  const float c = std::cos(radians);
+  const float s = std::sin(radians);
+  const glm::vec2 offset = parent.scale * local.position;
+  Transform world;
+  world.position =
+      parent.position + glm::vec2(offset.x * c - offset.y * s,
+                                  offset.x * s + offset.y * c);
+  world.scale = parent.scale * local.scale;
+  world.rotation = parent.rotation + local.rotation;
+  return world;
+}
+
+bool SameTransform(const Transform& a, const Transform& b) {
+  return a.position == b.position && a.scale == b.scale &&
+         a.rotation == b.rotation;
+}
+
+}  // namespace
+
+void HierarchySystem::Update(Registry* registry) {
+  if (!registry) {
+    return;
+  }
+  const uint32_t since = last_sync_;
+  last_sync_ = registry->AdvanceTick();
+  ComponentStorage<Parent>* parents = registry->GetStorage<Parent>();
+  if (needs_rebuild_ || registry->id() != registry_id_ ||
+      parents->size() != parent_count_) {
+    Rebuild(registry);
+  } else {
+    auto changed = registry->GetView<Parent>(Changed<Parent>{since});
+    if (changed.begin() != changed.end()) {
+      Rebuild(registry);
+    }
+  }
+
+  ComponentStorage<Transform>* transforms = registry->GetStorage<Transform>();
+  ComponentStorage<WorldTransform>* worlds =
+      registry->GetStorage<WorldTransform>();
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    Node& node = nodes_[i];
+    const EntityID entity = order_[i];
+    node.moved = false;
+    if (!transforms->Has(entity)) {
+      // Lost its Transform without losing its Parent; drop it next frame.
+      needs_rebuild_ = true;
+      continue;
+    }
+    const Transform& local = transforms->Get(entity);
+    const bool parent_moved = node.parent != kRoot && nodes_[node.parent].moved;
+    if (!node.stale && !parent_moved && SameTransform(local, node.local)) {
+      continue;
+    }
+    node.local = local;
+    node.world = node.parent == kRoot
+                     ? local
+                     : Combine(nodes_[node.parent].world, local);
+    node.moved = true;
+    node.stale = false;
+    if (worlds->Has(entity)) {
+      static_cast<Transform&>(worlds->Get(entity)) = node.world;
+      registry->MarkChanged<WorldTransform>(entity);
+    } else {
+      registry->commands().AddComponent<WorldTransform>(entity, {node.world});
+    }
+  }
+}
+
+std::span<const EntityID> HierarchySystem::Subtree(EntityID entity) const {
+  const uint32_t index = GetEntityIndex(entity);
+  if (index >= positions_.size() || positions_[index] == kRoot ||
+      order_[positions_[index]] != entity) {
+    return {};
+  }
+  const uint32_t position = positions_[index];
+  return {order_.data() + position, nodes_[position].subtree_size};
+}
+
+void HierarchySystem::Rebuild(Registry* registry) {
+  // Handles from another registry mean nothing here.
+  std::vector<EntityID> previous;
+  if (registry->id() == registry_id_) {
+    previous = std::move(order_);
+    std::sort(previous.begin(), previous.end());
+  }
+  nodes_.clear();
+  order_.clear();
+
+  // (parent, child) links sorted by parent, so a node's children are one
+  // contiguous range.
+  std::vector<std::pair<EntityID, EntityID>> links;
+  registry->GetView<Parent, Transform>().Each(
+      [registry, &links](EntityID entity, Parent& parent, Transform&) {
+        if (parent.entity != entity &&
+            registry->HasComponent<Transform>(parent.entity)) {
+          links.emplace_back(parent.entity, entity);
+        }
+      });
+  std::sort(links.begin(), links.end());
+  std::vector<EntityID> children;
+  children.reserve(links.size());
+  for (const auto& link : links) {
+    children.push_back(link.second);
+  }
+  std::sort(children.begin(), children.end());
+
+  // Depth-first walk from every parent that is not itself a child.
+  std::vector<std::pair<EntityID, uint32_t>> stack;
+  for (size_t i = 0; i < links.size(); ++i) {
+    const EntityID root = links[i].first;
+    if ((i > 0 && links[i - 1].first == root) ||
+        std::binary_search(children.begin(), children.end(), root)) {
+      continue;
+    }
+    stack.emplace_back(root, kRoot);
+    while (!stack.empty()) {
+      const auto [entity, parent] = stack.back();
+      stack.pop_back();
+      const uint32_t position = static_cast<uint32_t>(order_.size());
+      order_.push_back(entity);
+      nodes_.push_back({parent, 1, {}, {}, false, true});
+      auto range = std::equal_range(
+          links.begin(), links.end(), std::make_pair(entity, EntityID{0}),
+          [](const auto& a, const auto& b) { return a.first < b.first; });
+      for (auto it = range.second; it != range.first;) {
+        --it;
+        stack.emplace_back(it->second, position);
+      }
+    }
+  }
+  // Children that no root leads to are on a cycle.
+  size_t reached_children = 0;
+  for (const Node& node : nodes_) {
+    reached_children += node.parent != kRoot;
+  }
+  if (reached_children < children.size()) {
+    LOG_WARN("%zu entities have a Parent cycle and are not propagated.",
+             children.size() - reached_children);
+  }
+
+  for (size_t i = nodes_.size(); i-- > 0;) {
+    if (nodes_[i].parent != kRoot) {
+      nodes_[nodes_[i].parent].subtree_size += nodes_[i].subtree_size;
+    }
+  }
+  positions_.clear();
+  for (uint32_t i = 0; i < order_.size(); ++i) {
+    const uint32_t index = GetEntityIndex(order_[i]);
+    if (index >= positions_.size()) {
+      positions_.resize(index + 1, kRoot);
+    }
+    positions_[index] = i;
+  }
+
+  // Entities that left every hierarchy go back to using their Transform.
+  std::vector<EntityID> current = order_;
+  std::sort(current.begin(), current.end());
+  for (EntityID entity : previous) {
+    if (!std::binary_search(current.begin(), current.end(), entity) &&
+        registry->HasComponent<WorldTransform>(entity)) {
+      registry->commands().RemoveComponent<WorldTransform>(entity);
+    }
+  }
+
+  registry_id_ = registry->id();
+  parent_count_ = registry->GetStorage<Parent>()->size();
+  needs_rebuild_ = false;
+}
+
+}  // namespace engine::ecs::systems
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <engine/ecs/components/parent.h>
+#include <engine/ecs/components/transform.h>
+#include <engine/ecs/components/world_transform.h>
+#include <engine/ecs/registry.h>
+#include <engine/ecs/systems/hierarchy_system.h>
+
+using namespace engine::ecs;
+using namespace engine::ecs::components;
+using namespace engine::ecs::systems;
+
+namespace {
+
+// Runs the system and applies the WorldTransform additions it recorded.
+void Step(HierarchySystem& hierarchy, Registry& registry) {
+  hierarchy.Update(&registry);
+  registry.FlushCommands();
+}
+
+}  // namespace
+
+TEST(HierarchySystemTest, PropagatesThroughChains) {
+  Registry registry;
+  HierarchySystem hierarchy;
+  EntityID root = registry.CreateEntity();
+  EntityID arm = registry.CreateEntity();
+  EntityID hand = registry.CreateEntity();
+  EntityID loner = registry.CreateEntity();
+  registry.AddComponent<Transform>(root, {{100.0f, 0.0f}, {2.0f, 2.0f}, 90.0f});
+  registry.AddComponent<Transform>(arm, {{10.0f, 0.0f}});
+  registry.AddComponent<Transform>(hand, {{5.0f, 0.0f}});
+  registry.AddComponent<Transform>(loner, {});
+  registry.AddComponent<Parent>(arm, {root});
+  registry.AddComponent<Parent>(hand, {arm});
+
+  Step(hierarchy, registry);
+  ASSERT_EQ(hierarchy.size(), 3u);
+  EXPECT_FALSE(registry.HasComponent<WorldTransform>(loner));
+  ASSERT_TRUE(registry.HasComponent<WorldTransform>(hand));
+  const WorldTransform& world = registry.GetComponent<WorldTransform>(hand);
+  EXPECT_NEAR(world.position.x, 100.0f, 1e-4f);
+  EXPECT_NEAR(world.position.y, 30.0f, 1e-4f);
+  EXPECT_EQ(world.scale.x, 2.0f);
+  EXPECT_EQ(world.rotation, 90.0f);
+
+  std::vector<EntityID> subtree(hierarchy.Subtree(root).begin(),
+                                hierarchy.Subtree(root).end());
+  EXPECT_EQ(subtree, (std::vector<EntityID>{root, arm, hand}));
+  EXPECT_TRUE(hierarchy.Subtree(loner).empty());
+}
+
+TEST(HierarchySystemTest, OnlyMovedSubtreesAreWritten) {
+  Registry registry;
+  HierarchySystem hierarchy;
+  EntityID a = registry.CreateEntity();
+  EntityID a_child = registry.CreateEntity();
+  EntityID b = registry.CreateEntity();
+  EntityID b_child = registry.CreateEntity();
+  for (EntityID e : {a, a_child, b, b_child}) {
+    registry.AddComponent<Transform>(e, {{1.0f, 1.0f}});
+  }
+  registry.AddComponent<Parent>(a_child, {a});
+  registry.AddComponent<Parent>(b_child, {b});
+  Step(hierarchy, registry);
+
+  registry.GetComponent<Transform>(a).position.x = 50.0f;
+  const uint32_t since = registry.AdvanceTick();
+  Step(hierarchy, registry);
+  std::vector<EntityID> written;
+  registry.GetView<WorldTransform>(Changed<WorldTransform>{since})
+      .Each([&written](EntityID e, WorldTransform&) { written.push_back(e); });
+  std::sort(written.begin(), written.end());
+  EXPECT_EQ(written, (std::vector<EntityID>{a, a_child}));
+  EXPECT_EQ(registry.GetComponent<WorldTransform>(a_child).position.x, 51.0f);
+}
+
+TEST(HierarchySystemTest, ReparentingAndDetaching) {
+  Registry registry;
+  HierarchySystem hierarchy;
+  EntityID a = registry.CreateEntity();
+  EntityID b = registry.CreateEntity();
+  EntityID child = registry.CreateEntity();
+  registry.AddComponent<Transform>(a, {{10.0f, 0.0f}});
+  registry.AddComponent<Transform>(b, {{20.0f, 0.0f}});
+  registry.AddComponent<Transform>(child, {{1.0f, 0.0f}});
+  registry.AddComponent<Parent>(child, {a});
+  Step(hierarchy, registry);
+  EXPECT_EQ(registry.GetComponent<WorldTransform>(child).position.x, 11.0f);
+
+  registry.AddComponent<Parent>(child, {b});
+  Step(hierarchy, registry);
+  EXPECT_EQ(registry.GetComponent<WorldTransform>(child).position.x, 21.0f);
+  EXPECT_FALSE(registry.HasComponent<WorldTransform>(a));
+
+  registry.RemoveComponent<Parent>(child);
+  Step(hierarchy, registry);
+  EXPECT_EQ(hierarchy.size(), 0u);
+  EXPECT_FALSE(registry.HasComponent<WorldTransform>(child));
+}
+
+TEST(HierarchySystemTest, CyclesAreSkipped) {
+  Registry registry;
+  HierarchySystem hierarchy;
+  EntityID a = registry.CreateEntity();
+  EntityID b = registry.CreateEntity();
+  registry.AddComponent<Transform>(a, {});
+  registry.AddComponent<Transform>(b, {});
+  registry.AddComponent<Parent>(a, {b});
+  registry.AddComponent<Parent>(b, {a});
+  Step(hierarchy, registry);
+  EXPECT_EQ(hierarchy.size(), 0u);
+}
+
+TEST(HierarchySystemTest, RebuildsForARegistryAtAReusedAddress) {
+  HierarchySystem hierarchy;
+  std::optional<Registry> registry;
+  registry.emplace();
+  EntityID a = registry->CreateEntity();
+  EntityID b = registry->CreateEntity();
+  registry->AddComponent<Transform>(a, {{1.0f, 0.0f}});
+  registry->AddComponent<Transform>(b, {{2.0f, 0.0f}});
+  registry->AddComponent<Parent>(b, {a});
+  Step(hierarchy, *registry);
+  ASSERT_EQ(hierarchy.Subtree(a).size(), 2u);
+
+  // A new scene's registry in the same storage, with as many Parent
+  // components but a different hierarchy.
+  registry.reset();
+  registry.emplace();
+  a = registry->CreateEntity();
+  b = registry->CreateEntity();
+  registry->AddComponent<Transform>(a, {{1.0f, 0.0f}});
+  registry->AddComponent<Transform>(b, {{2.0f, 0.0f}});
+  registry->AddComponent<Parent>(a, {b});
+  Step(hierarchy, *registry);
+  EXPECT_EQ(hierarchy.Subtree(a).size(), 1u);
+  ASSERT_EQ(hierarchy.Subtree(b).size(), 2u);
+  ASSERT_TRUE(registry->HasComponent<WorldTransform>(a));
+  EXPECT_NEAR(registry->GetComponent<WorldTransform>(a).position.x, 3.0f,
+              1e-4f);
+}
@@ -20,32 +20,37 @@ void PhysicsSystem::Update(Registry* registry, float dt) {
     return;
   }
   // 1. Apply Gravity
-  auto gravity_view = registry->GetView<engine::ecs::components::Transform,
-                                        engine::ecs::components::Velocity,
-                                        engine::ecs::components::Gravity>();
-  for (auto entity : gravity_view) {
-    auto& velocity =
-        registry->GetComponent<engine::ecs::components::Velocity>(entity);
-    auto& gravity =
-        registry->GetComponent<engine::ecs::components::Gravity>(entity);
-    velocity.velocity.y -= gravity.strength * dt;
-  }
+  registry
+      ->GetQuery<engine::ecs::components::Velocity,
+                 engine::ecs::components::Gravity>(
+          With<engine::ecs::components::Transform>{})
+      .Each([dt](EntityID, engine::ecs::components::Velocity& velocity,
+                 engine::ecs::components::Gravity& gravity) {
+        velocity.velocity.y -= gravity.strength * dt;
+      });
 
   // 2. Perform Movement and Collision Resolution (Separated passes)
-  auto collider_view = registry->GetView<engine::ecs::components::Transform,
-                                         engine::ecs::components::Collider>();
-  std::vector<EntityID> colliders(collider_view.begin(), collider_view.end());
+  // Owning groups keep the moving bodies and the colliders packed, so the
+  // passes below walk parallel arrays instead of probing storages.
+  auto collider_group = registry->GetGroup<engine::ecs::components::Collider>(
+      With<engine::ecs::components::Transform>{});
+  std::vector<EntityID> colliders;
+  colliders.reserve(collider_group.size());
+  collider_group.Each(
+      [&colliders](EntityID entity, engine::ecs::components::Collider&,
+                   engine::ecs::components::Transform&) {
+        colliders.push_back(entity);
+      });
 
   // 2a. Update Positions (Horizontal)
-  auto velocity_view = registry->GetView<engine::ecs::components::Transform,
-                                         engine::ecs::components::Velocity>();
-  for (auto entity : velocity_view) {
-    auto& transform =
-        registry->GetComponent<engine::ecs::components::Transform>(entity);
-    auto& velocity =
-        registry->GetComponent<engine::ecs::components::Velocity>(entity);
+  auto velocity_group =
+      registry->GetGroup<engine::ecs::components::Transform,
+                         engine::ecs::components::Velocity>();
+  velocity_group.Each([dt](EntityID,
+                           engine::ecs::components::Transform& transform,
+                           engine::ecs::components::Velocity& velocity) {
     transform.position.x += velocity.velocity.x * dt;
-  }
+  });
 
   // 2b. Resolve Horizontal Collisions
   for (size_t i = 0; i < colliders.size(); ++i) {
@@ -92,13 +97,11 @@ void PhysicsSystem::Update(Registry* registry, float dt) {
   }
 
   // 2c. Update Positions (Vertical)
-  for (auto entity : velocity_view) {
-    auto& transform =
-        registry->GetComponent<engine::ecs::components::Transform>(entity);
-    auto& velocity =
-        registry->GetComponent<engine::ecs::components::Velocity>(entity);
+  velocity_group.Each([dt](EntityID,
+                           engine::ecs::components::Transform& transform,
+                           engine::ecs::components::Velocity& velocity) {
     transform.position.y += velocity.velocity.y * dt;
-  }
+  });
 
   // 2d. Resolve Vertical Collisions
   for (size_t i = 0; i < colliders.size(); ++i) {
@@ -26,18 +26,22 @@ void UpdateLightingSystem(engine::ecs::Registry* registry,
     return;
   }
 
-  lighting_effect->ClearLights();
-  lighting_effect->ClearOccluders();
+  using engine::ecs::Changed;
+  using engine::ecs::EntityID;
+  using engine::ecs::components::Light;
+  using engine::ecs::components::Occluder;
+  using engine::ecs::components::Transform;
 
-  // Sync Lights
-  auto light_view = registry->GetView<engine::ecs::components::Transform,
-                                      engine::ecs::components::Light>();
-  for (auto entity : light_view) {
-    const auto& transform =
-        registry->GetComponent<engine::ecs::components::Transform>(entity);
-    const auto& light_comp =
-        registry->GetComponent<engine::ecs::components::Light>(entity);
+  // Lights are re-read every sync, since most movers write Transform through
+  // a plain reference. The query keeps lights and entities index-aligned:
+  // only entries that now belong to another entity (after adds and removals)
+  // or whose Light was stamped as changed since the last sync are converted
+  // again; the rest just follow their transform.
+  const uint32_t since = lighting_effect->sync_tick();
+  lighting_effect->set_sync_tick(registry->AdvanceTick());
 
+  // Sync Lights
+  auto to_light = [](const Transform& transform, const Light& light_comp) {
     engine::graphics::Light light;
     light.position = transform.position;
     light.color = light_comp.color;
@@ -47,26 +51,32 @@ void UpdateLightingSystem(engine::ecs::Registry* registry,
     light.direction = light_comp.direction;
     light.is_directional = light_comp.is_directional;
     light.dir_vector = light_comp.dir_vector;
-
-    lighting_effect->AddLight(light);
-  }
+    return light;
+  };
+  auto lights = registry->GetQuery<Transform, Light>();
+  auto changed_lights = registry->GetView<Light>(Changed<Light>{since});
+  lighting_effect->ResizeLights(lights.size());
+  size_t index = 0;
+  lights.Each([&](EntityID entity, Transform& transform, Light& light) {
+    if (lighting_effect->light_key(index) != entity ||
+        changed_lights.Contains(entity)) {
+      lighting_effect->SetLight(index, to_light(transform, light), entity);
+    } else {
+      lighting_effect->SetLightPosition(index, transform.position);
+    }
+    ++index;
+  });
 
   // Sync Occluders
-  auto occluder_view = registry->GetView<engine::ecs::components::Transform,
-                                         engine::ecs::components::Occluder>();
-  for (auto entity : occluder_view) {
-    const auto& transform =
-        registry->GetComponent<engine::ecs::components::Transform>(entity);
-    const auto& occluder_comp =
-        registry->GetComponent<engine::ecs::components::Occluder>(entity);
-
-    engine::graphics::Occluder occluder;
-    occluder.position = transform.position;
-    occluder.size = occluder_comp.size * transform.scale;
-    occluder.rotation = transform.rotation;
-
-    lighting_effect->AddOccluder(occluder);
-  }
+  lighting_effect->ClearOccluders();
+  registry->GetQuery<Transform, Occluder>().Each(
+      [&](EntityID, Transform& transform, Occluder& occluder_comp) {
+        engine::graphics::Occluder occluder;
+        occluder.position = transform.position;
+        occluder.size = occluder_comp.size * transform.scale;
+        occluder.rotation = transform.rotation;
+        lighting_effect->AddOccluder(occluder);
+      });
 }
 
 }  // namespace engine::graphics::ecs
@@ -12,6 +12,7 @@
 #include <engine/ecs/components/text.h>
 #include <engine/ecs/components/transform.h>
 #include <engine/ecs/components/triangle.h>
+#include <engine/ecs/components/world_transform.h>
 #include <engine/graphics/ecs/sprite_render_system.h>
 #include <engine/graphics/renderer.h>
 #include <engine/graphics/sprite_sheet.h>
@@ -21,57 +22,90 @@
 
 namespace engine::graphics::ecs {
 
+namespace {
+
+/** @brief Queues the draw command of one sprite. */
+void SubmitSprite(const engine::ecs::components::Transform& transform,
+                  const engine::ecs::components::Sprite& sprite) {
+  if (!sprite.visible) {
+    return;
+  }
+  if (!sprite.sprite_sheet_name.empty()) {
+    auto sheet = util::AssetManager<SpriteSheet>::Get(sprite.sprite_sheet_name);
+    if (sheet && sheet->texture()) {
+      glm::vec2 uv_min, uv_max;
+      sheet->GetUVs(sprite.sprite_index, &uv_min, &uv_max);
+
+      utils::RenderCommand cmd;
+      cmd.z_order = sprite.z_index;
+      cmd.texture_id = sheet->texture()->renderer_id();
+      cmd.position = transform.position;
+      cmd.size = transform.scale;
+      cmd.rotation = transform.rotation;
+      cmd.color = sprite.tint;
+      cmd.uv_min = uv_min;
+      cmd.uv_max = uv_max;
+      cmd.origin = sprite.origin;
+      utils::RenderQueue::Default().Submit(cmd);
+    }
+  } else if (!sprite.texture_name.empty()) {
+    auto tex = util::AssetManager<Texture>::Get(sprite.texture_name);
+    if (tex) {
+      utils::RenderCommand cmd;
+      cmd.z_order = sprite.z_index;
+      cmd.texture_id = tex->renderer_id();
+      cmd.position = transform.position;
+      cmd.size = transform.scale;
+      cmd.rotation = transform.rotation;
+      cmd.color = sprite.tint;
+      cmd.uv_min = {0.0f, 0.0f};
+      cmd.uv_max = {1.0f, 1.0f};
+      cmd.origin = sprite.origin;
+      utils::RenderQueue::Default().Submit(cmd);
+    }
+  }
+}
+
+/**
+ * @brief Returns the world transform of an entity: its cached WorldTransform
+ * if it is part of a hierarchy, otherwise its Transform.
+ */
+const engine::ecs::components::Transform& WorldOf(
+    engine::ecs::ComponentStorage<engine::ecs::components::WorldTransform>*
+        worlds,
+    engine::ecs::EntityID entity,
+    const engine::ecs::components::Transform& transform) {
+  return worlds->Has(entity) ? worlds->Get(entity) : transform;
+}
+
+}  // namespace
+
 void SpriteRenderSystem::Render(engine::ecs::Registry* registry) {
   if (!registry) {
     return;
   }
-  // 1. Render entities with Transform and Sprite/Quad
+  // 1. Render sprites. The group keeps sprites packed, so this is a linear
+  // walk with a single Transform lookup per sprite.
+  auto sprite_group = registry->GetGroup<engine::ecs::components::Sprite>(
+      engine::ecs::With<engine::ecs::components::Transform>{});
+  auto* worlds =
+      registry->GetStorage<engine::ecs::components::WorldTransform>();
+  sprite_group.Each([worlds](engine::ecs::EntityID entity,
+                             engine::ecs::components::Sprite& sprite,
+                             engine::ecs::components::Transform& transform) {
+    SubmitSprite(WorldOf(worlds, entity, transform), sprite);
+  });
+
+  // 2. Render the remaining entities with Transform and a shape
   auto trans_view = registry->GetView<engine::ecs::components::Transform>();
   for (auto entity : trans_view) {
-    auto& transform =
-        registry->GetComponent<engine::ecs::components::Transform>(entity);
+    const engine::ecs::components::Transform& transform = WorldOf(
+        worlds, entity,
+        registry->GetComponent<engine::ecs::components::Transform>(entity));
 
     // Sprite Component (takes priority)
-    if (registry->HasComponent<engine::ecs::components::Sprite>(entity)) {
-      auto& sprite =
-          registry->GetComponent<engine::ecs::components::Sprite>(entity);
-      if (sprite.visible) {
-        if (!sprite.sprite_sheet_name.empty()) {
-          auto sheet =
-              util::AssetManager<SpriteSheet>::Get(sprite.sprite_sheet_name);
-          if (sheet && sheet->texture()) {
-            glm::vec2 uv_min, uv_max;
-            sheet->GetUVs(sprite.sprite_index, &uv_min, &uv_max);
-
-            utils::RenderCommand cmd;
-            cmd.z_order = sprite.z_index;
-            cmd.texture_id = sheet->texture()->renderer_id();
-            cmd.position = transform.position;
-            cmd.size = transform.scale;
-            cmd.rotation = transform.rotation;
-            cmd.color = sprite.tint;
-            cmd.uv_min = uv_min;
-            cmd.uv_max = uv_max;
-            cmd.origin = sprite.origin;
-            utils::RenderQueue::Default().Submit(cmd);
-          }
-        } else if (!sprite.texture_name.empty()) {
-          auto tex = util::AssetManager<Texture>::Get(sprite.texture_name);
-          if (tex) {
-            utils::RenderCommand cmd;
-            cmd.z_order = sprite.z_index;
-            cmd.texture_id = tex->renderer_id();
-            cmd.position = transform.position;
-            cmd.size = transform.scale;
-            cmd.rotation = transform.rotation;
-            cmd.color = sprite.tint;
-            cmd.uv_min = {0.0f, 0.0f};
-            cmd.uv_max = {1.0f, 1.0f};
-            cmd.origin = sprite.origin;
-            utils::RenderQueue::Default().Submit(cmd);
-          }
-        }
-      }
+    if (sprite_group.Contains(entity)) {
+      // Already submitted above.
     }
     // Quad Component (fallback)
     else if (registry->HasComponent<engine::ecs::components::Quad>(entity)) {
@@ -0,0 +1,96 @@
+/**
+ * @file scene_arena.cpp
+ * @brief SceneArena implementation.
+ */
+
+#include <engine/scene/scene_arena.h>
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+namespace {
+
+/** @brief Most arenas kept for reuse; a scene plus one overlay. */
+constexpr size_t kMaxRecycled = 2;
+
+/**
+ * @brief Largest block the pool recycles itself; bigger ones, such as large
+ * component arrays, come straight from the monotonic buffer.
+ */
+constexpr size_t kLargestPooledBlock = size_t{64} << 10;
+
+std::mutex& RecycledMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::vector<std::unique_ptr<SceneArena>>& Recycled() {
+  static std::vector<std::unique_ptr<SceneArena>> arenas;
+  return arenas;
+}
+
+}  // namespace
+
+void* SceneArena::OverflowResource::do_allocate(size_t bytes,
+                                                size_t alignment) {
+  allocated_ += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void SceneArena::OverflowResource::do_deallocate(void* p, size_t bytes,
+                                                 size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+void SceneArena::Recycler::operator()(SceneArena* arena) const {
+  arena->Reset();
+  std::lock_guard<std::mutex> lock(RecycledMutex());
+  if (Recycled().size() < kMaxRecycled) {
+    Recycled().emplace_back(arena);
+  } else {
+    delete arena;
+  }
+}
+
+SceneArena::Handle SceneArena::Acquire() {
+  {
+    std::lock_guard<std::mutex> lock(RecycledMutex());
+    if (!Recycled().empty()) {
+      SceneArena* arena = Recycled().back().release();
+      Recycled().pop_back();
+      return Handle(arena);
+    }
+  }
+  return Handle(new SceneArena());
+}
+
+SceneArena::SceneArena(size_t initial_bytes) { Build(initial_bytes); }
+
+SceneArena::~SceneArena() {
+  pool_.reset();
+  monotonic_.reset();
+}
+
+void SceneArena::Reset() {
+  const size_t used = buffer_size_ + overflow_.allocated();
+  pool_->release();
+  monotonic_->release();
+  if (used > buffer_size_) {
+    Build(used);
+  }
+  overflow_.reset();
+}
+
+void SceneArena::Build(size_t bytes) {
+  pool_.reset();
+  monotonic_.reset();
+  buffer_ = std::make_unique<std::byte[]>(bytes);
+  buffer_size_ = bytes;
+  monotonic_.emplace(buffer_.get(), buffer_size_, &overflow_);
+  pool_.emplace(std::pmr::pool_options{0, kLargestPooledBlock}, &*monotonic_);
+}
+
+}  // namespace engine
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <vector>
+
+#include <engine/scene/scene_arena.h>
+
+namespace engine {
+
+TEST(SceneArenaTest, ResetReleasesEverything) {
+  SceneArena arena;
+  {
+    std::pmr::vector<int> values(arena.resource());
+    values.resize(64);
+    EXPECT_EQ(arena.overflow_bytes(), 0u);
+  }
+  arena.Reset();
+  EXPECT_EQ(arena.buffer_size(), SceneArena::kInitialBytes);
+  EXPECT_EQ(arena.overflow_bytes(), 0u);
+}
+
+TEST(SceneArenaTest, GrowsToThePeakOfTheLastScene) {
+  SceneArena arena(1024);
+  {
+    std::pmr::vector<char> large(arena.resource());
+    large.resize(size_t{256} << 10);
+  }
+  EXPECT_GT(arena.overflow_bytes(), 0u);
+  arena.Reset();
+  EXPECT_GT(arena.buffer_size(), size_t{256} << 10);
+  EXPECT_EQ(arena.overflow_bytes(), 0u);
+
+  std::pmr::vector<char> again(arena.resource());
+  again.resize(size_t{256} << 10);
+  EXPECT_EQ(arena.overflow_bytes(), 0u);
+}
+
+TEST(SceneArenaTest, AcquireReusesRecycledArenas) {
+  SceneArena* first = nullptr;
+  {
+    SceneArena::Handle arena = SceneArena::Acquire();
+    first = arena.get();
+    std::pmr::vector<int> values(arena->resource());
+    values.resize(100);
+  }
+  SceneArena::Handle arena = SceneArena::Acquire();
+  EXPECT_EQ(arena.get(), first);
+  SceneArena::Handle other = SceneArena::Acquire();
+  EXPECT_NE(other.get(), first);
+}
+
+}  // namespace engine
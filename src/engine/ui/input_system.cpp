@@ -5,6 +5,8 @@
 
 #include <engine/ui/input_system.h>
 
+#include <vector>
+
 #include <engine/ecs/components/ui_interactable.h>
 #include <engine/ecs/components/ui_transform.h>
 #include <engine/input/input_manager.h>
@@ -18,8 +20,14 @@ void UiInputSystem::Update(ecs::Registry& reg) {
   glm::vec2 mouse_pos = input.mouse_screen_pos();
   bool mouse_pressed = input.IsKeyDown(KeyCode::kMouseLeft);
 
-  auto view = reg.GetView<UiTransform, UiInteractable>();
-  for (auto entity : view) {
+  // Callbacks may destroy or reparent widgets, so walk a copy of the matches
+  // and skip the ones that are gone by the time they come up.
+  std::vector<ecs::EntityID> widgets;
+  reg.GetQuery<UiTransform, UiInteractable>().Each(
+      [&widgets](ecs::EntityID entity, UiTransform&, UiInteractable&) {
+        widgets.push_back(entity);
+      });
+  for (auto entity : widgets) {
     if (!reg.IsAlive(entity) || !reg.HasComponent<UiTransform>(entity) ||
         !reg.HasComponent<UiInteractable>(entity))
       continue;
@@ -34,25 +42,28 @@ void UiInputSystem::Update(ecs::Registry& reg) {
         mouse_pos.y >= transform.global_pos.y &&
         mouse_pos.y <= transform.global_pos.y + transform.size.y;
 
-    if (interactable.is_hovered != was_hovered) {
-      if (interactable.on_hover_changed) {
-        interactable.on_hover_changed(interactable.is_hovered);
-      }
+    if (interactable.is_hovered != was_hovered &&
+        interactable.on_hover_changed) {
+      interactable.on_hover_changed(interactable.is_hovered);
+      // The callback may have removed the widget or moved its storage.
+      if (!reg.IsAlive(entity) || !reg.HasComponent<UiInteractable>(entity))
+        continue;
     }
+    auto& state = reg.GetComponent<UiInteractable>(entity);
 
-    if (interactable.is_hovered) {
+    if (state.is_hovered) {
       input.Consume();
 
-      if (mouse_pressed && !interactable.is_pressed) {
-        interactable.is_pressed = true;
-      } else if (!mouse_pressed && interactable.is_pressed) {
-        interactable.is_pressed = false;
-        if (interactable.on_click) {
-          interactable.on_click();
+      if (mouse_pressed && !state.is_pressed) {
+        state.is_pressed = true;
+      } else if (!mouse_pressed && state.is_pressed) {
+        state.is_pressed = false;
+        if (state.on_click) {
+          state.on_click();
         }
       }
     } else {
-      interactable.is_pressed = false;
+      state.is_pressed = false;
     }
   }
 }
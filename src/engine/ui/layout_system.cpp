@@ -5,7 +5,6 @@
 
 #include <engine/ui/layout_system.h>
 
-#include <algorithm>
 #include <vector>
 
 #include <engine/ecs/components/ui_hierarchy.h>
@@ -17,30 +16,76 @@ using namespace engine::ecs::components;
 
 void UiLayoutSystem::Update(ecs::Registry& reg, int window_width,
                             int window_height) {
-  auto roots = reg.GetView<UiTransform, UiHierarchy>().Filter(
-      [&](auto& t, auto& h) { return h.parent == ecs::kInvalidEntity; });
-
-  // If no roots with UIHierarchy, try entities with just UiTransform but no
-  // UIHierarchy
-  auto all_transforms = reg.GetView<UiTransform>();
-  std::vector<ecs::EntityID> all_roots = roots;
-  for (auto entity : all_transforms) {
-    bool has_hierarchy = reg.HasComponent<UiHierarchy>(entity);
-    if (!has_hierarchy ||
-        reg.GetComponent<UiHierarchy>(entity).parent == ecs::kInvalidEntity) {
-      // Check if already in all_roots
-      if (std::find(all_roots.begin(), all_roots.end(), entity) ==
-          all_roots.end()) {
-        all_roots.push_back(entity);
+  glm::vec2 screen_size(window_width, window_height);
+
+  // A node is laid out when its global position follows from its parent's
+  // (or, for roots, the window's) position and size. Checking that by value
+  // catches every edit, including writes through a plain reference from C++
+  // or Lua and window resizes; setting is_dirty forces a relayout.
+  std::vector<ecs::EntityID> dirty;
+  reg.GetView<UiTransform>().Each(
+      [&](ecs::EntityID entity, UiTransform& ui) {
+        if (!ui.is_dirty) {
+          auto parent = GetParent(reg, entity);
+          if (parent == ecs::kInvalidEntity) {
+            ui.is_dirty = ui.global_pos !=
+                          LayoutPosition(ui, glm::vec2(0.0f), screen_size);
+          } else if (reg.HasComponent<UiTransform>(parent)) {
+            const auto& parent_ui = reg.GetComponent<UiTransform>(parent);
+            ui.is_dirty =
+                ui.global_pos !=
+                LayoutPosition(ui, parent_ui.global_pos, parent_ui.size);
+          }
+        }
+        if (ui.is_dirty) {
+          dirty.push_back(entity);
+        }
+      });
+
+  // Lay out each dirty subtree once, starting from its topmost dirty node.
+  std::vector<ecs::EntityID> tops;
+  for (auto entity : dirty) {
+    bool covered = false;
+    for (auto parent = GetParent(reg, entity);
+         parent != ecs::kInvalidEntity && !covered;
+         parent = GetParent(reg, parent)) {
+      if (!reg.HasComponent<UiTransform>(parent)) {
+        // Nodes under a parent without a UiTransform are never laid out.
+        covered = true;
+      } else {
+        covered = reg.GetComponent<UiTransform>(parent).is_dirty;
       }
     }
+    if (!covered) {
+      tops.push_back(entity);
+    }
   }
 
-  glm::vec2 screen_size(window_width, window_height);
+  for (auto entity : tops) {
+    auto parent = GetParent(reg, entity);
+    if (parent == ecs::kInvalidEntity) {
+      UpdateBranch(reg, entity, glm::vec2(0.0f, 0.0f), screen_size);
+    } else {
+      const auto& parent_ui = reg.GetComponent<UiTransform>(parent);
+      UpdateBranch(reg, entity, parent_ui.global_pos, parent_ui.size);
+    }
+  }
+}
+
+glm::vec2 UiLayoutSystem::LayoutPosition(const UiTransform& ui,
+                                         const glm::vec2& parent_global_pos,
+                                         const glm::vec2& parent_size) {
+  // Global position is the anchor position plus the local offset.
+  glm::vec2 anchor_pos = parent_global_pos + ui.anchor_min * parent_size;
+  return anchor_pos + ui.local_pos;
+}
 
-  for (auto entity : all_roots) {
-    UpdateBranch(reg, entity, glm::vec2(0.0f, 0.0f), screen_size);
+ecs::EntityID UiLayoutSystem::GetParent(ecs::Registry& reg,
+                                        ecs::EntityID entity) {
+  if (!reg.HasComponent<UiHierarchy>(entity)) {
+    return ecs::kInvalidEntity;
   }
+  return reg.GetComponent<UiHierarchy>(entity).parent;
 }
 
 void UiLayoutSystem::UpdateBranch(ecs::Registry& reg, ecs::EntityID entity,
@@ -51,11 +96,7 @@ void UiLayoutSystem::UpdateBranch(ecs::Registry& reg, ecs::EntityID entity,
   }
   auto& ui = reg.GetComponent<UiTransform>(entity);
 
-  // Calculate anchor position
-  glm::vec2 anchor_pos = parent_global_pos + ui.anchor_min * parent_size;
-
-  // Global position is anchor + local offset
-  ui.global_pos = anchor_pos + ui.local_pos;
+  ui.global_pos = LayoutPosition(ui, parent_global_pos, parent_size);
 
   ui.is_dirty = false;
 
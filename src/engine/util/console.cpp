@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <sstream>
+#include <string>
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
@@ -12,7 +13,9 @@
 #include <engine/core/engine.h>
 #include <engine/graphics/renderer.h>
 #include <engine/input/input_manager.h>
+#include <engine/scene/scene_manager.h>
 #include <engine/util/console.h>
+#include <engine/util/logger.h>
 #include <engine/util/scripting/script_manager.h>
 
 namespace engine::util {
@@ -36,6 +39,20 @@ Console::Console() {
     paused_ = !paused_;
     Log(paused_ ? "Game paused" : "Game unpaused");
   });
+  RegisterCommand("ecs_stats", [this](const std::vector<std::string>&) {
+    auto* active_scene = SceneManager::Get().GetActiveScene();
+    if (!active_scene) {
+      Log("No active scene.");
+      return;
+    }
+    const std::string report = active_scene->registry().GetStats().ToString();
+    LOG_INFO("Registry stats of scene '%s':\n%s",
+             active_scene->name().c_str(), report.c_str());
+    std::istringstream lines(report);
+    for (std::string line; std::getline(lines, line);) {
+      Log(line);
+    }
+  });
   RegisterCommand("exit", [](const std::vector<std::string>&) {
     glfwSetWindowShouldClose(Engine::window().native_handle(), GLFW_TRUE);
   });
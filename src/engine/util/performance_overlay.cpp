@@ -5,6 +5,7 @@
 
 #include <engine/util/performance_overlay.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
@@ -22,6 +23,11 @@
 
 namespace engine::util {
 
+namespace {
+/** @brief Number of largest component storages listed in the overlay. */
+constexpr size_t kListedStorages = 4;
+}  // namespace
+
 PerformanceOverlay& PerformanceOverlay::Get() {
   static PerformanceOverlay instance;
   return instance;
@@ -36,6 +42,9 @@ void PerformanceOverlay::Update(double delta_time) {
     current_frame_time_ms_ = static_cast<float>((frame_time_accum_ / frame_count_) * 1000.0);
 
     UpdateSystemMetrics();
+    if (visible_) {
+      UpdateRegistryStats();
+    }
 
     frame_time_accum_ = 0.0;
     frame_count_ = 0;
@@ -90,6 +99,12 @@ void PerformanceOverlay::UpdateSystemMetrics() {
 #endif
 }
 
+void PerformanceOverlay::UpdateRegistryStats() {
+  auto* active_scene = SceneManager::Get().GetActiveScene();
+  registry_stats_ =
+      active_scene ? active_scene->registry().GetStats() : ecs::RegistryStats{};
+}
+
 void PerformanceOverlay::Render() {
   if (!visible_) return;
 
@@ -98,8 +113,10 @@ void PerformanceOverlay::Render() {
   float x = 10.0f;
   float y = static_cast<float>(Engine::window().height()) - 30.0f;
   float line_height = 20.0f;
-  float width = 220.0f;
-  float height = 110.0f;
+  const size_t listed =
+      std::min(registry_stats_.storages.size(), kListedStorages);
+  float width = 260.0f;
+  float height = 110.0f + line_height * static_cast<float>(listed + 1);
 
   // Background box
   renderer.DrawQuad({5.0f, y - height + 25.0f}, {width, height}, {0.1f, 0.1f, 0.1f, 0.7f});
@@ -141,6 +158,26 @@ void PerformanceOverlay::Render() {
   // Scene
   ss << "Scene: " << scene_name;
   renderer.DrawText("default", ss.str(), {x, y}, 0.0f, 0.7f, {1.0f, 1.0f, 1.0f, 1.0f});
+  y -= line_height;
+  ss.str("");
+
+  // Registry memory, from the last UpdateRegistryStats()
+  ss << "ECS: " << std::fixed << std::setprecision(1)
+     << registry_stats_.total_bytes() / 1024.0 << " KB, "
+     << registry_stats_.queued_events() << " events queued";
+  renderer.DrawText("default", ss.str(), {x, y}, 0.0f, 0.7f, {1.0f, 1.0f, 1.0f, 1.0f});
+  y -= line_height;
+  ss.str("");
+
+  for (size_t i = 0; i < listed; ++i) {
+    const ecs::StorageStats& storage = registry_stats_.storages[i];
+    ss << "  " << storage.name << ": " << storage.size << "/"
+       << storage.capacity << ", " << std::fixed << std::setprecision(1)
+       << storage.bytes / 1024.0 << " KB";
+    renderer.DrawText("default", ss.str(), {x, y}, 0.0f, 0.6f, {0.8f, 0.8f, 0.8f, 1.0f});
+    y -= line_height;
+    ss.str("");
+  }
 }
 
 }  // namespace engine::util
@@ -2,6 +2,7 @@
 #include <tools/leveleditor/component_registry.h>
 
 #include <cstring>
+#include <utility>
 
 #include <engine/ecs/components/light.h>
 #include <engine/ecs/components/occluder.h>
@@ -49,7 +50,7 @@ void ComponentRegistry::Init() {
          t.position = {j["position"][0], j["position"][1]};
          t.scale = {j["scale"][0], j["scale"][1]};
          t.rotation = j["rotation"];
-         reg.AddComponent(entity, t);
+         reg.AddComponent(entity, std::move(t));
        },
        [](engine::ecs::EntityID entity, engine::ecs::Registry& reg) {
          reg.AddComponent(entity, Transform{});
@@ -102,7 +103,7 @@ void ComponentRegistry::Init() {
          s.origin = {j["origin"][0], j["origin"][1]};
          s.z_index = j["z_index"];
          s.visible = j["visible"];
-         reg.AddComponent(entity, s);
+         reg.AddComponent(entity, std::move(s));
        },
        [](engine::ecs::EntityID entity, engine::ecs::Registry& reg) {
          reg.AddComponent(entity, Sprite{});
@@ -133,7 +134,7 @@ void ComponentRegistry::Init() {
          Quad q;
          q.color = {j["color"][0], j["color"][1], j["color"][2], j["color"][3]};
          q.z_index = j["z_index"];
-         reg.AddComponent(entity, q);
+         reg.AddComponent(entity, std::move(q));
        },
        [](engine::ecs::EntityID entity, engine::ecs::Registry& reg) {
          reg.AddComponent(entity, Quad{});
@@ -167,7 +168,7 @@ void ComponentRegistry::Init() {
          c.size = {j["size"][0], j["size"][1]};
          c.offset = {j["offset"][0], j["offset"][1]};
          c.is_trigger = j["is_trigger"];
-         reg.AddComponent(entity, c);
+         reg.AddComponent(entity, std::move(c));
        },
        [](engine::ecs::EntityID entity, engine::ecs::Registry& reg) {
          reg.AddComponent(entity, Collider{});
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iostream>
 #include <nlohmann/json.hpp>
+#include <vector>
 
 #include <engine/ecs/components/transform.h>
 #include <engine/util/console.h>
@@ -173,8 +174,14 @@ void LevelEditor::LoadLevel(const std::string& filename) {
   entity_selected_ = false;
 
   auto& comp_registry = ComponentRegistry::Get();
+  const std::vector<engine::ecs::EntityID> entities =
+      registry_.CreateEntities(root.size());
+  size_t row = 0;
   for (auto& entity_json : root) {
-    auto entity = registry_.CreateEntity();
+    if (row == entities.size()) {
+      break;
+    }
+    auto entity = entities[row++];
     for (auto it = entity_json.begin(); it != entity_json.end(); ++it) {
       std::string comp_name = it.key();
       if (comp_registry.GetComponents().count(comp_name)) {